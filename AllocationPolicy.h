@@ -0,0 +1,164 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+
+#include <new>
+#include <stdexcept>
+
+#include "ByteAllocator.h"
+#include "BlobStorage.h"
+#include "MappedStorage.h"
+
+namespace Alepha::inline Cavorite  ::detail::  allocation_policy
+{
+	inline namespace exports
+	{
+		enum class AllocationPolicy;
+
+		StorageAllocation allocateStorage( std::size_t amount, AllocationPolicy policy, ByteAllocator &allocator );
+		constexpr std::size_t allocationCapacity( std::size_t amount, AllocationPolicy policy ) noexcept;
+	}
+
+	namespace C
+	{
+		// Zeroed allocations at least this large come from anonymous pages, which the kernel zeroes lazily.
+		const std::size_t lazyZeroThreshold= 128 * 1024;
+
+		// Transparent huge pages are only worth asking for when the buffer covers at least one.
+		const std::size_t hugePageSize= 2 * 1024 * 1024;
+
+		// `O_DIRECT` wants buffers (and transfer sizes) aligned to the logical block size, which is at most a page.
+		const std::size_t directIOAlignment= 4096;
+	}
+
+	/*!
+	 * How the physical memory behind a newly allocated `Blob` object is obtained and initialized.
+	 *
+	 *  * `Zeroed`: The contents are all zero.  This is the classic `Blob` behaviour.  Buffers come from the
+	 *    allocator and are cleared.  The exception is large buffers for the default `NewArrayAllocator`, which would
+	 *    only get fresh pages from the kernel anyway: they are anonymous pages, which the kernel zeroes lazily on
+	 *    first touch.
+	 *
+	 *  * `Uninitialized`: The contents are unspecified.  Use this when the next thing to happen to the buffer is a
+	 *    copy or a `read` which overwrites it anyway.
+	 *
+	 *  * `HugePage`: Large buffers are anonymous mappings aligned to, and rounded up to, the 2 MiB huge page size,
+	 *    with transparent huge pages requested.  The contents are zero.  Buffers smaller than a huge page are
+	 *    treated as `Zeroed`.
+	 *
+	 *  * `DirectIO`: The buffer is aligned to 4 KiB, with its capacity rounded up to a multiple of 4 KiB, as
+	 *    `O_DIRECT` transfers require.  The contents are unspecified.
+	 *
+	 * The rounded capacities are usable: see `allocationCapacity`.
+	 *
+	 * @note Only `Zeroed` and `Uninitialized` allocations are taken from a `ByteAllocator`.  The other policies
+	 * need alignment that the allocators do not promise.
+	 */
+	enum class exports::AllocationPolicy { Zeroed, Uninitialized, HugePage, DirectIO };
+
+	/*!
+	 * Storage for an over-aligned buffer.  The counting header is a separate small object, so the payload can
+	 * start exactly on its alignment boundary.
+	 */
+	class AlignedStorage final
+		: public BlobStorage
+	{
+		private:
+			std::byte *const payload;
+			const std::size_t alignment;
+
+			void
+			dispose() noexcept override
+			{
+				::operator delete( payload, std::align_val_t{ alignment } );
+				delete this;
+			}
+
+		public:
+			explicit AlignedStorage( std::byte *const payload, const std::size_t alignment ) noexcept
+				: payload( payload ), alignment( alignment ) {}
+	};
+
+	inline StorageAllocation
+	allocateAligned( const std::size_t amount, const std::size_t alignment )
+	{
+		const std::size_t extent= ( amount + alignment - 1 ) / alignment * alignment;
+		std::byte *const payload= static_cast< std::byte * >( ::operator new( extent, std::align_val_t{ alignment } ) );
+		try
+		{
+			return { StorageReference{ new AlignedStorage( payload, alignment ) }, payload };
+		}
+		catch( ... )
+		{
+			::operator delete( payload, std::align_val_t{ alignment } );
+			throw;
+		}
+	}
+
+	inline StorageAllocation
+	allocateAnonymous( const std::size_t amount, const std::size_t alignment= 0, const bool hugePages= false )
+	{
+		auto region= mapAnonymousRegion( amount, alignment, hugePages );
+		return { std::move( region.storage ), region.data };
+	}
+
+	/*!
+	 * How many bytes an allocation of `amount` bytes following `policy` really provides.
+	 *
+	 * This is `amount`, rounded up to whole blocks for `DirectIO` and to whole huge pages for large `HugePage`
+	 * allocations.  All of it may be used.
+	 */
+	constexpr std::size_t
+	exports::allocationCapacity( const std::size_t amount, const AllocationPolicy policy ) noexcept
+	{
+		const auto roundUp= []( const std::size_t amount, const std::size_t unit ) { return ( amount + unit - 1 ) / unit * unit; };
+		if( policy == AllocationPolicy::DirectIO ) return roundUp( amount, C::directIOAlignment );
+		if( policy == AllocationPolicy::HugePage and amount >= C::hugePageSize ) return roundUp( amount, C::hugePageSize );
+		return amount;
+	}
+
+	/*!
+	 * Obtain counted storage for `amount` bytes, following `policy`.
+	 *
+	 * @param amount The number of bytes needed.
+	 * @param policy How to obtain and initialize them.
+	 * @param allocator The allocator for the policies which use one.
+	 */
+	inline StorageAllocation
+	exports::allocateStorage( const std::size_t amount, const AllocationPolicy policy, ByteAllocator &allocator )
+	{
+		switch( policy )
+		{
+			case AllocationPolicy::Uninitialized:
+				return allocateHeapStorage( amount, allocator );
+
+			case AllocationPolicy::HugePage:
+				if( amount >= C::hugePageSize ) return allocateAnonymous( allocationCapacity( amount, policy ), C::hugePageSize, true );
+				[[fallthrough]];
+
+			case AllocationPolicy::Zeroed:
+				// Any allocator but the classic `new[]` one is used as it was asked to be.  That one would get fresh
+				// pages from the kernel at this size anyway -- only to clear them again.
+				if( amount >= C::lazyZeroThreshold and &allocator == &NewArrayAllocator::instance() ) return allocateAnonymous( amount );
+				else
+				{
+					auto rv= allocateHeapStorage( amount, allocator );
+					std::memset( rv.data, 0, amount );
+					return rv;
+				}
+
+			case AllocationPolicy::DirectIO:
+				return allocateAligned( amount, C::directIOAlignment );
+		}
+		throw std::logic_error{ "Unknown `AllocationPolicy`." };
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline allocation_policy
+{
+	using namespace detail::allocation_policy::exports;
+}
@@ -0,0 +1,124 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../AllocationPolicy.h"
+#include "../Blob.h"
+
+#include <cstdint>
+
+#include <algorithm>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+#include <Alepha/Testing/CountingAllocator.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	bool
+	allZero( const Alepha::StorageAllocation &allocation, const std::size_t amount )
+	{
+		return std::all_of( allocation.data, allocation.data + amount, []( const std::byte b ) { return b == std::byte{}; } );
+	}
+
+	std::uintptr_t address( const std::byte *const p ) { return reinterpret_cast< std::uintptr_t >( p ); }
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+	using Alepha::AllocationPolicy;
+	using Alepha::CountingAllocator;
+
+	"small_zeroed_uses_the_allocator"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		{
+			auto allocation= Alepha::allocateStorage( 1000, AllocationPolicy::Zeroed, allocator );
+			test.expect( allocation.storage->allocator() == &allocator );
+			test.expect( allZero( allocation, 1000 ) );
+		}
+		test.expect( allocator.allocations == 1 );
+	};
+
+	"large_zeroed_keeps_the_allocator"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		const std::size_t amount= 1024 * 1024;
+		{
+			auto allocation= Alepha::allocateStorage( amount, AllocationPolicy::Zeroed, allocator );
+			test.expect( allocation.storage->allocator() == &allocator );
+			test.expect( allZero( allocation, amount ) );
+		}
+		test.expect( allocator.allocations == 1 );
+	};
+
+	"large_zeroed_default_is_anonymous"_test <=[]( TestState test )
+	{
+		const std::size_t amount= 1024 * 1024;
+		auto allocation= Alepha::allocateStorage( amount, AllocationPolicy::Zeroed, Alepha::NewArrayAllocator::instance() );
+		test.expect( allocation.storage->allocator() == nullptr );
+		test.expect( allZero( allocation, amount ) );
+		allocation.data[ amount - 1 ]= std::byte{ 1 };
+	};
+
+	"uninitialized_uses_the_allocator"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		const std::size_t amount= 1024 * 1024;
+		{
+			auto allocation= Alepha::allocateStorage( amount, AllocationPolicy::Uninitialized, allocator );
+			test.expect( allocation.storage->allocator() == &allocator );
+		}
+		test.expect( allocator.allocations == 1 );
+	};
+
+	"huge_page_alignment"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		const std::size_t hugePage= 2 * 1024 * 1024;
+
+		auto large= Alepha::allocateStorage( hugePage + 1, AllocationPolicy::HugePage, allocator );
+		test.expect( address( large.data ) % hugePage == 0 );
+		test.expect( allZero( large, hugePage + 1 ) );
+
+		auto small= Alepha::allocateStorage( 100, AllocationPolicy::HugePage, allocator );
+		test.expect( allZero( small, 100 ) );
+		test.expect( allocator.allocations == 1 );
+	};
+
+	"direct_io_alignment"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		for( const std::size_t amount: { 1, 4095, 4096, 12345 } )
+		{
+			auto allocation= Alepha::allocateStorage( amount, AllocationPolicy::DirectIO, allocator );
+			test.expect( address( allocation.data ) % 4096 == 0 );
+			test.expect( allocation.storage->useCount() == 1 );
+			// The capacity is rounded up to whole blocks.
+			allocation.data[ ( amount + 4095 ) / 4096 * 4096 - 1 ]= std::byte{ 1 };
+		}
+		test.expect( allocator.allocations == 0 );
+	};
+
+	"direct_io_blob_capacity"_test <=[]( TestState test )
+	{
+		for( const std::size_t amount: { 1, 4095, 4096, 12345 } )
+		{
+			Alepha::Blob blob{ amount, AllocationPolicy::DirectIO };
+			test.expect( blob.size() == amount );
+			test.expect( blob.capacity() == Alepha::allocationCapacity( amount, AllocationPolicy::DirectIO ) );
+			test.expect( blob.capacity() % 4096 == 0 );
+			test.expect( address( blob.byte_data() ) % 4096 == 0 );
+			blob.setSize( blob.capacity() );
+			test.expect( blob.size() % 4096 == 0 );
+		}
+		static_assert( Alepha::allocationCapacity( 100, AllocationPolicy::Zeroed ) == 100 );
+		static_assert( Alepha::allocationCapacity( 100, AllocationPolicy::HugePage ) == 100 );
+	};
+};
@@ -0,0 +1,567 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cerrno>
+
+#include <span>
+#include <deque>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <optional>
+#include <concepts>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <system_error>
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if __has_include( <linux/io_uring.h> )
+#include <linux/io_uring.h>
+#endif
+
+#include "ByteAllocator.h"
+#include "AllocationPolicy.h"
+#include "Thread.h"
+
+namespace Alepha::inline Cavorite  ::detail::  async_reader
+{
+	inline namespace exports
+	{
+		struct ReadRequest;
+		template< typename Storage > struct ReadCompletion;
+		struct AsyncReadOptions;
+
+		template< typename Storage > concept ReadableStorage= std::constructible_from< Storage, std::size_t, AllocationPolicy, ByteAllocator & >
+				and requires( Storage &s, const std::size_t n )
+		{
+			{ s.byte_data() } -> std::convertible_to< std::byte * >;
+			s.setSize( n );
+		};
+
+		template< ReadableStorage Storage > class AsyncReader;
+	}
+
+	namespace C
+	{
+		// How many reads may be outstanding at once, by default.
+		const unsigned queueDepth= 64;
+
+		// How many threads do `pread`s when io_uring cannot be used.
+		const std::size_t fallbackWorkers= 4;
+
+		// The most that one read moves (`MAX_RW_COUNT`).  Longer reads go to the ring in pieces of this size.
+		const std::size_t maximumKernelTransfer= 0x7fff'f000;
+	}
+
+	/*!
+	 * One read: `length` bytes of `fd`, starting at `offset`.
+	 *
+	 * The descriptor must stay open until the read completes.  `tag` is not interpreted; it is handed back with
+	 * the completion so that the caller can tell which read it was.
+	 */
+	struct exports::ReadRequest
+	{
+		int fd;
+		std::uint64_t offset= 0;
+		std::size_t length= 0;
+		std::uint64_t tag= 0;
+	};
+
+	/*!
+	 * The outcome of one `ReadRequest`.
+	 *
+	 * `data` is sized to the bytes actually read, which is fewer than were asked for only if the end of the
+	 * file came first.  If the read failed then `error` is the `errno` value, and `data` is empty.
+	 */
+	template< typename Storage >
+	struct exports::ReadCompletion
+	{
+		std::uint64_t tag;
+		int error;
+		Storage data;
+	};
+
+	struct exports::AsyncReadOptions
+	{
+		// The most reads in flight at once.  Submitting more waits for some to complete.
+		unsigned queueDepth= C::queueDepth;
+
+		// Threads for the `pread` fallback.
+		std::size_t fallbackWorkers= C::fallbackWorkers;
+
+		// How each result's storage is obtained -- use `DirectIO` with descriptors opened with `O_DIRECT`.
+		AllocationPolicy policy= AllocationPolicy::Uninitialized;
+
+		// Where each result's storage comes from.  `nullptr` is the default allocator.
+		ByteAllocator *allocator= nullptr;
+
+		// When false, the `pread` fallback is used even where io_uring is available.
+		bool useIoUring= true;
+	};
+
+#if __has_include( <linux/io_uring.h> ) && defined( __NR_io_uring_setup )
+	/*
+	 * A bare io_uring, driven by the raw system calls, for reads and no-ops only.
+	 *
+	 * Submission queue entries are written by one thread at a time (the owner serializes them), and completions
+	 * are reaped by one thread.
+	 */
+	class Ring
+	{
+		private:
+			int fd= -1;
+
+			void *sqRing= MAP_FAILED;
+			std::size_t sqRingSize= 0;
+			void *cqRing= MAP_FAILED;
+			std::size_t cqRingSize= 0;
+			io_uring_sqe *sqes= static_cast< io_uring_sqe * >( MAP_FAILED );
+			std::size_t sqesSize= 0;
+
+			unsigned *sqTail;
+			unsigned sqMask;
+			unsigned *sqArray;
+			unsigned *cqHead;
+			unsigned *cqTail;
+			unsigned cqMask;
+			io_uring_cqe *cqes;
+
+			unsigned pending= 0;
+
+			static unsigned *
+			field( void *const ring, const std::uint32_t offset ) noexcept
+			{
+				return reinterpret_cast< unsigned * >( static_cast< char * >( ring ) + offset );
+			}
+
+			Ring()= default;
+
+			io_uring_sqe &
+			prepare( const std::uint8_t opcode, const std::uint64_t userData )
+			{
+				const unsigned tail= *sqTail;
+				const unsigned index= tail & sqMask;
+				io_uring_sqe &sqe= sqes[ index ];
+				sqe= io_uring_sqe{};
+				sqe.opcode= opcode;
+				sqe.user_data= userData;
+				sqArray[ index ]= index;
+				std::atomic_ref< unsigned >( *sqTail ).store( tail + 1, std::memory_order_release );
+				++pending;
+				return sqe;
+			}
+
+			int
+			enter( const unsigned toSubmit, const unsigned minimumComplete, const unsigned flags ) noexcept
+			{
+				return ::syscall( __NR_io_uring_enter, fd, toSubmit, minimumComplete, flags, nullptr, 0 );
+			}
+
+		public:
+			~Ring()
+			{
+				if( sqes != MAP_FAILED ) ::munmap( sqes, sqesSize );
+				if( cqRing != MAP_FAILED and cqRing != sqRing ) ::munmap( cqRing, cqRingSize );
+				if( sqRing != MAP_FAILED ) ::munmap( sqRing, sqRingSize );
+				if( fd >= 0 ) ::close( fd );
+			}
+
+			/*!
+			 * A ring with room for at least `entries` submissions, or none if the kernel (or a sandbox) refuses one.
+			 */
+			static std::unique_ptr< Ring >
+			open( const unsigned entries )
+			{
+				std::unique_ptr< Ring > rv{ new Ring };
+				io_uring_params params{};
+				rv->fd= ::syscall( __NR_io_uring_setup, entries, &params );
+				if( rv->fd < 0 ) return nullptr;
+
+				rv->sqRingSize= params.sq_off.array + params.sq_entries * sizeof( unsigned );
+				rv->cqRingSize= params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+				const bool singleMap= params.features & IORING_FEAT_SINGLE_MMAP;
+				if( singleMap ) rv->sqRingSize= rv->cqRingSize= std::max( rv->sqRingSize, rv->cqRingSize );
+
+				rv->sqRing= ::mmap( nullptr, rv->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, rv->fd, IORING_OFF_SQ_RING );
+				if( rv->sqRing == MAP_FAILED ) return nullptr;
+				rv->cqRing= singleMap ? rv->sqRing
+						: ::mmap( nullptr, rv->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, rv->fd, IORING_OFF_CQ_RING );
+				if( rv->cqRing == MAP_FAILED ) return nullptr;
+				rv->sqesSize= params.sq_entries * sizeof( io_uring_sqe );
+				const auto sqes= ::mmap( nullptr, rv->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, rv->fd, IORING_OFF_SQES );
+				if( sqes == MAP_FAILED ) return nullptr;
+				rv->sqes= static_cast< io_uring_sqe * >( sqes );
+
+				rv->sqTail= field( rv->sqRing, params.sq_off.tail );
+				rv->sqMask= *field( rv->sqRing, params.sq_off.ring_mask );
+				rv->sqArray= field( rv->sqRing, params.sq_off.array );
+				rv->cqHead= field( rv->cqRing, params.cq_off.head );
+				rv->cqTail= field( rv->cqRing, params.cq_off.tail );
+				rv->cqMask= *field( rv->cqRing, params.cq_off.ring_mask );
+				rv->cqes= reinterpret_cast< io_uring_cqe * >( static_cast< char * >( rv->cqRing ) + params.cq_off.cqes );
+				return rv;
+			}
+
+			/*!
+			 * Queue a read of at most `length` bytes.
+			 *
+			 * @note An entry's length is only 32 bits, so no more than `C::maximumKernelTransfer` is asked for.  The
+			 * completion is then short, and the caller asks again for the rest.
+			 */
+			void
+			prepareRead( const int file, std::byte *const buffer, const std::size_t length, const std::uint64_t offset,
+					const std::uint64_t userData )
+			{
+				io_uring_sqe &sqe= prepare( IORING_OP_READ, userData );
+				sqe.fd= file;
+				sqe.addr= reinterpret_cast< std::uintptr_t >( buffer );
+				sqe.len= std::min( length, C::maximumKernelTransfer );
+				sqe.off= offset;
+			}
+
+			void prepareNop( const std::uint64_t userData ) { prepare( IORING_OP_NOP, userData ); }
+
+			// Takes back the last prepared entry, which a failed `submit` left unsubmitted.
+			void
+			withdraw() noexcept
+			{
+				std::atomic_ref< unsigned >( *sqTail ).store( *sqTail - 1, std::memory_order_release );
+				--pending;
+			}
+
+			// Hands every prepared entry to the kernel.
+			void
+			submit()
+			{
+				while( pending )
+				{
+					const int submitted= enter( pending, 0, 0 );
+					if( submitted < 0 and errno == EINTR ) continue;
+					if( submitted < 0 ) throw std::system_error{ errno, std::generic_category(), "io_uring_enter" };
+					pending-= submitted;
+				}
+			}
+
+			/*!
+			 * Wait for at least one completion, then call `handler( userData, result )` for each one there is.
+			 */
+			template< typename Handler >
+			void
+			reap( Handler handler )
+			{
+				unsigned head= *cqHead;
+				while( head == std::atomic_ref< unsigned >( *cqTail ).load( std::memory_order_acquire ) )
+				{
+					if( enter( 0, 1, IORING_ENTER_GETEVENTS ) < 0 and errno != EINTR )
+					{
+						throw std::system_error{ errno, std::generic_category(), "io_uring_enter" };
+					}
+				}
+
+				const unsigned tail= std::atomic_ref< unsigned >( *cqTail ).load( std::memory_order_acquire );
+				for( ; head != tail; ++head )
+				{
+					const io_uring_cqe &cqe= cqes[ head & cqMask ];
+					const auto userData= cqe.user_data;
+					const auto result= cqe.res;
+					std::atomic_ref< unsigned >( *cqHead ).store( head + 1, std::memory_order_release );
+					handler( userData, result );
+				}
+			}
+	};
+#else
+	class Ring
+	{
+		public:
+			static std::unique_ptr< Ring > open( unsigned ) { return nullptr; }
+			void prepareRead( int, std::byte *, std::size_t, std::uint64_t, std::uint64_t ) {}
+			void prepareNop( std::uint64_t ) {}
+			void withdraw() noexcept {}
+			void submit() {}
+			template< typename Handler > void reap( Handler ) {}
+	};
+#endif
+
+	/*!
+	 * Reads many files, or parts of files, at once.
+	 *
+	 * Each read gets freshly allocated `Storage` (normally a `Blob`), which is handed to the completion callback
+	 * once filled.  On Linux an io_uring is used when the kernel allows it: reads are queued up to `queueDepth`
+	 * deep and one thread reaps their completions.  Otherwise a few `Alepha::Thread` workers each do `pread`s.
+	 * Either way, the disks are kept busy with many requests instead of one at a time.
+	 *
+	 * The callback is called on the reader's own threads, and with the `pread` fallback several calls may run at
+	 * once.  It must not throw, and it must not call `submit` or `wait` on its own reader: it would wait on
+	 * completions which only its own return lets through.  To get completions as a queue instead, have the
+	 * callback push them into a `Mailbox`.
+	 */
+	template< ReadableStorage Storage >
+	class exports::AsyncReader
+	{
+		public:
+			using Callback= std::function< void ( ReadCompletion< Storage > ) >;
+
+		private:
+			// A read which has been submitted to the ring.
+			struct Pending
+			{
+				ReadRequest request;
+				Storage data;
+				std::size_t done= 0;
+			};
+
+			static constexpr std::uint64_t stopToken= ~std::uint64_t{};
+
+			Callback callback;
+			AllocationPolicy policy;
+			ByteAllocator &allocator;
+
+			Mutex access;
+			ConditionVariable slotFree;
+			ConditionVariable idle;
+			std::size_t outstanding= 0;
+			bool stopping= false;
+
+			std::unique_ptr< Ring > ring;
+			std::vector< std::optional< Pending > > slots;
+			std::vector< std::size_t > freeSlots;
+
+			ConditionVariable jobAvailable;
+			std::deque< ReadRequest > jobs;
+
+			std::vector< std::unique_ptr< Thread > > threads;
+
+			// The reader whose callbacks this thread runs, if any.
+			static inline thread_local constinit const AsyncReader *callbackReader= nullptr;
+
+			void
+			refuseFromCallback( const std::string &operation ) const
+			{
+				if( callbackReader != this ) return;
+				throw std::logic_error{ "`AsyncReader::" + operation + "` was called from that reader's own callback." };
+			}
+
+			Storage allocate( const std::size_t length ) { return Storage( length, policy, allocator ); }
+
+			void
+			prepare( const std::size_t slot )
+			{
+				Pending &pending= *slots[ slot ];
+				ring->prepareRead( pending.request.fd, pending.data.byte_data() + pending.done, pending.request.length - pending.done,
+						pending.request.offset + pending.done, slot );
+			}
+
+			void
+			finish()
+			{
+				lock_guard lock( access );
+				if( --outstanding == 0 ) idle.notify_all();
+			}
+
+			void
+			reaper()
+			{
+				callbackReader= this;
+				bool running= true;
+				while( running ) ring->reap( [&]( const std::uint64_t slot, const int result )
+				{
+					if( slot == stopToken )
+					{
+						running= false;
+						return;
+					}
+
+					std::optional< ReadCompletion< Storage > > completion;
+					{
+						lock_guard lock( access );
+						Pending &pending= *slots[ slot ];
+						if( result > 0 ) pending.done+= result;
+						int error= result < 0 ? -result : 0;
+
+						// A short read, or one piece of a long one, which is not at the end of the file -- ask again for the rest.
+						if( result > 0 and pending.done < pending.request.length )
+						{
+							prepare( slot );
+							try
+							{
+								ring->submit();
+								return;
+							}
+							catch( const std::system_error &failure )
+							{
+								// The read ends with the error instead.  Its entry must not reach the kernel later on,
+								// once the slot has been reused.
+								ring->withdraw();
+								error= failure.code().value();
+							}
+						}
+
+						pending.data.setSize( error ? 0 : pending.done );
+						completion.emplace( pending.request.tag, error, std::move( pending.data ) );
+						slots[ slot ].reset();
+						freeSlots.push_back( slot );
+					}
+					slotFree.notify_one();
+					callback( std::move( *completion ) );
+					finish();
+				} );
+			}
+
+			void
+			worker()
+			{
+				callbackReader= this;
+				while( true )
+				{
+					ReadRequest request;
+					{
+						unique_lock lock( access );
+						jobAvailable.wait( lock, [&]{ return stopping or not jobs.empty(); } );
+						if( jobs.empty() ) return;
+						request= jobs.front();
+						jobs.pop_front();
+					}
+
+					Storage data= allocate( request.length );
+					std::size_t done= 0;
+					int error= 0;
+					while( done < request.length )
+					{
+						const ssize_t amount= ::pread( request.fd, data.byte_data() + done, request.length - done, request.offset + done );
+						if( amount < 0 and errno == EINTR ) continue;
+						if( amount < 0 ) error= errno;
+						if( amount <= 0 ) break;
+						done+= amount;
+					}
+					data.setSize( error ? 0 : done );
+					callback( ReadCompletion< Storage >{ request.tag, error, std::move( data ) } );
+					finish();
+				}
+			}
+
+		public:
+			explicit
+			AsyncReader( Callback callback, const AsyncReadOptions &options= {} )
+				: callback( std::move( callback ) ), policy( options.policy ),
+					allocator( options.allocator ? *options.allocator : getDefaultAllocator() )
+			{
+				const unsigned depth= std::max( options.queueDepth, 1u );
+				if( options.useIoUring ) ring= Ring::open( depth );
+
+				if( ring )
+				{
+					slots.resize( depth );
+					for( std::size_t slot= depth; slot--; ) freeSlots.push_back( slot );
+					threads.push_back( std::make_unique< Thread >( [this]{ reaper(); } ) );
+				}
+				else
+				{
+					for( std::size_t i= 0; i < std::max< std::size_t >( options.fallbackWorkers, 1 ); ++i )
+					{
+						threads.push_back( std::make_unique< Thread >( [this]{ worker(); } ) );
+					}
+				}
+			}
+
+			AsyncReader( const AsyncReader & )= delete;
+			AsyncReader &operator= ( const AsyncReader & )= delete;
+
+			/*!
+			 * Waits for every submitted read to complete, then stops the reader's threads.
+			 */
+			~AsyncReader()
+			{
+				wait();
+				{
+					lock_guard lock( access );
+					stopping= true;
+					if( ring )
+					{
+						ring->prepareNop( stopToken );
+						ring->submit();
+					}
+				}
+				jobAvailable.notify_all();
+				for( auto &thread: threads ) thread->join();
+			}
+
+			/*!
+			 * Whether reads go through io_uring, rather than the `pread` fallback.
+			 */
+			bool usingIoUring() const noexcept { return bool( ring ); }
+
+			/*!
+			 * Start all of `requests`.
+			 *
+			 * This only waits if more than `queueDepth` reads would be in flight on the io_uring path.
+			 *
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 * @throw std::logic_error When called from this reader's callback.
+			 */
+			void
+			submit( const std::span< const ReadRequest > requests )
+			{
+				refuseFromCallback( "submit" );
+				if( not ring )
+				{
+					{
+						lock_guard lock( access );
+						jobs.insert( jobs.end(), requests.begin(), requests.end() );
+						outstanding+= requests.size();
+					}
+					jobAvailable.notify_all();
+					return;
+				}
+
+				for( const ReadRequest &request: requests )
+				{
+					Storage data= allocate( request.length );
+
+					unique_lock lock( access );
+					if( freeSlots.empty() )
+					{
+						// Everything queued so far must be in the kernel's hands before waiting on it to complete.
+						ring->submit();
+						slotFree.wait( lock, [&]{ return not freeSlots.empty(); } );
+					}
+					const std::size_t slot= freeSlots.back();
+					freeSlots.pop_back();
+					slots[ slot ].emplace( request, std::move( data ) );
+					++outstanding;
+					prepare( slot );
+				}
+
+				lock_guard lock( access );
+				ring->submit();
+			}
+
+			void submit( const ReadRequest &request ) { submit( std::span{ &request, 1 } ); }
+
+			/*!
+			 * Wait until every read submitted so far has completed and had its callback run.
+			 *
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 * @throw std::logic_error When called from this reader's callback.
+			 */
+			void
+			wait()
+			{
+				refuseFromCallback( "wait" );
+				unique_lock lock( access );
+				idle.wait( lock, [&]{ return outstanding == 0; } );
+			}
+	};
+}
+
+namespace Alepha::Cavorite::inline exports::inline async_reader
+{
+	using namespace detail::async_reader::exports;
+}
@@ -0,0 +1,182 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../AsyncReader.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include <fcntl.h>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	// A stand-in for `Blob`, allocating from the given allocator.
+	struct Storage
+	{
+		Alepha::ByteAllocator *allocator= nullptr;
+		std::byte *block= nullptr;
+		std::size_t capacity= 0;
+		std::size_t length= 0;
+
+		Storage( const std::size_t size, Alepha::AllocationPolicy, Alepha::ByteAllocator &allocator )
+			: allocator( &allocator ), block( allocator.allocate( size ) ), capacity( size ), length( size )
+		{}
+
+		Storage( Storage &&other ) noexcept
+			: allocator( other.allocator ), block( std::exchange( other.block, nullptr ) ), capacity( other.capacity ), length( other.length )
+		{}
+
+		~Storage() { if( block ) allocator->deallocate( block, capacity ); }
+
+		std::byte *byte_data() { return block; }
+		void setSize( const std::size_t size ) { length= size; }
+
+		std::string text() const { return { reinterpret_cast< const char * >( block ), length }; }
+	};
+
+	// A temporary file, removed again on destruction.
+	struct TemporaryFile
+	{
+		std::string contents;
+		int fd;
+
+		explicit
+		TemporaryFile( std::string text )
+			: contents( std::move( text ) )
+		{
+			char name[]= "/tmp/AsyncReader.test.XXXXXX";
+			fd= ::mkstemp( name );
+			::unlink( name );
+			if( ::write( fd, contents.data(), contents.size() ) != ssize_t( contents.size() ) ) std::abort();
+		}
+
+		~TemporaryFile() { ::close( fd ); }
+	};
+
+	using Reader= Alepha::AsyncReader< Storage >;
+
+	// Reads a piece of every file many times over, and checks every completion against the file contents.
+	bool
+	readMany( const bool useIoUring )
+	{
+		std::vector< std::unique_ptr< TemporaryFile > > files;
+		for( int i= 0; i < 8; ++i ) files.push_back( std::make_unique< TemporaryFile >( std::string( 1000 + i * 37, char( 'a' + i ) ) + std::to_string( i ) ) );
+
+		std::vector< Alepha::ReadRequest > requests;
+		for( std::uint64_t tag= 0; tag < 400; ++tag )
+		{
+			const auto &file= *files[ tag % files.size() ];
+			requests.push_back( { file.fd, tag % 50, 200 + tag % 300, tag } );
+		}
+
+		std::mutex access;
+		std::map< std::uint64_t, std::string > results;
+		int errors= 0;
+		{
+			Alepha::AsyncReadOptions options;
+			options.queueDepth= 16;
+			options.useIoUring= useIoUring;
+			Reader reader{ [&]( Alepha::ReadCompletion< Storage > completion )
+			{
+				std::lock_guard lock( access );
+				errors+= completion.error != 0;
+				results[ completion.tag ]= completion.data.text();
+			}, options };
+			if( useIoUring and not reader.usingIoUring() ) std::cerr << "io_uring is unavailable; testing the fallback again." << std::endl;
+
+			reader.submit( requests );
+			reader.wait();
+		}
+
+		bool rv= errors == 0 and results.size() == requests.size();
+		for( const auto &request: requests )
+		{
+			rv= rv and results[ request.tag ] == files[ request.tag % files.size() ]->contents.substr( request.offset, request.length );
+		}
+		return rv;
+	}
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"io_uring_reads"_test <=[]( TestState test ) { test.expect( readMany( true ) ); };
+
+	"fallback_reads"_test <=[]( TestState test ) { test.expect( readMany( false ) ); };
+
+	"end_of_file_and_errors"_test <=[]( TestState test )
+	{
+		for( const bool useIoUring: { true, false } )
+		{
+			TemporaryFile file{ "short file" };
+
+			std::mutex access;
+			std::map< std::uint64_t, std::pair< int, std::string > > results;
+			{
+				Alepha::AsyncReadOptions options;
+				options.useIoUring= useIoUring;
+				Reader reader{ [&]( Alepha::ReadCompletion< Storage > completion )
+				{
+					std::lock_guard lock( access );
+					results[ completion.tag ]= { completion.error, completion.data.text() };
+				}, options };
+
+				reader.submit( { file.fd, 6, 4096, 1 } );
+				reader.submit( { file.fd, 100, 10, 2 } );
+				reader.submit( { -1, 0, 10, 3 } );
+				reader.submit( { file.fd, 0, 0, 4 } );
+			}
+
+			test.expect( results[ 1 ] == std::pair{ 0, std::string{ "file" } } );
+			test.expect( results[ 2 ] == std::pair{ 0, std::string{} } );
+			test.expect( results[ 3 ] == std::pair{ EBADF, std::string{} } );
+			test.expect( results[ 4 ] == std::pair{ 0, std::string{} } );
+		}
+	};
+
+	"callbacks_may_not_resubmit"_test <=[]( TestState test )
+	{
+		for( const bool useIoUring: { true, false } )
+		{
+			TemporaryFile file{ "contents" };
+
+			std::mutex access;
+			int refused= 0;
+			{
+				Alepha::AsyncReadOptions options;
+				options.useIoUring= useIoUring;
+				Reader *self= nullptr;
+				Reader reader{ [&]( Alepha::ReadCompletion< Storage > completion )
+				{
+					for( const auto &call: { +[]( Reader &reader ) { reader.wait(); },
+							+[]( Reader &reader ) { reader.submit( { -1, 0, 1, 0 } ); } } )
+					{
+						try { call( *self ); }
+						catch( const std::logic_error & )
+						{
+							std::lock_guard lock( access );
+							++refused;
+						}
+					}
+				}, options };
+				self= &reader;
+
+				reader.submit( { file.fd, 0, 8, 1 } );
+				reader.wait();
+			}
+			test.expect( refused == 2 );
+		}
+	};
+};
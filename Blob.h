@@ -2,14 +2,16 @@ static_assert( __cplusplus > 2020'00 );
 
 #pragma once
 
-#include <memory>
-
 #include "Buffer.h"
-#include "swappable.h"
+#include "ByteAllocator.h"
+#include "BlobStorage.h"
+#include "SmallStorage.h"
+#include "AllocationPolicy.h"
+#include "MappedStorage.h"
+#include "Transfer.h"
 #include "stringify.h"
-#include "Exceptions.h"
+#include "Exception.h"
 #include "evaluation_helpers.h"
-#include "threading.h"
 #include "error.h"
 
 namespace Alepha::inline Cavorite  ::detail::  blob
@@ -29,7 +31,6 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 		const bool debugAssignment= false or C::debugLifecycle or C::debug;
 		const bool debugSwap= false or C::debugLifecycle or C::debug;
 
-		const bool debugSplitSharing= false or C::debug;
 		const bool debugInteriorCarve= false or C::debug;
 	}
 
@@ -42,7 +43,7 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 			explicit
 			DataCarveTooLargeError( const void *const location, const std::size_t request, const std::size_t available )
 				: std::out_of_range( "Tried to carve " + stringify( request ) + " bytes from `Blob` object at location "
-						+ stringify( location ) + " which only has " + stringify( avail ) + " bytes allocated." ),
+						+ stringify( location ) + " which only has " + stringify( available ) + " bytes allocated." ),
 				OutOfRangeError( location, request, available )
 			{}
 	};
@@ -53,44 +54,51 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 	{
 		public:
 			explicit
-			DataCarveOutOfRanceError( const void *const location, const std::size_t request, const std::size_t available )
+			DataCarveOutOfRangeError( const void *const location, const std::size_t request, const std::size_t available )
 				: std::out_of_range( "Tried to carve " + stringify( request ) + " bytes from `Blob` object at location "
-						+ stringify( location ) + " which only has " + stringify( avail ) + " bytes allocated." ),
+						+ stringify( location ) + " which only has " + stringify( available ) + " bytes allocated." ),
 				OutOfRangeError( location, request, available )
 			{}
 	};
 
 	class exports::Blob
-		: public BufferModel< Blob >, public swappable
+		: public BufferModel< Blob >
 	{
 		private:
-			using IndirectStorage= std::shared_ptr< std::shared_ptr< Blob > >;
-			IndirectStorage storage; // If this is empty, then this `Blob` object doesn't share ownership.  This references the shared pool.
-			Buffer buffer;
+			SmallStorage storage; // Small `Blob` objects hold their bytes inline; others hold one counted reference on the physical memory they view.
+			Buffer< Mutable > buffer;
 			std::size_t viewLimit= 0; // TODO: Consider allowing for unrooted sub-buffer views?
 
-			// TODO: Take the `storage` parameter and make it not increment when this ctor is called -- only when the dice roll passes.
 			explicit
-			Blob( IndirectStorage storage, Buffer buffer ) noexcept
-				: storage( evaluate <=[storage= std::move( storage )] () -> IndirectBacking
-				{
-					if( fastRandomBits( C::storageSplitRandomBitDepth ) ) return std::move( storage );
-					if( C::debugSplitSharing ) error() << "Observed a use count of " << storage.use_count() << " when we failed the dice roll." << std::endl;
-					auto split= std::make_shared< std::shared_ptr< Blob > >( *storage );
-					if( C::
-				}),
-				buffer( buffer )
+			Blob( StorageReference storage, const Buffer< Mutable > buffer ) noexcept
+				: storage( std::move( storage ) ),
+				buffer( buffer ),
 				viewLimit( buffer.size() )
 			{}
 
+			ByteAllocator &
+			currentAllocator() const noexcept
+			{
+				if( storage.allocator() ) return *storage.allocator();
+				return getDefaultAllocator();
+			}
+
 		public:
-			~Buffer() { reset(); }
+			~Blob() { reset(); }
 
-			auto
-			swap_lens() noexcept
+			friend void
+			swap( Blob &lhs, Blob &rhs ) noexcept
 			{
-				if( C::debugSwap ) error() << "Swap lens called." << std::endl;
-				return swap_magma( storage, buffer, viewLimit );
+				if( C::debugSwap ) error() << "Swap called." << std::endl;
+
+				using std::swap;
+				swap( lhs.storage, rhs.storage );
+				swap( lhs.buffer, rhs.buffer );
+				swap( lhs.viewLimit, rhs.viewLimit );
+
+				// Inline bytes always start the view, and they have just changed address.
+				if( lhs.storage.isInline() ) lhs.buffer= Buffer< Mutable >{ lhs.storage.inlineData(), lhs.buffer.size() };
+				if( rhs.storage.isInline() ) rhs.buffer= Buffer< Mutable >{ rhs.storage.inlineData(), rhs.buffer.size() };
 			}
 
 			/*!
@@ -106,8 +114,7 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 			void
 			reset() noexcept
 			{
-				if( not storage ) delete buffer;
-				else storage.reset();
+				storage.reset();
 
 				buffer= {};
 				viewLimit= 0;
@@ -122,21 +129,37 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 			 * @param size The size of the new arena to allocate.
 			 * @param newAlloc The allocator to use for the replacement arena (and for future allocations as well).
 			 *
-			 * @note: No data are copied.
+			 * @note: No data are copied, and the contents of the new arena are unspecified.
 			 */
 			void
-			reset( const std::size_t )
+			reset( const std::size_t size, ByteAllocator &newAlloc )
 			{
-				Blob tmp{ size };
+				Blob tmp{ size, AllocationPolicy::Uninitialized, newAlloc };
 				swap( tmp, *this );
 			}
 
-			// Copy deep copies the data.
+			/*!
+			 * Allocate a new arena of specified size and release the old arena.
+			 *
+			 * The replacement arena comes from the same allocator as the current one, or from the process default
+			 * allocator if this `Blob` object has never allocated.
+			 *
+			 * @param size The size of the new arena to allocate.
+			 *
+			 * @note: No data are copied, and the contents of the new arena are unspecified.
+			 */
+			void
+			reset( const std::size_t size )
+			{
+				reset( size, currentAllocator() );
+			}
+
+			// Copy deep copies the data.  (See `SharedBlob` for copies which share until written.)
 			Blob( const Blob &copy )
-				: buffer( new std::byte[ copy.buffer.size() ] ),
-				viewLimit( copy.viewLimit )
+				: Blob( copy.buffer.size(), AllocationPolicy::Uninitialized, copy.currentAllocator() )
 			{
 				if( C::debugCtors ) error() << "Blob copy invoked." << std::endl;
+				viewLimit= copy.viewLimit;
 				copyData( *this, copy );
 			}
 
@@ -145,7 +168,7 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 			template< typename ByteIterator >
 			explicit
 			Blob( ByteIterator first, ByteIterator last )
-				: Blob( std::distance( first, last ) )
+				: Blob( std::distance( first, last ), AllocationPolicy::Uninitialized )
 			{
 				std::copy( first, last, byte_data() );
 			}
@@ -176,21 +199,150 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 				viewLimit= size;
 			}
 
+			/*!
+			 * Allocate a new `Blob` object of the specified size, following an allocation policy.
+			 *
+			 * @param amount The number of bytes to allocate.
+			 * @param policy How the storage is obtained and initialized -- see `AllocationPolicy`.
+			 * @param allocator The allocator which provides the storage, for those policies which use one.  When
+			 * omitted, the process-wide default (see `setDefaultAllocator`) is used.  Any `Blob` objects carved
+			 * from this one share this storage, and it is released when the last of them is destroyed.
+			 *
+			 * @note Small zeroed or uninitialized allocations (see `SmallStorage`) are held inside the `Blob` object.
+			 *
+			 * @note The size is `amount`, but the `capacity` is what the policy really allocated (see
+			 * `allocationCapacity`), such as whole blocks for `AllocationPolicy::DirectIO`.  `setSize` can grow
+			 * into it.
+			 */
+			explicit
+			Blob( const std::size_t amount, const AllocationPolicy policy, ByteAllocator &allocator= getDefaultAllocator() )
+			{
+				buffer= { storage.allocate( amount, policy, allocator ), allocationCapacity( amount, policy ) };
+				viewLimit= amount;
+			}
+
+			/*!
+			 * Allocate a new `Blob` object of the specified size.
+			 *
+			 * The data are 0'ed upon allocation.
+			 *
+			 * @param amount The number of bytes to allocate.
+			 * @param allocator The allocator which provides the storage.  When omitted, the process-wide default
+			 * is used.
+			 */
 			explicit
-			Blob( const std::size_t amount )
-				: buffer( new std::byte[ amount ]{} ), // The data must be 0'ed upon allocation.
-				viewLimit( amount )
+			Blob( const std::size_t amount, ByteAllocator &allocator= getDefaultAllocator() )
+				: Blob( amount, AllocationPolicy::Zeroed, allocator )
 			{}
 
 			explicit
 			Blob( const Buffer< Const > b )
-				: Buffer( b.size() )
+				: Blob( b.size(), AllocationPolicy::Uninitialized )
 			{
 				copyData( buffer, b );
 			}
 
 			Blob() noexcept= default;
 
+			/*!
+			 * Create a `Blob` object which views a region of a file, mapped directly into memory.
+			 *
+			 * No data are read or copied up front -- pages are faulted in as they are touched.  Carving the result
+			 * hands out slices which share the mapping, and the region is unmapped when the last of them is
+			 * destroyed.
+			 *
+			 * @param path The file to map.
+			 * @param offset The byte offset of the region in the file.  It need not be page aligned.
+			 * @param length The number of bytes to map, or `wholeFile` for the rest of the file.
+			 * @param mode How the pages are mapped: `MapMode::Private` or `MapMode::Shared`.
+			 * @param advice An initial access pattern hint for the region.
+			 * @param keepFileSource Keep a descriptor for a `MapMode::Shared` file, so that `transferTo` can send the
+			 * data from it.
+			 *
+			 * @throw std::invalid_argument for `MapMode::ReadOnly`, whose pages cannot be written.  Use
+			 * `mapFileReadOnly` for those.
+			 *
+			 * @see `mapFileRegion`
+			 */
+			static Blob
+			mapFile( const std::filesystem::path &path, const std::size_t offset= 0, const std::size_t length= wholeFile,
+					const MapMode mode= MapMode::Private, const AccessAdvice advice= AccessAdvice::Normal,
+					const bool keepFileSource= false )
+			{
+				if( mode == MapMode::ReadOnly ) throw std::invalid_argument{ "A `Blob` cannot view a read only mapping writably." };
+				return adopt( mapFileRegion( path, offset, length, mode, advice, keepFileSource ) );
+			}
+
+			/*!
+			 * Create a `const Blob` object which views a region of a file, mapped `MapMode::ReadOnly`.
+			 *
+			 * The pages cannot be written, so the result is `const`, and only gives out `Buffer< Const >` views.  In
+			 * return, the mapping always matches the file, so with `keepFileSource`, `transferTo` sends it from the
+			 * file.
+			 *
+			 * @see `mapFile`
+			 */
+			static const Blob
+			mapFileReadOnly( const std::filesystem::path &path, const std::size_t offset= 0, const std::size_t length= wholeFile,
+					const AccessAdvice advice= AccessAdvice::Normal, const bool keepFileSource= false )
+			{
+				return adopt( mapFileRegion( path, offset, length, MapMode::ReadOnly, advice, keepFileSource ) );
+			}
+
+			/*!
+			 * Create a `Blob` object which views a region of counted storage, sharing it.
+			 *
+			 * This is how the regions made by `mapAnonymousRegion`, or the slices carved from a `RingBuffer`, become
+			 * `Blob` objects.  No data are copied.
+			 */
+			static Blob
+			adopt( MappedRegion region ) noexcept
+			{
+				if( not region.storage ) return Blob{};
+				return Blob{ std::move( region.storage ), Buffer< Mutable >{ region.data, region.length } };
+			}
+
+			/*!
+			 * Pass an access pattern hint for the memory viewed by this `Blob` object to the kernel.
+			 *
+			 * This is mostly useful on file mapped `Blob` objects: `AccessAdvice::Sequential` for a single streaming
+			 * pass, or `AccessAdvice::WillNeed` to start readahead for a slice that is about to be parsed.  Only the
+			 * whole pages inside this `Blob` object are advised -- see `adviseAccess`.
+			 *
+			 * `AccessAdvice::DontNeed` discards the pages' contents, so it is only passed on for a private mapping of
+			 * which this `Blob` object holds the only reference.  Afterwards, the bytes read as the file's (or as
+			 * zeros, for anonymous memory).
+			 *
+			 * @return Whether the advice was passed on.
+			 */
+			bool
+			advise( const AccessAdvice advice ) const noexcept
+			{
+				if( advice == AccessAdvice::DontNeed )
+				{
+					const StorageReference &reference= storage.reference();
+					if( not reference or not reference->privateMapping() or reference->useCount() != 1 ) return false;
+				}
+				adviseAccess( byte_data(), size(), advice );
+				return true;
+			}
+
+			// The counted storage this `Blob` object views, which is empty for small inline `Blob` objects.
+			const StorageReference &storageReference() const noexcept { return storage.reference(); }
+
+			/*!
+			 * Write this `Blob` object's bytes to a file descriptor, by the cheapest path the kernel offers.
+			 *
+			 * A file mapped `Blob` is sent from its file, without passing through user space.
+			 *
+			 * @see `transfer::transferTo`
+			 */
+			TransferResult
+			transferTo( const int fd, const TransferOptions &options= {} ) const
+			{
+				return transfer::transferTo( fd, *this, options );
+			}
+
 			// Buffer Model adaptors:
 			constexpr operator Buffer< Mutable > () noexcept { return { buffer, viewLimit }; }
 			constexpr operator Buffer< Const > () const noexcept { return { buffer, viewLimit }; }
@@ -209,26 +361,36 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 			 * Carving is very useful to maintain a large number of `Blob` objects referring to small chunks of data
 			 * inside a large single physical backing.  This helps maintain zero-copy semantics.
 			 *
+			 * @note Carving never allocates.  Small inline `Blob` objects (see `SmallStorage`) cannot share their
+			 * bytes, so the carved piece, which is smaller still, is copied into the returned `Blob` object.
+			 *
 			 * @param amount The amount of data to carve off.
-			 * @return A new `Blob` object referring to the same physical data, scoped to `amount` bytes.
+			 * @return A new `Blob` object referring to the same physical data, scoped to `amount` bytes -- or, when
+			 * this `Blob` object is small and inline, a copy of those bytes, which does not alias this one.
 			 */
 			Blob
 			carveHead( const std::size_t amount )
 			{
 				if( amount > size() ) throw DataCarveTooLargeError( data(), amount, size() );
-				if( not storage )
+
+				if( storage.isInline() )
 				{
-					// If there's no two-layer scheme, we have to start the sharing...
-					storage= std::make_shared< std::shared_ptr< Blob > >( std::make_shared< Blob >( std::move( *this ) ) );
+					Blob rv{ amount, AllocationPolicy::Uninitialized, currentAllocator() };
+					copyData( rv, Buffer< Const >{ buffer, amount } );
 
-					// Now that it's shared, we repoint ourselves at the invisible `Blob` above.
-					buffer= (*storage)->buffer;
-					viewLimit= (*storage)->viewLimit;
-				}
+					// Inline bytes always start the view, so the rest of them move down.
+					std::memmove( buffer.byte_data(), buffer.byte_data() + amount, buffer.size() - amount );
+					buffer= Buffer< Mutable >{ buffer.byte_data(), buffer.size() - amount };
+					viewLimit-= amount;
 
-				// Now we assume that there's a two-layer scheme, so we operate based upon that.
+					if( size() == 0 ) *this= Blob{};
 
-				Blob rv{ storage, Buffer< Mutable >{ buffer, amount } }
+					return rv;
+				}
+
+				// Every allocated `Blob` already counts its reference on the storage, so sharing it is
+				// just one more reference.
+				Blob rv{ storage.reference(), Buffer< Mutable >{ buffer, amount } };
 				buffer= buffer + amount;
 				viewLimit-= amount;
 
@@ -240,10 +402,11 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 			/*!
 			 * Carve the tail off of a `Blob` object.
 			 *
-			 * @see `Blob::carveTail`
+			 * @see `Blob::carveHead`
 			 *
 			 * @param amount The amount of data to carve off.
-			 * @return A new `Blob` object referring to the same physical data, scoped to `amount` bytes.
+			 * @return A new `Blob` object referring to the same physical data, scoped to `amount` bytes -- or, when
+			 * this `Blob` object is small and inline, a copy of those bytes, which does not alias this one.
 			 */
 			Blob
 			carveTail( const std::size_t amount )
@@ -260,16 +423,16 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 			template< typename T > void operator []( T ) const= delete;
 			template< typename T > void operator []( T )= delete;
 
-			constexpr std::size_t capacity() const noecept { return buffer.size(); }
+			constexpr std::size_t capacity() const noexcept { return buffer.size(); }
 
 			bool
 			isContiguousWith( const Blob &other ) const & noexcept
 			{
 				return
 				(
-					storage != nullptr
+					storage.reference()
 						and
-					*storage == *other.backing
+					storage.reference() == other.storage.reference()
 						and
 					byte_data() + size() == other.byte_data()
 				);
@@ -306,7 +469,10 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 						compose() const noexcept
 						{
 							assert( result );
-							self= Blob{ self.storage, Buffer< Mutable >{ self.data(), self.size() + other.size() } };
+							// Both sides already hold a reference on the same storage, so we just widen our view
+							// and let `other` drop its reference.
+							self.buffer= Buffer< Mutable >{ self.data(), self.size() + other.size() };
+							self.viewLimit= self.buffer.size();
 							other.reset();
 						}
 				};
@@ -331,7 +497,7 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 			bool
 			couldConcatenate( const Buffer< Const > buffer ) const noexcept
 			{
-				return data.size() <= ( capacity() - size() );
+				return buffer.size() <= ( capacity() - size() );
 			}
 
 			/*!
@@ -372,9 +538,8 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 			[[nodiscard]] Buffer< constness >
 			concatenate( const Buffer< constness > data ) noexcept
 			{
-				const auto amount= std::min( capacity - size(), data.size() );
-				const DataWindow< const > fitted{ data, amount };
-				copyData( buffer, + size(), fitted );
+				const auto amount= std::min( capacity() - size(), data.size() );
+				copyData( buffer + size(), Buffer< Const >{ data.byte_data(), amount } );
 				setSize( size() + amount );
 				return data + amount;
 			}
@@ -406,8 +571,8 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 				}
 				else
 				{
-					const auto amount= concatenate( Buffer< Const >{ blob } ).size()
-					const auto rv= blob.carveTail( amount );
+					const auto amount= concatenate( Buffer< Const >{ blob } ).size();
+					auto rv= blob.carveTail( amount );
 					blob.reset();
 					return rv;
 				}
@@ -439,7 +604,7 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 					return;
 				}
 
-				Blob tmp{ needed };
+				Blob tmp{ needed, AllocationPolicy::Uninitialized, currentAllocator() };
 				copyData( tmp, *this );
 				copyData( tmp + size(), data );
 				tmp.setSize( size() + data.size() );
@@ -481,9 +646,6 @@ namespace Alepha::inline Cavorite  ::detail::  blob
 				blob.reset();
 			}
 	};
-
-	static_assert( HasCapability< Blob, swappable > );
-	static_assert( detail::swaps::SwapLensable< Blob > );
 }
 
 namespace Alepha::Cavorite::inline exports::inline blob
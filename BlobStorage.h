@@ -0,0 +1,299 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstddef>
+
+#include <new>
+#include <array>
+#include <atomic>
+#include <utility>
+
+#include "ByteAllocator.h"
+#include "error.h"
+
+namespace Alepha::inline Cavorite  ::detail::  blob_storage
+{
+	inline namespace exports
+	{
+		class BlobStorage;
+		class StorageReference;
+		struct StorageAllocation;
+		struct FileSource;
+
+		StorageAllocation allocateHeapStorage( std::size_t amount, ByteAllocator &allocator );
+	}
+
+	namespace C
+	{
+		const bool debug= false;
+		const bool debugSharding= false or C::debug;
+
+		// How many overflow counters a storage block may spread its references across once it sees contention.
+		const std::size_t shardCount= 7;
+
+		const std::size_t cacheLineSize= 64;
+	}
+
+	/*!
+	 * The file whose bytes some storage holds, for handing them to the kernel by descriptor instead of by address.
+	 */
+	struct exports::FileSource
+	{
+		// An open descriptor for the file, owned by the storage.
+		int fd= -1;
+
+		// The address in the storage of the byte at `offset` in the file.
+		const std::byte *base= nullptr;
+		std::size_t offset= 0;
+	};
+
+	/*!
+	 * The shared state for the physical memory behind one or more `Blob` objects.
+	 *
+	 * Every reference to a `BlobStorage` is counted, and the storage disposes of itself when the last reference is
+	 * dropped.  The count lives in the storage itself (for heap allocations, this header sits directly in front of
+	 * the payload), so sharing costs no extra control blocks.
+	 *
+	 * Counting starts on one primary counter, which is all that single threaded use ever touches.  When taking
+	 * a new reference observes another thread racing on the same counter, the new reference is placed on one of
+	 * a small set of overflow shards instead, each on its own cache line.  The shard chosen is always the next one
+	 * along from the contended counter, so the spreading is deterministic and happens only under actual contention.
+	 * An active shard (one with a nonzero count) holds a single reference on the primary counter, so the storage
+	 * dies exactly when the primary counter reaches zero.
+	 */
+	class exports::BlobStorage
+	{
+		private:
+			struct alignas( C::cacheLineSize ) Shard
+			{
+				std::atomic< std::size_t > count= 0;
+			};
+			using Shards= std::array< Shard, C::shardCount >;
+
+			std::atomic< std::size_t > primary= 1;
+			std::atomic< Shards * > shards= nullptr;
+
+			friend StorageReference;
+
+			std::atomic< std::size_t > &
+			counter( const std::size_t shard ) noexcept
+			{
+				if( shard == 0 ) return primary;
+				return ( *shards.load( std::memory_order_acquire ) )[ shard - 1 ].count;
+			}
+
+			Shards *
+			installShards() noexcept
+			{
+				if( Shards *const existing= shards.load( std::memory_order_acquire ) ) return existing;
+
+				Shards *fresh= new ( std::nothrow ) Shards;
+				if( not fresh ) return nullptr;
+
+				Shards *expected= nullptr;
+				if( shards.compare_exchange_strong( expected, fresh, std::memory_order_acq_rel ) ) return fresh;
+				delete fresh;
+				return expected;
+			}
+
+			// Take a new reference, given that the caller holds one on `shard`.  Returns the shard of the new reference.
+			std::size_t
+			acquire( const std::size_t shard ) noexcept
+			{
+				auto &current= counter( shard );
+				auto count= current.load( std::memory_order_relaxed );
+				if( current.compare_exchange_strong( count, count + 1, std::memory_order_relaxed ) ) [[likely]] return shard;
+
+				// Someone else is working this counter -- move along to the next shard.
+				if( not installShards() )
+				{
+					current.fetch_add( 1, std::memory_order_relaxed );
+					return shard;
+				}
+
+				const std::size_t next= shard % C::shardCount + 1;
+				if( C::debugSharding ) error() << "Contention on shard " << shard << ", spreading to shard " << next << std::endl;
+				if( counter( next ).fetch_add( 1, std::memory_order_relaxed ) == 0 )
+				{
+					primary.fetch_add( 1, std::memory_order_relaxed );
+				}
+				return next;
+			}
+
+			void
+			release( const std::size_t shard ) noexcept
+			{
+				if( shard != 0 and counter( shard ).fetch_sub( 1, std::memory_order_acq_rel ) != 1 ) return;
+				if( primary.fetch_sub( 1, std::memory_order_release ) != 1 ) return;
+
+				std::atomic_thread_fence( std::memory_order_acquire );
+				delete shards.load( std::memory_order_relaxed );
+				dispose();
+			}
+
+		protected:
+			~BlobStorage()= default;
+
+			/*!
+			 * Release the physical memory and destroy this storage object.
+			 *
+			 * Called exactly once, by whichever thread drops the last reference.
+			 */
+			virtual void dispose() noexcept= 0;
+
+		public:
+			BlobStorage()= default;
+			BlobStorage( const BlobStorage & )= delete;
+			BlobStorage &operator= ( const BlobStorage & )= delete;
+
+			/*!
+			 * The allocator which provided this storage, if it came from one.
+			 */
+			virtual ByteAllocator *allocator() const noexcept { return nullptr; }
+
+			/*!
+			 * The file this storage holds the bytes of, if there is one.
+			 *
+			 * This is only so for storage which always shows the file's current contents, such as a read only or
+			 * shared mapping of it.
+			 */
+			virtual const FileSource *fileSource() const noexcept { return nullptr; }
+
+			/*!
+			 * Whether this storage is a private mapping, whose pages the kernel can be told to discard.
+			 *
+			 * Discarding them loses what was written to them, so it is only safe for whoever holds the only reference.
+			 */
+			virtual bool privateMapping() const noexcept { return false; }
+
+			/*!
+			 * The number of references to this storage.
+			 *
+			 * Like `std::shared_ptr::use_count`, this is only a snapshot when other threads hold references.  It is
+			 * exact when the calling thread holds the only reference.
+			 */
+			std::size_t
+			useCount() const noexcept
+			{
+				std::size_t rv= primary.load( std::memory_order_acquire );
+				if( const Shards *const spread= shards.load( std::memory_order_acquire ) )
+				{
+					for( const auto &shard: *spread )
+					{
+						const std::size_t count= shard.count.load( std::memory_order_acquire );
+						if( count ) rv+= count - 1;
+					}
+				}
+				return rv;
+			}
+	};
+
+	/*!
+	 * An owning, counted reference to a `BlobStorage`.
+	 *
+	 * Copying takes a new reference (one atomic operation in the uncontended case) and destruction drops one.  A
+	 * default constructed reference refers to nothing.
+	 */
+	class exports::StorageReference
+	{
+		private:
+			BlobStorage *storage= nullptr;
+			std::size_t shard= 0;
+
+		public:
+			~StorageReference() { reset(); }
+
+			StorageReference() noexcept= default;
+
+			// Adopt the initial reference of a newly created storage.
+			explicit StorageReference( BlobStorage *const storage ) noexcept : storage( storage ) {}
+
+			StorageReference( const StorageReference &copy ) noexcept
+				: storage( copy.storage ),
+				shard( storage ? storage->acquire( copy.shard ) : 0 )
+			{}
+
+			StorageReference( StorageReference &&orig ) noexcept
+				: storage( std::exchange( orig.storage, nullptr ) ),
+				shard( std::exchange( orig.shard, 0 ) )
+			{}
+
+			StorageReference &
+			operator= ( StorageReference copy ) noexcept
+			{
+				std::swap( storage, copy.storage );
+				std::swap( shard, copy.shard );
+				return *this;
+			}
+
+			void
+			reset() noexcept
+			{
+				if( storage ) std::exchange( storage, nullptr )->release( std::exchange( shard, 0 ) );
+			}
+
+			BlobStorage *get() const noexcept { return storage; }
+			BlobStorage *operator ->() const noexcept { return storage; }
+			explicit operator bool () const noexcept { return storage; }
+
+			friend bool operator == ( const StorageReference &lhs, const StorageReference &rhs ) noexcept { return lhs.storage == rhs.storage; }
+	};
+
+	/*!
+	 * Storage whose header is placed directly in front of its payload, in a single block from a `ByteAllocator`.
+	 */
+	class HeapStorage final
+		: public BlobStorage
+	{
+		private:
+			ByteAllocator *const source;
+			const std::size_t extent;
+
+			static constexpr std::size_t headerSize()
+			{
+				return ( sizeof( HeapStorage ) + alignof( std::max_align_t ) - 1 ) / alignof( std::max_align_t ) * alignof( std::max_align_t );
+			}
+
+			void
+			dispose() noexcept override
+			{
+				ByteAllocator *const allocator= source;
+				const std::size_t total= headerSize() + extent;
+				std::byte *const block= reinterpret_cast< std::byte * >( this );
+				this->~HeapStorage();
+				allocator->deallocate( block, total );
+			}
+
+			friend StorageAllocation exports::allocateHeapStorage( std::size_t, ByteAllocator & );
+
+		public:
+			explicit HeapStorage( ByteAllocator &source, const std::size_t extent ) noexcept : source( &source ), extent( extent ) {}
+
+			ByteAllocator *allocator() const noexcept override { return source; }
+	};
+
+	struct exports::StorageAllocation
+	{
+		StorageReference storage;
+		std::byte *data;
+	};
+
+	/*!
+	 * Obtain `amount` bytes of uninitialized shared storage from `allocator`.
+	 *
+	 * The counting header and the payload are one allocation.
+	 */
+	inline StorageAllocation
+	exports::allocateHeapStorage( const std::size_t amount, ByteAllocator &allocator )
+	{
+		std::byte *const block= allocator.allocate( HeapStorage::headerSize() + amount );
+		auto *const storage= new ( block ) HeapStorage( allocator, amount );
+		return { StorageReference{ storage }, block + HeapStorage::headerSize() };
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline blob_storage
+{
+	using namespace detail::blob_storage::exports;
+}
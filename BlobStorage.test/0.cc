@@ -0,0 +1,86 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../BlobStorage.h"
+
+#include <thread>
+#include <vector>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+#include <Alepha/Testing/CountingAllocator.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	using Alepha::StorageReference;
+	using Alepha::allocateHeapStorage;
+	using Alepha::CountingAllocator;
+
+	"blob_storage.single_owner"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		{
+			auto [ storage, data ]= allocateHeapStorage( 100, allocator );
+			test.expect( allocator.live == 1 );
+			test.expect( storage->useCount() == 1 );
+			test.expect( storage->allocator() == &allocator );
+			test.expect( reinterpret_cast< std::uintptr_t >( data ) % alignof( std::max_align_t ) == 0 );
+			data[ 99 ]= std::byte{ 42 };
+		}
+		test.expect( allocator.live == 0 );
+	};
+
+	"blob_storage.sharing"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		auto first= allocateHeapStorage( 16, allocator ).storage;
+		{
+			StorageReference second= first;
+			StorageReference third= second;
+			test.expect( first == third );
+			test.expect( first->useCount() == 3 );
+
+			StorageReference moved= std::move( second );
+			test.expect( not second );
+			test.expect( first->useCount() == 3 );
+		}
+		test.expect( first->useCount() == 1 );
+		test.expect( allocator.live == 1 );
+		first.reset();
+		test.expect( allocator.live == 0 );
+	};
+
+	"blob_storage.contended"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		auto root= allocateHeapStorage( 64, allocator ).storage;
+
+		std::vector< std::thread > threads;
+		for( int i= 0; i < 4; ++i )
+		{
+			threads.emplace_back( [ parent= root ]
+			{
+				std::vector< StorageReference > held;
+				for( int round= 0; round < 20'000; ++round )
+				{
+					held.push_back( held.empty() ? parent : held.back() );
+					if( held.size() > 16 ) held.clear();
+				}
+			});
+		}
+		for( auto &thread: threads ) thread.join();
+
+		test.expect( root->useCount() == 1 );
+		test.expect( allocator.live == 1 );
+		root.reset();
+		test.expect( allocator.live == 0 );
+	};
+};
@@ -0,0 +1,57 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../BlobStorage.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+/*
+ * Carve and drop from several threads at once, all sharing one piece of storage.  This compares the intrusive
+ * `StorageReference` against the two-level `std::shared_ptr< std::shared_ptr< ... > >` scheme which `Blob` used
+ * before, where every carve copies the outer `std::shared_ptr`.
+ */
+
+namespace
+{
+	template< typename Reference >
+	double
+	carveAndDrop( const Reference &root, const std::size_t threadCount, const std::size_t rounds )
+	{
+		const auto start= std::chrono::steady_clock::now();
+		std::vector< std::thread > threads;
+		for( std::size_t i= 0; i < threadCount; ++i )
+		{
+			threads.emplace_back( [&root, rounds]
+			{
+				Reference local= root;
+				for( std::size_t round= 0; round < rounds; ++round )
+				{
+					Reference carved= local;
+					Reference again= carved;
+				}
+			});
+		}
+		for( auto &thread: threads ) thread.join();
+		const std::chrono::duration< double, std::nano > elapsed= std::chrono::steady_clock::now() - start;
+		return elapsed.count() / ( threadCount * rounds * 2 );
+	}
+}
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	const std::size_t rounds= argcnt > 1 ? std::stoul( argvec[ 1 ] ) : 200'000;
+	const std::size_t threadCount= std::max( 4u, std::thread::hardware_concurrency() );
+
+	using Indirect= std::shared_ptr< std::shared_ptr< std::vector< std::byte > > >;
+	const Indirect indirect= std::make_shared< std::shared_ptr< std::vector< std::byte > > >(
+			std::make_shared< std::vector< std::byte > >( 4096 ) );
+	const auto intrusive= Alepha::allocateHeapStorage( 4096, Alepha::NewArrayAllocator::instance() ).storage;
+
+	std::cout << threadCount << " threads" << std::endl;
+	std::cout << "shared_ptr< shared_ptr >: " << carveAndDrop( indirect, threadCount, rounds ) << " ns per carve" << std::endl;
+	std::cout << "StorageReference:         " << carveAndDrop( intrusive, threadCount, rounds ) << " ns per carve" << std::endl;
+}
@@ -0,0 +1,625 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstddef>
+
+#include <new>
+#include <bit>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <optional>
+#include <concepts>
+#include <algorithm>
+#include <type_traits>
+
+#include "Thread.h"
+
+namespace Alepha::inline Cavorite  ::detail::  bounded_queue
+{
+	// Items are moved into and out of slots at points where a throw would leave a queue inconsistent.
+	template< typename T >
+	concept QueueItem= std::movable< T > and std::is_nothrow_move_constructible_v< T >;
+
+	// Where `MpmcQueue` takes a batch from.  Once a producer has claimed slots it must fill every one of them, so
+	// nothing it does to fill them may throw.
+	template< typename Iterator, typename T >
+	concept NothrowSource= std::input_iterator< Iterator >
+			and std::is_nothrow_constructible_v< T, std::iter_rvalue_reference_t< Iterator > >
+			and noexcept( *std::declval< Iterator & >() ) and noexcept( ++std::declval< Iterator & >() );
+
+	inline namespace exports
+	{
+		template< QueueItem T > class SpscQueue;
+		template< QueueItem T > class MpmcQueue;
+	}
+
+	namespace C
+	{
+		const std::size_t cacheLineSize= 64;
+
+		// How many times a blocking operation yields, to give the other side the chance to catch up, before it parks.
+		const std::size_t spinLimit= 16;
+	}
+
+	/*!
+	 * Blocking for one side of a queue, as `Mailbox` does it.
+	 *
+	 * The waiter counts its interest before checking its condition under the lock, and the waker changes the
+	 * queue before checking for interest.  So either the waiter sees the change, or the waker sees the waiter and
+	 * takes the lock, which it can only get once the waiter is really waiting.  A side with nobody waiting costs
+	 * its wakers one fence and one load.
+	 */
+	class Parking
+	{
+		private:
+			Mutex access;
+			ConditionVariable condition;
+			std::atomic< std::size_t > waiting= 0;
+
+		public:
+			void
+			wake()
+			{
+				std::atomic_thread_fence( std::memory_order_seq_cst );
+				if( not waiting.load( std::memory_order_relaxed ) ) return;
+				{ lock_guard lock( access ); }
+				condition.notify_all();
+			}
+
+			template< typename Predicate >
+			void
+			wait( Predicate predicate )
+			{
+				// The other side is usually only a moment away, and parking costs both sides a system call.
+				for( std::size_t spin= 0; spin < C::spinLimit; ++spin )
+				{
+					if( predicate() ) return;
+					boost::this_thread::yield();
+				}
+
+				unique_lock lock( access );
+				++waiting;
+				std::atomic_thread_fence( std::memory_order_seq_cst );
+				try
+				{
+					condition.wait( lock, predicate );
+				}
+				catch( ... )
+				{
+					--waiting;
+					throw;
+				}
+				--waiting;
+			}
+	};
+
+	// Uninitialized room for one `T`.
+	template< typename T >
+	struct Slot
+	{
+		alignas( T ) std::byte storage[ sizeof( T ) ];
+
+		template< typename Arg > void construct( Arg &&arg ) { ::new ( storage ) T( std::forward< Arg >( arg ) ); }
+		T &get() noexcept { return *std::launder( reinterpret_cast< T * >( storage ) ); }
+
+		T
+		take() noexcept
+		{
+			T rv= std::move( get() );
+			get().~T();
+			return rv;
+		}
+	};
+
+	inline std::size_t
+	roundCapacity( const std::size_t capacity ) noexcept
+	{
+		return std::bit_ceil( std::max< std::size_t >( capacity, 2 ) );
+	}
+
+	/*!
+	 * A bounded, lock free queue for exactly one producer thread and one consumer thread.
+	 *
+	 * The capacity is a power of two, so positions map to slots by masking.  The producer and consumer positions
+	 * are on separate cache lines, and each side keeps a private copy of the other's position, which it only
+	 * refreshes when the queue looks full (or empty).  So in the steady state neither side reads a cache line the
+	 * other is writing.  `push_n` and `pop_n` move a whole batch for one publication.
+	 *
+	 * The blocking operations wait on an `Alepha::ConditionVariable`, so an `Alepha::Thread` blocked in one can be
+	 * interrupted with a `Notification`.
+	 */
+	template< QueueItem T >
+	class exports::SpscQueue
+	{
+		private:
+			const std::size_t mask;
+			const std::unique_ptr< Slot< T >[] > slots;
+
+			// The consumer's side.
+			alignas( C::cacheLineSize ) std::atomic< std::size_t > head= 0;
+			std::size_t knownTail= 0;
+
+			// The producer's side.
+			alignas( C::cacheLineSize ) std::atomic< std::size_t > tail= 0;
+			std::size_t knownHead= 0;
+
+			alignas( C::cacheLineSize ) std::atomic< bool > closed_= false;
+			Parking producer;
+			Parking consumer;
+
+			// How many slots the producer may fill, and how many items the consumer may take, now.  The other side's
+			// position is only read again when the copy of it does not allow for all that is `wanted`.
+			std::size_t
+			room( const std::size_t position, const std::size_t wanted ) noexcept
+			{
+				if( mask + 1 - ( position - knownHead ) < wanted ) knownHead= head.load( std::memory_order_acquire );
+				return mask + 1 - ( position - knownHead );
+			}
+
+			std::size_t
+			available( const std::size_t position, const std::size_t wanted ) noexcept
+			{
+				if( knownTail - position < wanted ) knownTail= tail.load( std::memory_order_acquire );
+				return knownTail - position;
+			}
+
+			void
+			published( const std::size_t position, const std::size_t amount )
+			{
+				if( not amount ) return;
+				tail.store( position + amount, std::memory_order_release );
+				consumer.wake();
+			}
+
+			void
+			released( const std::size_t position, const std::size_t amount )
+			{
+				if( not amount ) return;
+				head.store( position + amount, std::memory_order_release );
+				producer.wake();
+			}
+
+			bool hasRoom() const noexcept { return tail.load( std::memory_order_relaxed ) - head.load( std::memory_order_acquire ) <= mask; }
+			bool hasItems() const noexcept { return tail.load( std::memory_order_acquire ) != head.load( std::memory_order_relaxed ); }
+
+		public:
+			/*!
+			 * @param capacity The least number of items the queue holds.  It is rounded up to a power of two.
+			 */
+			explicit
+			SpscQueue( const std::size_t capacity )
+				: mask( roundCapacity( capacity ) - 1 ), slots( new Slot< T >[ mask + 1 ] )
+			{}
+
+			SpscQueue( const SpscQueue & )= delete;
+			SpscQueue &operator= ( const SpscQueue & )= delete;
+
+			~SpscQueue()
+			{
+				for( std::size_t position= head.load(); position != tail.load(); ++position ) slots[ position & mask ].get().~T();
+			}
+
+			std::size_t capacity() const noexcept { return mask + 1; }
+
+			// The number of items in the queue.  Only a snapshot, unless called by the producer or consumer.
+			std::size_t size() const noexcept { return tail.load( std::memory_order_acquire ) - head.load( std::memory_order_acquire ); }
+
+			/*!
+			 * Stop accepting items.  The consumer still gets what is in the queue, after which `pop` returns nothing.
+			 */
+			void
+			close()
+			{
+				closed_= true;
+				producer.wake();
+				consumer.wake();
+			}
+
+			bool closed() const noexcept { return closed_.load(); }
+
+			/*!
+			 * Add as many of the `count` items from `first` as there is room for right now.
+			 *
+			 * @return How many items were added.  Those after them have not been moved from.
+			 * @throw Whatever making an item from `*first`, or advancing `first`, throws.  The items before that one
+			 * are still added.
+			 */
+			template< std::input_iterator Iterator >
+			std::size_t
+			tryPush_n( Iterator first, const std::size_t count )
+			{
+				if( closed() ) return 0;
+				const std::size_t position= tail.load( std::memory_order_relaxed );
+				const std::size_t amount= std::min( count, room( position, count ) );
+				std::size_t index= 0;
+				try
+				{
+					for( ; index < amount; ++index, ++first ) slots[ ( position + index ) & mask ].construct( std::move( *first ) );
+				}
+				catch( ... )
+				{
+					published( position, index );
+					throw;
+				}
+				published( position, amount );
+				return amount;
+			}
+
+			/*!
+			 * Add `item`, if there is room for it right now.
+			 *
+			 * @return Whether `item` was taken.  If it was not, then it has not been moved from.
+			 */
+			bool tryPush( T &&item ) { return tryPush_n( &item, 1 ); }
+
+			/*!
+			 * Add `count` items from `first`, waiting for room as need be.
+			 *
+			 * @return How many items were added, which is fewer than `count` only if the queue was closed.
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 */
+			template< std::input_iterator Iterator >
+			std::size_t
+			push_n( Iterator first, const std::size_t count )
+			{
+				std::size_t rv= 0;
+				while( rv < count and not closed() )
+				{
+					const std::size_t pushed= tryPush_n( first, count - rv );
+					std::advance( first, pushed );
+					rv+= pushed;
+					if( not pushed ) producer.wait( [&]{ return hasRoom() or closed(); } );
+				}
+				return rv;
+			}
+
+			bool push( T &&item ) { return push_n( &item, 1 ); }
+
+			/*!
+			 * Move up to `count` items into `out`, as many as there are right now.
+			 *
+			 * @return How many items were taken.
+			 * @throw Whatever assigning through `out` throws.  The items before that one are still taken, and that
+			 * one stays at the front of the queue.
+			 */
+			template< std::output_iterator< T > Iterator >
+			std::size_t
+			tryPop_n( Iterator out, const std::size_t count )
+			{
+				const std::size_t position= head.load( std::memory_order_relaxed );
+				const std::size_t amount= std::min( count, available( position, count ) );
+				std::size_t index= 0;
+				try
+				{
+					for( ; index < amount; ++index )
+					{
+						T &item= slots[ ( position + index ) & mask ].get();
+						*out++= std::move( item );
+						item.~T();
+					}
+				}
+				catch( ... )
+				{
+					released( position, index );
+					throw;
+				}
+				released( position, amount );
+				return amount;
+			}
+
+			std::optional< T >
+			tryPop()
+			{
+				std::optional< T > rv;
+				const std::size_t position= head.load( std::memory_order_relaxed );
+				if( not available( position, 1 ) ) return rv;
+				rv.emplace( slots[ position & mask ].take() );
+				released( position, 1 );
+				return rv;
+			}
+
+			/*!
+			 * Move up to `count` items into `out`, waiting until there is at least one.
+			 *
+			 * @return How many items were taken, which is none only once the queue is closed and empty.
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 */
+			template< std::output_iterator< T > Iterator >
+			std::size_t
+			pop_n( Iterator out, const std::size_t count )
+			{
+				while( true )
+				{
+					if( const std::size_t taken= tryPop_n( out, count ) ) return taken;
+					if( closed() ) return tryPop_n( out, count );
+					consumer.wait( [&]{ return hasItems() or closed(); } );
+				}
+			}
+
+			/*!
+			 * Take the oldest item, waiting for one if need be.
+			 *
+			 * @return The item, or nothing once the queue is closed and empty.
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 */
+			std::optional< T >
+			pop()
+			{
+				while( true )
+				{
+					if( auto rv= tryPop() ) return rv;
+					if( closed() ) return tryPop();
+					consumer.wait( [&]{ return hasItems() or closed(); } );
+				}
+			}
+	};
+
+	/*!
+	 * A bounded, lock free queue for any number of producer and consumer threads.
+	 *
+	 * This is Dmitry Vyukov's bounded MPMC queue: each slot carries a sequence number which says which lap of the
+	 * ring it is ready for, and which side may use it next.  A producer or consumer claims a position with one
+	 * compare-and-swap on its own, cache line padded, counter; contention between producers and consumers is only
+	 * ever on individual slots.  `push_n` and `pop_n` claim a run of ready slots with a single compare-and-swap.
+	 *
+	 * As with `SpscQueue`, the blocking operations can be interrupted with a `Notification`.
+	 */
+	template< QueueItem T >
+	class exports::MpmcQueue
+	{
+		private:
+			struct Cell
+			{
+				std::atomic< std::size_t > sequence;
+				Slot< T > slot;
+			};
+
+			const std::size_t mask;
+			const std::unique_ptr< Cell[] > cells;
+
+			alignas( C::cacheLineSize ) std::atomic< std::size_t > enqueuePosition= 0;
+			alignas( C::cacheLineSize ) std::atomic< std::size_t > dequeuePosition= 0;
+
+			alignas( C::cacheLineSize ) std::atomic< bool > closed_= false;
+			Parking producers;
+			Parking consumers;
+
+			Cell &cell( const std::size_t position ) const noexcept { return cells[ position & mask ]; }
+
+			// Claim up to `count` consecutive positions, whose cells are at `lap` past the position when ready.
+			std::pair< std::size_t, std::size_t >
+			claim( std::atomic< std::size_t > &counter, const std::size_t lap, const std::size_t count ) noexcept
+			{
+				std::size_t position= counter.load( std::memory_order_relaxed );
+				while( true )
+				{
+					std::size_t ready= 0;
+					while( ready < count and ready <= mask )
+					{
+						const std::size_t sequence= cell( position + ready ).sequence.load( std::memory_order_acquire );
+						if( sequence != position + ready + lap ) break;
+						++ready;
+					}
+
+					if( not ready )
+					{
+						// Either the ring really is full (or empty), or another thread has moved on past `position`.
+						const std::size_t sequence= cell( position ).sequence.load( std::memory_order_acquire );
+						if( std::ptrdiff_t( sequence - ( position + lap ) ) < 0 ) return { position, 0 };
+						position= counter.load( std::memory_order_relaxed );
+						continue;
+					}
+
+					if( counter.compare_exchange_weak( position, position + ready, std::memory_order_relaxed ) ) return { position, ready };
+				}
+			}
+
+			// Empty the claimed cell at `position`, and hand it on to the producers' next lap.
+			void
+			release( const std::size_t position ) noexcept
+			{
+				Cell &source= cell( position );
+				source.slot.get().~T();
+				source.sequence.store( position + mask + 1, std::memory_order_release );
+			}
+
+			bool
+			hasRoom() const noexcept
+			{
+				const std::size_t position= enqueuePosition.load( std::memory_order_relaxed );
+				return cell( position ).sequence.load( std::memory_order_acquire ) == position;
+			}
+
+			bool
+			hasItems() const noexcept
+			{
+				const std::size_t position= dequeuePosition.load( std::memory_order_relaxed );
+				return cell( position ).sequence.load( std::memory_order_acquire ) == position + 1;
+			}
+
+		public:
+			/*!
+			 * @param capacity The least number of items the queue holds.  It is rounded up to a power of two.
+			 */
+			explicit
+			MpmcQueue( const std::size_t capacity )
+				: mask( roundCapacity( capacity ) - 1 ), cells( new Cell[ mask + 1 ] )
+			{
+				for( std::size_t index= 0; index <= mask; ++index ) cells[ index ].sequence.store( index, std::memory_order_relaxed );
+			}
+
+			MpmcQueue( const MpmcQueue & )= delete;
+			MpmcQueue &operator= ( const MpmcQueue & )= delete;
+
+			~MpmcQueue()
+			{
+				for( std::size_t position= dequeuePosition.load(); position != enqueuePosition.load(); ++position )
+				{
+					cell( position ).slot.get().~T();
+				}
+			}
+
+			std::size_t capacity() const noexcept { return mask + 1; }
+
+			// The number of items in the queue, or on their way in or out.  Only a snapshot.
+			std::size_t
+			size() const noexcept
+			{
+				const std::size_t out= dequeuePosition.load( std::memory_order_acquire );
+				return std::min( enqueuePosition.load( std::memory_order_acquire ) - out, capacity() );
+			}
+
+			/*!
+			 * Stop accepting items.  Consumers still get what is in the queue, after which `pop` returns nothing.
+			 */
+			void
+			close()
+			{
+				closed_= true;
+				producers.wake();
+				consumers.wake();
+			}
+
+			bool closed() const noexcept { return closed_.load(); }
+
+			/*!
+			 * Add as many of the `count` items from `first` as there is room for right now.
+			 *
+			 * @return How many items were added.  Those after them have not been moved from.
+			 */
+			template< NothrowSource< T > Iterator >
+			std::size_t
+			tryPush_n( Iterator first, const std::size_t count )
+			{
+				if( closed() or not count ) return 0;
+				const auto [ position, amount ]= claim( enqueuePosition, 0, count );
+				for( std::size_t index= 0; index < amount; ++index, ++first )
+				{
+					Cell &target= cell( position + index );
+					target.slot.construct( std::move( *first ) );
+					target.sequence.store( position + index + 1, std::memory_order_release );
+				}
+				if( amount ) consumers.wake();
+				return amount;
+			}
+
+			/*!
+			 * Add `item`, if there is room for it right now.
+			 *
+			 * @return Whether `item` was taken.  If it was not, then it has not been moved from.
+			 */
+			bool tryPush( T &&item ) { return tryPush_n( &item, 1 ); }
+
+			/*!
+			 * Add `count` items from `first`, waiting for room as need be.
+			 *
+			 * @return How many items were added, which is fewer than `count` only if the queue was closed.
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 */
+			template< NothrowSource< T > Iterator >
+			std::size_t
+			push_n( Iterator first, const std::size_t count )
+			{
+				std::size_t rv= 0;
+				while( rv < count and not closed() )
+				{
+					const std::size_t pushed= tryPush_n( first, count - rv );
+					std::advance( first, pushed );
+					rv+= pushed;
+					if( not pushed ) producers.wait( [&]{ return hasRoom() or closed(); } );
+				}
+				return rv;
+			}
+
+			bool push( T &&item ) { return push_n( &item, 1 ); }
+
+			/*!
+			 * Move up to `count` items into `out`, as many as there are right now.
+			 *
+			 * @return How many items were taken.
+			 * @throw Whatever assigning through `out` throws.  The items before that one are still taken.  Other
+			 * consumers may already have moved past that one and the rest of the claimed batch, so they cannot be
+			 * put back: they are destroyed, rather than leave their slots claimed forever.
+			 */
+			template< std::output_iterator< T > Iterator >
+			std::size_t
+			tryPop_n( Iterator out, const std::size_t count )
+			{
+				if( not count ) return 0;
+				const auto [ position, amount ]= claim( dequeuePosition, 1, count );
+				std::size_t index= 0;
+				try
+				{
+					for( ; index < amount; ++index )
+					{
+						*out++= std::move( cell( position + index ).slot.get() );
+						release( position + index );
+					}
+				}
+				catch( ... )
+				{
+					for( ; index < amount; ++index ) release( position + index );
+					producers.wake();
+					throw;
+				}
+				if( amount ) producers.wake();
+				return amount;
+			}
+
+			std::optional< T >
+			tryPop()
+			{
+				std::optional< T > rv;
+				const auto [ position, amount ]= claim( dequeuePosition, 1, 1 );
+				if( not amount ) return rv;
+
+				rv.emplace( std::move( cell( position ).slot.get() ) );
+				release( position );
+				producers.wake();
+				return rv;
+			}
+
+			/*!
+			 * Move up to `count` items into `out`, waiting until there is at least one.
+			 *
+			 * @return How many items were taken, which is none only once the queue is closed and empty.
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 */
+			template< std::output_iterator< T > Iterator >
+			std::size_t
+			pop_n( Iterator out, const std::size_t count )
+			{
+				while( true )
+				{
+					if( const std::size_t taken= tryPop_n( out, count ) ) return taken;
+					if( closed() ) return tryPop_n( out, count );
+					consumers.wait( [&]{ return hasItems() or closed(); } );
+				}
+			}
+
+			/*!
+			 * Take the oldest item, waiting for one if need be.
+			 *
+			 * @return The item, or nothing once the queue is closed and empty.
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 */
+			std::optional< T >
+			pop()
+			{
+				while( true )
+				{
+					if( auto rv= tryPop() ) return rv;
+					if( closed() ) return tryPop();
+					consumers.wait( [&]{ return hasItems() or closed(); } );
+				}
+			}
+	};
+}
+
+namespace Alepha::Cavorite::inline exports::inline bounded_queue
+{
+	using namespace detail::bounded_queue::exports;
+}
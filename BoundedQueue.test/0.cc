@@ -0,0 +1,314 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../BoundedQueue.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	using StopNotification= Alepha::create_exception< struct stop_notification, Alepha::Notification >;
+
+	// Items need not be default constructible, nor copyable.
+	struct Message
+	{
+		std::unique_ptr< std::string > text;
+
+		explicit Message( std::string text ) : text( std::make_unique< std::string >( std::move( text ) ) ) {}
+	};
+
+	// Moving this could throw, which the queues refuse.
+	struct ThrowingMove
+	{
+		ThrowingMove()= default;
+		ThrowingMove( ThrowingMove && ) {}
+		ThrowingMove &operator= ( ThrowingMove && ) { return *this; }
+	};
+
+	template< typename T >
+	concept Queueable= requires { typename Alepha::SpscQueue< T >; typename Alepha::MpmcQueue< T >; };
+
+	static_assert( Queueable< Message > and not Queueable< ThrowingMove > );
+
+	// An output iterator which refuses the third item assigned through it.
+	struct Refusing
+	{
+		using difference_type= std::ptrdiff_t;
+
+		std::vector< int > *received;
+
+		Refusing &operator *() { return *this; }
+		Refusing &operator ++() { return *this; }
+		Refusing &operator ++( int ) { return *this; }
+
+		Refusing &
+		operator= ( const int item )
+		{
+			if( received->size() == 2 ) throw std::runtime_error( "Refused." );
+			received->push_back( item );
+			return *this;
+		}
+	};
+
+	template< typename Queue >
+	std::vector< int >
+	refusedBatch( Queue &queue )
+	{
+		for( int i= 0; i < 5; ++i ) queue.push( int{ i } );
+		std::vector< int > received;
+		try { queue.tryPop_n( Refusing{ &received }, 5 ); }
+		catch( const std::runtime_error & ) { return received; }
+		return {};
+	}
+
+	template< typename Queue >
+	bool
+	fifo()
+	{
+		Queue queue{ 5 };
+		if( queue.capacity() != 8 ) return false;
+
+		for( int i= 0; i < 8; ++i ) if( not queue.tryPush( Message{ std::to_string( i ) } ) ) return false;
+		Message extra{ "extra" };
+		if( queue.tryPush( std::move( extra ) ) or not extra.text ) return false;
+
+		// Go round the ring a few times.
+		for( int i= 8; i < 40; ++i )
+		{
+			const auto popped= queue.tryPop();
+			if( not popped or *popped->text != std::to_string( i - 8 ) ) return false;
+			if( not queue.tryPush( Message{ std::to_string( i ) } ) ) return false;
+		}
+		return queue.size() == 8;
+	}
+
+	template< typename Queue >
+	bool
+	batches()
+	{
+		Queue queue{ 8 };
+		std::vector< int > in;
+		for( int i= 0; i < 12; ++i ) in.push_back( i );
+
+		if( queue.tryPush_n( in.begin(), in.size() ) != 8 ) return false;
+
+		std::array< int, 5 > out;
+		if( queue.tryPop_n( out.begin(), out.size() ) != 5 ) return false;
+		if( out != std::array{ 0, 1, 2, 3, 4 } ) return false;
+
+		if( queue.tryPush_n( in.begin() + 8, 4 ) != 4 ) return false;
+
+		std::vector< int > rest;
+		if( queue.pop_n( std::back_inserter( rest ), 100 ) != 7 ) return false;
+		return rest == std::vector{ 5, 6, 7, 8, 9, 10, 11 };
+	}
+
+	template< typename Queue >
+	bool
+	interruptibleConsumer()
+	{
+		Queue queue{ 4 };
+
+		std::atomic< bool > started= false;
+		bool interrupted= false;
+		Alepha::Thread consumer{ [&]
+		{
+			started= true;
+			try { queue.pop(); }
+			catch( const StopNotification & ) { interrupted= true; }
+		} };
+
+		// The interruption is held until the consumer reaches its wait, so it need only have started.
+		while( not started ) std::this_thread::yield();
+		consumer.interrupt( Alepha::build_exception< StopNotification >( "stop" ) );
+		consumer.join();
+
+		return interrupted and queue.tryPush( 1 ) and queue.size() == 1;
+	}
+
+	template< typename Queue >
+	bool
+	closing()
+	{
+		Queue queue{ 4 };
+		queue.push( 1 );
+		queue.push( 2 );
+
+		std::vector< int > received;
+		Alepha::Thread consumer{ [&]
+		{
+			while( const auto item= queue.pop() ) received.push_back( *item );
+		} };
+
+		queue.push( 3 );
+		queue.close();
+		consumer.join();
+
+		return not queue.push( 4 ) and received == std::vector{ 1, 2, 3 };
+	}
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"fifo"_test <=[]( TestState test )
+	{
+		test.expect( fifo< Alepha::SpscQueue< Message > >() );
+		test.expect( fifo< Alepha::MpmcQueue< Message > >() );
+	};
+
+	"batches"_test <=[]( TestState test )
+	{
+		test.expect( batches< Alepha::SpscQueue< int > >() );
+		test.expect( batches< Alepha::MpmcQueue< int > >() );
+	};
+
+	"spsc_handoff"_test <=[]( TestState test )
+	{
+		const int count= 200'000;
+		Alepha::SpscQueue< int > queue{ 64 };
+
+		Alepha::Thread producer{ [&]
+		{
+			std::array< int, 16 > batch;
+			for( int i= 0; i < count; i+= batch.size() )
+			{
+				for( std::size_t j= 0; j < batch.size(); ++j ) batch[ j ]= i + j;
+				queue.push_n( batch.begin(), batch.size() );
+			}
+			queue.close();
+		} };
+
+		int expected= 0;
+		bool ordered= true;
+		while( const auto item= queue.pop() ) ordered= ordered and *item == expected++;
+		producer.join();
+
+		test.expect( ordered );
+		test.expect( expected == count );
+	};
+
+	"mpmc_many_to_many"_test <=[]( TestState test )
+	{
+		const int producers= 4;
+		const int consumers= 3;
+		const int each= 50'000;
+		Alepha::MpmcQueue< std::pair< int, int > > queue{ 32 };
+
+		std::atomic< int > producing= producers;
+		std::vector< std::unique_ptr< Alepha::Thread > > threads;
+		for( int p= 0; p < producers; ++p )
+		{
+			threads.push_back( std::make_unique< Alepha::Thread >( [&, p]
+			{
+				for( int i= 0; i < each; ++i ) queue.push( { p, i } );
+				if( --producing == 0 ) queue.close();
+			} ) );
+		}
+
+		// Each consumer sees each producer's items in the order they were pushed.
+		std::atomic< long > total= 0;
+		std::atomic< bool > ordered= true;
+		for( int c= 0; c < consumers; ++c )
+		{
+			threads.push_back( std::make_unique< Alepha::Thread >( [&]
+			{
+				std::array< int, producers > last;
+				last.fill( -1 );
+				std::array< std::pair< int, int >, 8 > batch;
+				while( const std::size_t taken= queue.pop_n( batch.begin(), batch.size() ) )
+				{
+					for( std::size_t k= 0; k < taken; ++k )
+					{
+						const auto [ p, i ]= batch[ k ];
+						if( i <= last[ p ] ) ordered= false;
+						last[ p ]= i;
+						total+= i;
+					}
+				}
+			} ) );
+		}
+		for( auto &thread: threads ) thread->join();
+
+		test.expect( ordered );
+		test.expect( total == long( producers ) * each * ( each - 1 ) / 2 );
+		test.expect( queue.size() == 0 );
+	};
+
+	"interruptible_wait"_test <=[]( TestState test )
+	{
+		test.expect( interruptibleConsumer< Alepha::SpscQueue< int > >() );
+		test.expect( interruptibleConsumer< Alepha::MpmcQueue< int > >() );
+	};
+
+	"interruptible_producer"_test <=[]( TestState test )
+	{
+		Alepha::MpmcQueue< int > queue{ 2 };
+		queue.push( 1 );
+		queue.push( 2 );
+
+		std::atomic< bool > started= false;
+		bool interrupted= false;
+		Alepha::Thread producer{ [&]
+		{
+			started= true;
+			try { queue.push( 3 ); }
+			catch( const StopNotification & ) { interrupted= true; }
+		} };
+
+		while( not started ) std::this_thread::yield();
+		producer.interrupt( Alepha::build_exception< StopNotification >( "stop" ) );
+		producer.join();
+
+		test.expect( interrupted );
+		test.expect( queue.size() == 2 );
+	};
+
+	"close"_test <=[]( TestState test )
+	{
+		test.expect( closing< Alepha::SpscQueue< int > >() );
+		test.expect( closing< Alepha::MpmcQueue< int > >() );
+	};
+
+	"throwing_consumer"_test <=[]( TestState test )
+	{
+		// The refused item stays at the front of an SPSC queue.
+		Alepha::SpscQueue< int > spsc{ 8 };
+		test.expect( refusedBatch( spsc ) == std::vector{ 0, 1 } );
+		test.expect( spsc.size() == 3 and spsc.tryPop() == 2 );
+
+		// An MPMC queue drops the rest of the batch, but stays usable.
+		Alepha::MpmcQueue< int > mpmc{ 8 };
+		test.expect( refusedBatch( mpmc ) == std::vector{ 0, 1 } );
+		test.expect( mpmc.size() == 0 and mpmc.tryPush( 5 ) and mpmc.tryPop() == 5 );
+	};
+
+	"leftovers_destroyed"_test <=[]( TestState test )
+	{
+		const auto tracked= std::make_shared< int >();
+		{
+			Alepha::MpmcQueue< std::shared_ptr< int > > mpmc{ 4 };
+			Alepha::SpscQueue< std::shared_ptr< int > > spsc{ 4 };
+			mpmc.push( std::shared_ptr{ tracked } );
+			spsc.push( std::shared_ptr{ tracked } );
+			test.expect( tracked.use_count() == 3 );
+		}
+		test.expect( tracked.use_count() == 1 );
+	};
+};
@@ -0,0 +1,133 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../BoundedQueue.h"
+
+#include <array>
+#include <deque>
+#include <chrono>
+#include <string>
+#include <iostream>
+
+/*
+ * Handoff throughput from one thread to another: the bounded queues, one item and a batch at a time, against a
+ * `std::deque` under a mutex, which is what stage to stage handoffs have used.
+ */
+
+namespace
+{
+	template< typename Function >
+	double
+	milliseconds( Function function )
+	{
+		const auto start= std::chrono::steady_clock::now();
+		function();
+		const std::chrono::duration< double, std::milli > elapsed= std::chrono::steady_clock::now() - start;
+		return elapsed.count();
+	}
+
+	// The handoff being replaced.
+	class LockedDeque
+	{
+		private:
+			Alepha::Mutex access;
+			Alepha::ConditionVariable changed;
+			std::deque< std::size_t > items;
+			const std::size_t capacity;
+			bool closed= false;
+
+		public:
+			explicit LockedDeque( const std::size_t capacity ) : capacity( capacity ) {}
+
+			void
+			push( std::size_t &&item )
+			{
+				Alepha::unique_lock lock( access );
+				changed.wait( lock, [&]{ return items.size() < capacity; } );
+				items.push_back( item );
+				changed.notify_all();
+			}
+
+			std::optional< std::size_t >
+			pop()
+			{
+				Alepha::unique_lock lock( access );
+				changed.wait( lock, [&]{ return not items.empty() or closed; } );
+				if( items.empty() ) return std::nullopt;
+				const std::size_t rv= items.front();
+				items.pop_front();
+				changed.notify_all();
+				return rv;
+			}
+
+			void
+			close()
+			{
+				Alepha::lock_guard lock( access );
+				closed= true;
+				changed.notify_all();
+			}
+	};
+
+	volatile std::size_t sink;
+
+	template< typename Queue >
+	void
+	single( const std::string &name, const std::size_t count )
+	{
+		Queue queue{ 1024 };
+		const double elapsed= milliseconds( [&]
+		{
+			Alepha::Thread producer{ [&]
+			{
+				for( std::size_t i= 0; i < count; ++i ) queue.push( std::size_t{ i } );
+				queue.close();
+			} };
+			std::size_t total= 0;
+			while( const auto item= queue.pop() ) total+= *item;
+			producer.join();
+			sink= total;
+		} );
+		std::cout << name << ": " << elapsed << " ms, " << count / elapsed / 1000 << " M items/s" << std::endl;
+	}
+
+	template< typename Queue >
+	void
+	batched( const std::string &name, const std::size_t count )
+	{
+		Queue queue{ 1024 };
+		const double elapsed= milliseconds( [&]
+		{
+			Alepha::Thread producer{ [&]
+			{
+				std::array< std::size_t, 64 > batch;
+				for( std::size_t i= 0; i < count; i+= batch.size() )
+				{
+					for( std::size_t j= 0; j < batch.size(); ++j ) batch[ j ]= i + j;
+					queue.push_n( batch.begin(), batch.size() );
+				}
+				queue.close();
+			} };
+			std::size_t total= 0;
+			std::array< std::size_t, 64 > batch;
+			while( const std::size_t taken= queue.pop_n( batch.begin(), batch.size() ) )
+			{
+				for( std::size_t j= 0; j < taken; ++j ) total+= batch[ j ];
+			}
+			producer.join();
+			sink= total;
+		} );
+		std::cout << name << ": " << elapsed << " ms, " << count / elapsed / 1000 << " M items/s" << std::endl;
+	}
+}
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	const std::size_t count= argcnt > 1 ? std::stoul( argvec[ 1 ] ) : 2'000'000;
+
+	single< LockedDeque >( "std::deque under a mutex", count );
+	single< Alepha::SpscQueue< std::size_t > >( "SpscQueue", count );
+	single< Alepha::MpmcQueue< std::size_t > >( "MpmcQueue", count );
+	batched< Alepha::SpscQueue< std::size_t > >( "SpscQueue, batches of 64", count );
+	batched< Alepha::MpmcQueue< std::size_t > >( "MpmcQueue, batches of 64", count );
+}
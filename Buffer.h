@@ -2,6 +2,10 @@ static_assert( __cplusplus > 2020'00 );
 
 #pragma once
 
+#include <cassert>
+#include <cstring>
+
+#include <new>
 #include <vector>
 #include <string>
 #include <array>
@@ -10,12 +14,9 @@ static_assert( __cplusplus > 2020'00 );
 #include <exception>
 #include <stdexcept>
 
-#include <boost/lexical_cast.hpp>
-
 #include "Concepts.h"
-#include "assertion.h"
-#include "Capabilities.h"
-#include "lifetime.h"
+#include "Constness.h"
+#include "stringify.h"
 
 
 namespace Alepha::inline Cavorite  ::detail::  buffer
@@ -42,10 +43,10 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 					: baseAddress( address ), requestedSize( requestedSize ), availableSize( availableSize )
 				{}
 
-			public
+			public:
 				const void *getAddress() const noexcept { return baseAddress; }
-				const std::size_t getRequestedSize() const noexcept { return requestedSize; }
-				const std::size_t getAvailableSize() const noexcept { return availableSize; }
+				std::size_t getRequestedSize() const noexcept { return requestedSize; }
+				std::size_t getAvailableSize() const noexcept { return availableSize; }
 		};
 
 		inline OutOfRangeError::~OutOfRangeError()= default;
@@ -62,29 +63,29 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 					: std::out_of_range( "Tried to access an object of type "s + type.name() + " which is " + stringify( requestedSize ) + " bytes in size.  "
 							+ "The request was at location " + stringify( location ) + " which only has " + stringify( availableSize )
 							+ " bytes allocated" ),
-					OutOfRangeError( location, requestedSIze, availableSize ),
+					OutOfRangeError( location, requestedSize, availableSize ),
 					typeID( type )
 				{}
 		};
 
 		class OutOfRangeSizeError
-			: virtual public OutOfRangeException
+			: virtual public OutOfRangeError
 		{
 			public:
 				explicit
-				OutOfRangeSizeException( const void *const location, const std::ptrdiff_t requestedOffset, const std::size_t availableSpace )
+				OutOfRangeSizeError( const void *const location, const std::size_t requestedOffset, const std::size_t availableSpace )
 					: std::out_of_range( "Tried to view a byte offset of " + stringify( requestedOffset ) + " into location " + stringify( location )
 							+ " which is " + stringify( availableSpace ) + " bytes in size." ),
-					OutOfRangeException( location, requestedOffset, availableSpace )
+					OutOfRangeError( location, requestedOffset, availableSpace )
 				{}
 		};
 
 		template< Constness constness > class Buffer;
 		template< typename Derived > class BufferModel;
 
-		constexpr Buffer< Mutable > copyData( Buffer< Mutable > destination, Buffer< Const > source );
+		Buffer< Mutable > copyData( Buffer< Mutable > destination, Buffer< Const > source );
 
-		constexpr void zeroData( Buffer< Mutable > buffer ) noexcept;
+		void zeroData( Buffer< Mutable > buffer ) noexcept;
 	}
 
 	template< Constness constness >
@@ -106,26 +107,27 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 
 			constexpr
 			Buffer( const pointer_type ptr, const std::size_t bytes ) noexcept
-				: ptr( static_cast< byte_pointer_type >( ptr ), bytes( bytes )
+				: ptr( static_cast< byte_pointer_type >( ptr ) ), bytes( bytes )
 			{}
 
-			constexpr
-			Buffer( const Buffer< Mutable > &copy ) noexcept
-				: ptr( copy.byte_data() ), bytes( copy.size() ) {}
+			constexpr Buffer( const Buffer & ) noexcept= default;
+			constexpr Buffer &operator= ( const Buffer & ) noexcept= default;
 
+			// A mutable view can always be viewed read-only.  (Never the other way around.)
 			constexpr
-			Buffer( const Buffer< Const > &copy ) noexcept requires( Constness == Mutable )= delete;
+			Buffer( const Buffer< Mutable > &copy ) noexcept requires( constness == Const )
+				: ptr( copy.byte_data() ), bytes( copy.size() ) {}
 
 
 			constexpr byte_pointer_type byte_data() const noexcept { return ptr; }
 			constexpr pointer_type data() const noexcept { return ptr; }
 
-			constexpr const_byte_pointer_type byte_data() const noexcept { return ptr; }
-			constexpr const_pointer_type data() const noexcept { return ptr; }
-
 			constexpr std::size_t size() const noexcept { return bytes; }
 			constexpr bool empty() const noexcept { return size() == 0; }
 
+			constexpr byte_pointer_type begin() const noexcept { return ptr; }
+			constexpr byte_pointer_type end() const noexcept { return ptr + bytes; }
+
 			constexpr const_byte_pointer_type cbegin() const noexcept { return begin(); }
 			constexpr const_byte_pointer_type cend() const noexcept { return end(); }
 
@@ -133,31 +135,31 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 			template< typename T > void operator[]( T )= delete;
 
 			template< typename T >
-			constexpr std::add_lvalue_reference_t< maybe_const_t< T, constness > >
+			maybe_const_t< T &, constness >
 			as( std::nothrow_t ) const noexcept
 			{
-				assertion( sizeof( T ) <= bytes );
-				return *start_lifetime_as< std::add_lvalue_reference_t< maybe_const_t< T, constness > > >( ptr );
+				assert( sizeof( T ) <= bytes );
+				return *std::launder( reinterpret_cast< maybe_const_t< T *, constness > >( ptr ) );
 			}
 
 			template< typename T >
-			constexpr maybe_const_t< T &, constness >
+			maybe_const_t< T &, constness >
 			as() const
 			{
 				if( sizeof( T ) > bytes ) throw InsufficientSizeError{ ptr, sizeof( T ), bytes, typeid( T ) };
-				return this->as< std::add_lvalue_reference_t< maybe_const_t< T, constness > > >( std::nothrow );
+				return this->as< T >( std::nothrow );
 			}
 
 			template< typename T >
-			constexpr std::add_lvalue_reference_t< std::add_const_t< T & > >
+			const T &
 			const_as( std::nothrow_t ) const noexcept
 			{
-				assertion( sizeof( T ) <= bytes );
-				return *start_lifetime_as< std::add_const_t< T > >( ptr );
+				assert( sizeof( T ) <= bytes );
+				return *std::launder( reinterpret_cast< const T * >( ptr ) );
 			}
 
 			template< typename T >
-			constexpr std::add_lvalue_reference_t< std::add_const_t< T > >
+			const T &
 			const_as() const
 			{
 				if( sizeof( T ) > bytes ) throw InsufficientSizeError{ ptr, sizeof( T ), bytes, typeid( const T ) };
@@ -222,7 +224,7 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 	struct BufferModel_capability {};
 
 	template< typename T >
-	concept UndecayedBufferModelable= HasCapability< T, BufferModel_capability >;
+	concept UndecayedBufferModelable= HasBase< std::remove_const_t< T >, BufferModel_capability >;
 
 	template< typename T >
 	concept BufferModelable= UndecayedBufferModelable< std::decay_t< T > >;
@@ -234,15 +236,15 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 			constexpr auto &crtp() noexcept { return static_cast< Derived & >( *this ); }
 			constexpr const auto &crtp() const noexcept { return static_cast< const Derived & >( *this ); }
 
-			constexpr auto &buffer() { return static_cast< Buffer< Mutable > >( crtp() ); }
-			constexpr const auto &buffer() const { return static_cast< Buffer< Const > >( crtp() ); }
+			constexpr Buffer< Mutable > buffer() { return static_cast< Buffer< Mutable > >( crtp() ); }
+			constexpr Buffer< Const > buffer() const { return static_cast< Buffer< Const > >( crtp() ); }
 
 		public:
 			constexpr auto byte_data() { return buffer().byte_data(); }
-			constexpr const auto byte_data() const { return buffer().byte_data(); }
+			constexpr auto byte_data() const { return buffer().byte_data(); }
 
 			constexpr auto data() { return buffer().data(); }
-			constexpr const auto data() const { return buffer().data(); }
+			constexpr auto data() const { return buffer().data(); }
 
 			constexpr decltype( auto ) cbegin() const { return buffer().cbegin(); }
 			constexpr decltype( auto ) cend() const { return buffer().cend(); }
@@ -270,11 +272,9 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 			template< typename T > constexpr decltype( auto ) const_as() { return buffer().template const_as< T >(); }
 	};
 
+	// `BufferModel` types are as mutable as they are themselves.
 	template< typename T >
-	extern Constness constness_of_v;
-
-	template< UndecayedBufferModelble T >
-	constexpr Constness constness_of_v= std::is_const_v< T >;
+	constexpr Constness constness_of_v= std::is_const_v< T > ? Const : Mutable;
 
 	template< Constness constness >
 	constexpr Constness constness_of_v< Buffer< constness > >{ constness };
@@ -283,7 +283,7 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 	constexpr auto
 	operator + ( const Buffer< constness > buffer, const std::size_t offset )
 	{
-		if( offset > buffer.size() ) throw OutOfRangeError{ buffer.data(), offset, buffer.size() };
+		if( offset > buffer.size() ) throw OutOfRangeSizeError{ buffer.data(), offset, buffer.size() };
 		return Buffer< constness >{ buffer.byte_data() + offset, buffer.size() - offset };
 	}
 
@@ -310,18 +310,18 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 	}
 
 	constexpr Buffer< Mutable >
-	make_buffer( Concepts::StandardLayoutAggregate auto &aggregate ) noexcept
+	make_buffer( StandardLayoutAggregate auto &aggregate ) noexcept
 	{
 		return { &aggregate, sizeof( aggregate ) };
 	}
 
 	constexpr Buffer< Const >
-	make_buffer( const Concepts::StandardLayoutAggregate auto &aggregate ) noexcept
+	make_buffer( const StandardLayoutAggregate auto &aggregate ) noexcept
 	{
 		return { &aggregate, sizeof( aggregate ) };
 	}
 
-	template< Concepts::StandardLayout T >
+	template< StandardLayout T >
 	constexpr Buffer< Mutable >
 	make_buffer( std::vector< T > &vector ) noexcept
 	{
@@ -329,7 +329,7 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 		return { vector.data(), vector.size() * sizeof( T ) };
 	}
 
-	template< Concepts::StandardLayout T >
+	template< StandardLayout T >
 	constexpr Buffer< Const >
 	make_buffer( const std::vector< T > &vector ) noexcept
 	{
@@ -338,7 +338,7 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 	}
 
 
-	template< Concepts::StandardLayout T, std::size_t size >
+	template< StandardLayout T, std::size_t size >
 	constexpr Buffer< Mutable >
 	make_buffer( std::array< T, size > &array ) noexcept
 	{
@@ -346,7 +346,7 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 		return { array.data(), sizeof( array ) };
 	}
 
-	template< Concepts::StandardLayout T, std::size_t size >
+	template< StandardLayout T, std::size_t size >
 	constexpr Buffer< Const >
 	make_buffer( const std::array< T, size > &array ) noexcept
 	{
@@ -355,36 +355,17 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 	}
 
 
-	template< Concepts::StandardLayout T, std::size_t size >
+	template< StandardLayout T, std::size_t size >
 	constexpr Buffer< Mutable >
-	make_buffer( T array[ size ] ) noexcept
+	make_buffer( T ( &array )[ size ] ) noexcept
 	{
-		// TODO: Do we need to consider overflow here?
 		return { array, sizeof( array ) };
 	}
 
-	template< Concepts::StandardLayout T, std::size_t size >
+	template< StandardLayout T, std::size_t size >
 	constexpr Buffer< Const >
-	make_buffer( const T array[ size ] ) noexcept
+	make_buffer( const T ( &array )[ size ] ) noexcept
 	{
-		// TODO: Do we need to consider overflow here?
-		return { array, sizeof( array ) };
-	}
-
-
-	template< Concepts::StandardLayout T, std::size_t size >
-	constexpr Buffer< Mutable >
-	make_buffer( T array[ size ] ) noexcept
-	{
-		// TODO: Do we need to consider overflow here?
-		return { array, sizeof( array ) };
-	}
-
-	template< Concepts::StandardLayout T, std::size_t size >
-	constexpr Buffer< Const >
-	make_buffer( const T array[ size ] ) noexcept
-	{
-		// TODO: Do we need to consider overflow here?
 		return { array, sizeof( array ) };
 	}
 
@@ -402,7 +383,7 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 	}
 
 
-	constexpr Buffer< Mutable >
+	inline Buffer< Mutable >
 	exports::copyData( const Buffer< Mutable > destination, const Buffer< Const > source )
 	{
 		if( source.size() > destination.size() ) throw InsufficientSizeError{ destination.data(), source.size(), destination.size(), typeid( std::byte ) };
@@ -411,7 +392,7 @@ namespace Alepha::inline Cavorite  ::detail::  buffer
 		return { destination, source.size() };
 	}
 
-	constexpr void
+	inline void
 	exports::zeroData( const Buffer< Mutable > buffer ) noexcept
 	{
 		::memset( buffer, 0, buffer.size() );
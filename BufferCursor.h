@@ -0,0 +1,429 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#include <bit>
+#include <algorithm>
+#include <span>
+#include <string>
+#include <utility>
+#include <optional>
+#include <concepts>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Buffer.h"
+
+namespace Alepha::inline Cavorite  ::detail::  buffer_cursor
+{
+	inline namespace exports
+	{
+		class BufferReader;
+		class BufferWriter;
+		class CursorOverrunError;
+	}
+
+	namespace C
+	{
+		// An unsigned LEB128 varint of a 64-bit value takes at most this many bytes.
+		const std::size_t maximumVarintSize= 10;
+	}
+
+	template< typename T >
+	concept ReadableBytes= requires( const T &t )
+	{
+		{ t.byte_data() } -> std::convertible_to< const std::byte * >;
+		{ t.size() } -> std::convertible_to< std::size_t >;
+	};
+
+	template< typename T >
+	concept WritableBytes= requires( T &t )
+	{
+		{ t.byte_data() } -> std::convertible_to< std::byte * >;
+		{ t.size() } -> std::convertible_to< std::size_t >;
+	};
+
+	template< typename T >
+	concept SegmentedBytes= requires( const T &t )
+	{
+		{ t.chain_view()[ 0 ] } -> ReadableBytes;
+		{ t.chain_view().size() } -> std::convertible_to< std::size_t >;
+	};
+
+	// Values which can be read or written in a given byte order.  Only integers (and enums over them) have a
+	// byte order to speak of; anything else trivially copyable is moved in native order only.
+	template< typename T, std::endian order >
+	concept Encodable= std::is_trivially_copyable_v< T >
+			and ( order == std::endian::native or std::is_integral_v< T > or std::is_enum_v< T > );
+
+	template< typename T >
+	constexpr T
+	byteSwap( const T value ) noexcept
+	{
+		if constexpr( std::is_enum_v< T > ) return T( byteSwap( static_cast< std::underlying_type_t< T > >( value ) ) );
+		else if constexpr( sizeof( T ) == 1 ) return value;
+		else if constexpr( sizeof( T ) == 2 ) return T( __builtin_bswap16( value ) );
+		else if constexpr( sizeof( T ) == 4 ) return T( __builtin_bswap32( value ) );
+		else if constexpr( sizeof( T ) == 8 ) return T( __builtin_bswap64( value ) );
+		else static_assert( sizeof( T ) == 0, "Unsupported integer size." );
+	}
+
+	template< std::endian order, typename T >
+	constexpr T
+	toOrder( const T value ) noexcept
+	{
+		if constexpr( order == std::endian::native ) return value;
+		else return byteSwap( value );
+	}
+
+	/*!
+	 * Thrown by the checked operations of `BufferReader` and `BufferWriter` when there are not enough bytes left.
+	 */
+	class exports::CursorOverrunError
+		: public virtual OutOfRangeError
+	{
+		public:
+			explicit
+			CursorOverrunError( const void *const location, const std::size_t requested, const std::size_t available )
+				: std::out_of_range( "Tried to move a buffer cursor at location " + stringify( location ) + " by "
+						+ stringify( requested ) + " bytes, with only " + stringify( available ) + " bytes left." ),
+				OutOfRangeError( location, requested, available )
+			{}
+	};
+
+	/*!
+	 * A cursor which decodes values from the front of a `Buffer`, `Blob`, or `DataChain`.
+	 *
+	 * Every operation comes in three flavours:
+	 *
+	 *  * `read...`: Checked.  Throws `CursorOverrunError` if too few bytes remain.
+	 *
+	 *  * `tryRead...`: Checked.  Returns an empty `std::optional` (consuming nothing) if too few bytes remain.
+	 *
+	 *  * `get...`: Unchecked.  Call `require` once for a whole group of fixed size fields, then `get` each of
+	 *    them with no further checks.  Reading past the end this way is undefined.
+	 *
+	 * Reads which fall inside one segment of the source are a single `memcpy`.  Reads which straddle `DataChain`
+	 * segments are assembled piecewise.
+	 *
+	 * @note The source must outlive the reader, and must not be modified while the reader is in use.
+	 */
+	class exports::BufferReader
+	{
+		private:
+			using Window= std::pair< const std::byte *, std::size_t >;
+
+			// The contiguous window being read from.
+			const std::byte *cursor= nullptr;
+			const std::byte *limit= nullptr;
+
+			// The bytes left in total, including the current window.
+			std::size_t remainingBytes= 0;
+
+			// For segmented sources, how to find the following windows.
+			const void *source= nullptr;
+			Window ( *segment )( const void *, std::size_t )= nullptr;
+			std::size_t nextSegment= 0;
+
+			void
+			nextWindow() noexcept
+			{
+				while( cursor == limit and remainingBytes )
+				{
+					const auto [ data, size ]= segment( source, nextSegment++ );
+					cursor= data;
+					limit= data + size;
+				}
+			}
+
+			void
+			consume( const std::size_t amount ) noexcept
+			{
+				cursor+= amount;
+				remainingBytes-= amount;
+				if( cursor == limit ) [[unlikely]] nextWindow();
+			}
+
+			// Copy out `amount` bytes, which must remain, across as many windows as it takes.
+			void
+			copyOut( std::byte *destination, std::size_t amount ) noexcept
+			{
+				while( amount )
+				{
+					const std::size_t piece= std::min< std::size_t >( amount, limit - cursor );
+					std::memcpy( destination, cursor, piece );
+					destination+= piece;
+					amount-= piece;
+					consume( piece );
+				}
+			}
+
+		public:
+			BufferReader() noexcept= default;
+
+			explicit
+			BufferReader( const std::byte *const data, const std::size_t size ) noexcept
+				: cursor( data ), limit( data + size ), remainingBytes( size )
+			{}
+
+			template< ReadableBytes Bytes >
+			explicit
+			BufferReader( const Bytes &bytes ) noexcept
+				: BufferReader( bytes.byte_data(), bytes.size() )
+			{}
+
+			template< SegmentedBytes Segments >
+			explicit
+			BufferReader( const Segments &segments ) noexcept
+				: source( &segments ),
+				segment( []( const void *const source, const std::size_t index ) -> Window
+				{
+					const auto &piece= static_cast< const Segments * >( source )->chain_view()[ index ];
+					return { piece.byte_data(), piece.size() };
+				})
+			{
+				if constexpr( requires { segments.size(); } ) remainingBytes= segments.size();
+				else for( const auto &piece: segments.chain_view() ) remainingBytes+= piece.size();
+				nextWindow();
+			}
+
+			std::size_t remaining() const noexcept { return remainingBytes; }
+			bool exhausted() const noexcept { return remainingBytes == 0; }
+
+			/*!
+			 * Whether at least `amount` bytes remain.  After this returns `true`, that many bytes can be taken with
+			 * the unchecked `get` operations.
+			 */
+			[[nodiscard]] bool require( const std::size_t amount ) const noexcept { return remainingBytes >= amount; }
+
+			template< typename T, std::endian order= std::endian::native >
+			requires Encodable< T, order >
+			T
+			get() noexcept
+			{
+				T rv;
+				if( static_cast< std::size_t >( limit - cursor ) >= sizeof( T ) ) [[likely]]
+				{
+					std::memcpy( &rv, cursor, sizeof( T ) );
+					consume( sizeof( T ) );
+				}
+				else copyOut( reinterpret_cast< std::byte * >( &rv ), sizeof( T ) );
+				return toOrder< order >( rv );
+			}
+
+			template< typename T, std::endian order= std::endian::native >
+			requires Encodable< T, order >
+			T
+			read()
+			{
+				if( not require( sizeof( T ) ) ) throw CursorOverrunError( cursor, sizeof( T ), remainingBytes );
+				return get< T, order >();
+			}
+
+			template< typename T, std::endian order= std::endian::native >
+			requires Encodable< T, order >
+			std::optional< T >
+			tryRead() noexcept
+			{
+				if( not require( sizeof( T ) ) ) return std::nullopt;
+				return get< T, order >();
+			}
+
+			void
+			getBytes( std::byte *const destination, const std::size_t amount ) noexcept
+			{
+				copyOut( destination, amount );
+			}
+
+			void
+			readBytes( std::byte *const destination, const std::size_t amount )
+			{
+				if( not require( amount ) ) throw CursorOverrunError( cursor, amount, remainingBytes );
+				copyOut( destination, amount );
+			}
+
+			void
+			skip( std::size_t amount )
+			{
+				if( not require( amount ) ) throw CursorOverrunError( cursor, amount, remainingBytes );
+				while( amount )
+				{
+					const std::size_t piece= std::min< std::size_t >( amount, limit - cursor );
+					amount-= piece;
+					consume( piece );
+				}
+			}
+
+			/*!
+			 * Read an unsigned LEB128 varint.
+			 *
+			 * @return The value, or nothing (consuming nothing) if the input ends mid-varint or the varint does not
+			 * fit in 64 bits.
+			 */
+			std::optional< std::uint64_t >
+			tryReadVarint() noexcept
+			{
+				const BufferReader saved= *this;
+				std::uint64_t rv= 0;
+				for( std::size_t index= 0; index < C::maximumVarintSize and remainingBytes; ++index )
+				{
+					const auto byte= std::to_integer< std::uint64_t >( get< std::byte >() );
+					if( index == C::maximumVarintSize - 1 and byte > 1 ) break;
+					rv|= ( byte & 0x7F ) << ( 7 * index );
+					if( not ( byte & 0x80 ) ) return rv;
+				}
+				*this= saved;
+				return std::nullopt;
+			}
+
+			std::uint64_t
+			readVarint()
+			{
+				if( const auto rv= tryReadVarint() ) return *rv;
+				throw CursorOverrunError( cursor, C::maximumVarintSize, remainingBytes );
+			}
+
+			/*!
+			 * View the next `count` values of type `T` in place, without copying.
+			 *
+			 * This is only possible when the bytes lie inside one segment and are suitably aligned for `T`.  When
+			 * they are not (or too few bytes remain), nothing is consumed and nothing is returned -- check
+			 * `require` to tell the cases apart, and fall back to reading the values one at a time.
+			 */
+			template< typename T >
+			requires std::is_trivially_copyable_v< T >
+			std::optional< std::span< const T > >
+			readSpan( const std::size_t count ) noexcept
+			{
+				if( count == 0 ) return std::span< const T >{};
+				// Divide rather than multiply, so that a huge `count` cannot wrap around.
+				if( count > static_cast< std::size_t >( limit - cursor ) / sizeof( T ) ) return std::nullopt;
+				const std::size_t amount= count * sizeof( T );
+				if( reinterpret_cast< std::uintptr_t >( cursor ) % alignof( T ) ) return std::nullopt;
+
+				const std::span< const T > rv{ reinterpret_cast< const T * >( cursor ), count };
+				consume( amount );
+				return rv;
+			}
+	};
+
+	/*!
+	 * A cursor which encodes values into a `Buffer` or `Blob`, front to back.
+	 *
+	 * Operations follow the same pattern as `BufferReader`: `write...` throws `CursorOverrunError`, `tryWrite...`
+	 * returns `false`, and `put...` is unchecked after a `require`.
+	 */
+	class exports::BufferWriter
+	{
+		private:
+			std::byte *first= nullptr;
+			std::byte *cursor= nullptr;
+			std::byte *limit= nullptr;
+
+		public:
+			BufferWriter() noexcept= default;
+
+			explicit
+			BufferWriter( std::byte *const data, const std::size_t size ) noexcept
+				: first( data ), cursor( data ), limit( data + size )
+			{}
+
+			template< WritableBytes Bytes >
+			explicit
+			BufferWriter( Bytes &bytes ) noexcept
+				: BufferWriter( bytes.byte_data(), bytes.size() )
+			{}
+
+			std::size_t remaining() const noexcept { return limit - cursor; }
+			std::size_t written() const noexcept { return cursor - first; }
+
+			[[nodiscard]] bool require( const std::size_t amount ) const noexcept { return remaining() >= amount; }
+
+			template< typename T, std::endian order= std::endian::native >
+			requires Encodable< T, order >
+			void
+			put( const T value ) noexcept
+			{
+				const T encoded= toOrder< order >( value );
+				std::memcpy( cursor, &encoded, sizeof( T ) );
+				cursor+= sizeof( T );
+			}
+
+			template< typename T, std::endian order= std::endian::native >
+			requires Encodable< T, order >
+			void
+			write( const T value )
+			{
+				if( not require( sizeof( T ) ) ) throw CursorOverrunError( cursor, sizeof( T ), remaining() );
+				put< T, order >( value );
+			}
+
+			template< typename T, std::endian order= std::endian::native >
+			requires Encodable< T, order >
+			[[nodiscard]] bool
+			tryWrite( const T value ) noexcept
+			{
+				if( not require( sizeof( T ) ) ) return false;
+				put< T, order >( value );
+				return true;
+			}
+
+			void
+			putBytes( const std::byte *const data, const std::size_t amount ) noexcept
+			{
+				std::memcpy( cursor, data, amount );
+				cursor+= amount;
+			}
+
+			void
+			writeBytes( const std::byte *const data, const std::size_t amount )
+			{
+				if( not require( amount ) ) throw CursorOverrunError( cursor, amount, remaining() );
+				putBytes( data, amount );
+			}
+
+			/*!
+			 * The number of bytes `value` takes as an unsigned LEB128 varint.
+			 */
+			static constexpr std::size_t
+			varintSize( const std::uint64_t value ) noexcept
+			{
+				return value ? ( std::bit_width( value ) + 6 ) / 7 : 1;
+			}
+
+			void
+			putVarint( std::uint64_t value ) noexcept
+			{
+				while( value >= 0x80 )
+				{
+					*cursor++= std::byte( value | 0x80 );
+					value>>= 7;
+				}
+				*cursor++= std::byte( value );
+			}
+
+			void
+			writeVarint( const std::uint64_t value )
+			{
+				if( not require( varintSize( value ) ) ) throw CursorOverrunError( cursor, varintSize( value ), remaining() );
+				putVarint( value );
+			}
+
+			[[nodiscard]] bool
+			tryWriteVarint( const std::uint64_t value ) noexcept
+			{
+				if( not require( varintSize( value ) ) ) return false;
+				putVarint( value );
+				return true;
+			}
+	};
+}
+
+namespace Alepha::Cavorite::inline exports::inline buffer_cursor
+{
+	using namespace detail::buffer_cursor::exports;
+}
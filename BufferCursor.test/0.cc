@@ -0,0 +1,175 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../BufferCursor.h"
+
+#include <deque>
+#include <array>
+#include <vector>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	// Stand-ins with the shapes of `Buffer` and `DataChain`.
+	struct Bytes
+	{
+		std::vector< std::byte > data;
+
+		std::byte *byte_data() { return data.data(); }
+		const std::byte *byte_data() const { return data.data(); }
+		std::size_t size() const { return data.size(); }
+	};
+
+	struct Chain
+	{
+		std::deque< Bytes > segments;
+
+		const auto &chain_view() const { return segments; }
+	};
+
+	// Split `bytes` into segments of the given sizes, with the remainder in a last segment.
+	Chain
+	split( const Bytes &bytes, const std::vector< std::size_t > &sizes )
+	{
+		Chain rv;
+		auto from= begin( bytes.data );
+		for( const auto size: sizes )
+		{
+			rv.segments.push_back( { { from, from + size } } );
+			from+= size;
+		}
+		rv.segments.push_back( { { from, end( bytes.data ) } } );
+		return rv;
+	}
+
+	enum class Kind : std::uint16_t { Ping= 0x0102, Pong= 0x0304 };
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+	using std::endian;
+
+	"endian_round_trip"_test <=[]( TestState test )
+	{
+		Bytes bytes{ std::vector< std::byte >( 32 ) };
+		Alepha::BufferWriter writer{ bytes };
+		writer.write< std::uint32_t, endian::big >( 0x0102'0304 );
+		writer.write< std::uint32_t, endian::little >( 0x0102'0304 );
+		writer.write< Kind, endian::big >( Kind::Pong );
+		writer.write< double >( 2.5 );
+		test.expect( writer.written() == 18 );
+
+		test.expect( bytes.data[ 0 ] == std::byte{ 1 } and bytes.data[ 3 ] == std::byte{ 4 } );
+		test.expect( bytes.data[ 4 ] == std::byte{ 4 } and bytes.data[ 7 ] == std::byte{ 1 } );
+
+		Alepha::BufferReader reader{ bytes };
+		test.expect( reader.read< std::uint32_t, endian::big >() == 0x0102'0304 );
+		test.expect( reader.read< std::uint32_t, endian::little >() == 0x0102'0304 );
+		test.expect( reader.read< Kind, endian::big >() == Kind::Pong );
+		test.expect( reader.read< double >() == 2.5 );
+		test.expect( reader.remaining() == 14 );
+	};
+
+	"batched_checks"_test <=[]( TestState test )
+	{
+		Bytes bytes{ std::vector< std::byte >( 6 ) };
+		Alepha::BufferWriter writer{ bytes };
+		test.expect( writer.require( 6 ) );
+		writer.put< std::uint16_t >( 7 );
+		writer.put< std::uint32_t >( 9 );
+		test.expect( not writer.tryWrite< std::uint8_t >( 1 ) );
+
+		Alepha::BufferReader reader{ bytes };
+		test.expect( reader.require( 6 ) and not reader.require( 7 ) );
+		test.expect( reader.get< std::uint16_t >() == 7 );
+		test.expect( reader.get< std::uint32_t >() == 9 );
+		test.expect( reader.exhausted() );
+		test.expect( not reader.tryRead< std::uint8_t >() );
+
+		bool threw= false;
+		try { reader.read< std::uint8_t >(); }
+		catch( const Alepha::CursorOverrunError &error )
+		{
+			threw= error.getRequestedSize() == 1 and error.getAvailableSize() == 0
+					and error.getAddress() == bytes.byte_data() + 6;
+		}
+		test.expect( threw );
+	};
+
+	"varints"_test <=[]( TestState test )
+	{
+		const std::uint64_t values[]= { 0, 1, 127, 128, 300, 16384, 0xFFFF'FFFF, ~std::uint64_t{} };
+		Bytes bytes{ std::vector< std::byte >( 64 ) };
+		Alepha::BufferWriter writer{ bytes };
+		std::size_t expected= 0;
+		for( const auto value: values )
+		{
+			writer.writeVarint( value );
+			expected+= Alepha::BufferWriter::varintSize( value );
+		}
+		test.expect( writer.written() == expected );
+		test.expect( Alepha::BufferWriter::varintSize( ~std::uint64_t{} ) == 10 );
+
+		Alepha::BufferReader reader{ bytes.data.data(), writer.written() };
+		for( const auto value: values ) test.expect( reader.readVarint() == value );
+
+		// A truncated varint consumes nothing.
+		const std::byte truncated[]= { std::byte{ 0x80 }, std::byte{ 0x80 } };
+		Alepha::BufferReader partial{ truncated, 2 };
+		test.expect( not partial.tryReadVarint() );
+		test.expect( partial.remaining() == 2 );
+	};
+
+	"segmented_reads"_test <=[]( TestState test )
+	{
+		Bytes bytes{ std::vector< std::byte >( 40 ) };
+		Alepha::BufferWriter writer{ bytes };
+		for( std::uint64_t i= 0; i < 5; ++i ) writer.write< std::uint64_t, endian::big >( i * 0x0101'0101'0101'0101 );
+
+		for( const auto &sizes: std::vector< std::vector< std::size_t > >{ { 1 }, { 3, 0, 9 }, { 7, 1, 1, 1, 1, 20 }, { 40 } } )
+		{
+			const Chain chain= split( bytes, sizes );
+			Alepha::BufferReader reader{ chain };
+			test.expect( reader.remaining() == 40 );
+			for( std::uint64_t i= 0; i < 5; ++i ) test.expect( reader.read< std::uint64_t, endian::big >() == i * 0x0101'0101'0101'0101 );
+			test.expect( reader.exhausted() );
+		}
+
+		const Chain chain= split( bytes, { 3 } );
+		Alepha::BufferReader reader{ chain };
+		reader.skip( 5 );
+		std::array< std::byte, 6 > out;
+		reader.readBytes( out.data(), out.size() );
+		test.expect( out[ 0 ] == bytes.data[ 5 ] and out[ 5 ] == bytes.data[ 10 ] );
+	};
+
+	"spans"_test <=[]( TestState test )
+	{
+		alignas( 8 ) std::array< std::byte, 24 > storage{};
+		for( std::size_t i= 0; i < 3; ++i ) Alepha::BufferWriter{ storage.data() + 8 * i, 8 }.put< std::uint64_t >( i + 10 );
+
+		Alepha::BufferReader reader{ storage.data(), storage.size() };
+		const auto span= reader.readSpan< std::uint64_t >( 2 );
+		test.expect( span and span->size() == 2 and ( *span )[ 1 ] == 11 );
+		test.expect( not reader.readSpan< std::uint64_t >( 2 ) );
+		test.expect( reader.remaining() == 8 );
+
+		Alepha::BufferReader misaligned{ storage.data() + 1, storage.size() - 1 };
+		test.expect( not misaligned.readSpan< std::uint64_t >( 1 ) );
+		test.expect( misaligned.remaining() == 23 );
+
+		// A count whose size in bytes wraps around to something small must still be refused.
+		Alepha::BufferReader huge{ storage.data(), storage.size() };
+		test.expect( not huge.readSpan< std::uint64_t >( SIZE_MAX / sizeof( std::uint64_t ) + 1 ) );
+		test.expect( huge.remaining() == 24 );
+	};
+};
@@ -0,0 +1,86 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstddef>
+
+namespace Alepha::inline Cavorite  ::detail::  byte_allocator
+{
+	inline namespace exports
+	{
+		class ByteAllocator;
+		class NewArrayAllocator;
+	}
+
+	/*!
+	 * Interface for the raw storage providers used by `Blob` objects.
+	 *
+	 * A `ByteAllocator` hands out untyped, uninitialized blocks of bytes.  The size of a block is always passed
+	 * back on deallocation, so implementations are free to keep no per-block bookkeeping at all.  (This is what
+	 * lets size-classed pools work without a header in front of every block.)
+	 *
+	 * Implementations must be threadsafe: a block may be allocated on one thread and returned on another.
+	 */
+	class exports::ByteAllocator
+	{
+		public:
+			virtual ~ByteAllocator()= default;
+
+			/*!
+			 * Obtain a block of at least `amount` bytes, aligned at least as strictly as `std::max_align_t`.
+			 *
+			 * @note The contents of the returned block are unspecified.
+			 */
+			[[nodiscard]] virtual std::byte *allocate( std::size_t amount )= 0;
+
+			/*!
+			 * Release a block previously obtained from `allocate` on this same allocator.
+			 *
+			 * @param block The block to release.
+			 * @param amount The same size that was requested when `block` was allocated.
+			 */
+			virtual void deallocate( std::byte *block, std::size_t amount ) noexcept= 0;
+	};
+
+	/*!
+	 * The classic `Blob` allocation path: every block is a fresh `new std::byte[]`.
+	 */
+	class exports::NewArrayAllocator
+		: public ByteAllocator
+	{
+		public:
+			[[nodiscard]] std::byte *allocate( const std::size_t amount ) override { return new std::byte[ amount ]; }
+			void deallocate( std::byte *const block, std::size_t ) noexcept override { delete [] block; }
+
+			static NewArrayAllocator &
+			instance() noexcept
+			{
+				static NewArrayAllocator rv;
+				return rv;
+			}
+	};
+
+	// The default is `new[]`, but any `ByteAllocator` will do.
+	inline ByteAllocator *defaultAllocator= &NewArrayAllocator::instance();
+
+	namespace exports
+	{
+		/*!
+		 * Returns the allocator used by `Blob` objects which were not given one explicitly.
+		 */
+		inline ByteAllocator &getDefaultAllocator() noexcept { return *defaultAllocator; }
+
+		/*!
+		 * Select the process-wide allocator for `Blob` objects.
+		 *
+		 * Not threadsafe.  Set in or before main, before starting any threads.  The allocator must outlive every
+		 * `Blob` which it allocates.
+		 */
+		inline void setDefaultAllocator( ByteAllocator &allocator ) noexcept { defaultAllocator= &allocator; }
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline byte_allocator
+{
+	using namespace detail::byte_allocator::exports;
+}
@@ -0,0 +1,133 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstring>
+#include <cstddef>
+
+#include <array>
+#include <bit>
+#include <initializer_list>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+namespace Alepha::inline Cavorite  ::detail::  byte_search
+{
+	inline namespace exports
+	{
+		class ByteSet;
+
+		const std::byte *findByte( const std::byte *first, const std::byte *last, std::byte value ) noexcept;
+		const std::byte *findAnyByte( const std::byte *first, const std::byte *last, const ByteSet &set ) noexcept;
+		const std::byte *findPattern( const std::byte *first, const std::byte *last,
+				const std::byte *patternFirst, const std::byte *patternLast ) noexcept;
+	}
+
+	namespace C
+	{
+		// Sets with at most this many members are scanned with one vector comparison per member.  Larger sets
+		// fall back to a table lookup per byte.
+		const std::size_t vectorSetLimit= 8;
+	}
+
+	/*!
+	 * A set of byte values, for `findAnyByte`.
+	 */
+	class exports::ByteSet
+	{
+		private:
+			std::array< bool, 256 > table{};
+			std::array< std::byte, C::vectorSetLimit > members{};
+			std::size_t count= 0;
+
+			friend const std::byte *exports::findAnyByte( const std::byte *, const std::byte *, const ByteSet & ) noexcept;
+
+		public:
+			constexpr ByteSet() noexcept= default;
+
+			constexpr
+			ByteSet( const std::byte *first, const std::byte *const last ) noexcept
+			{
+				while( first != last ) insert( *first++ );
+			}
+
+			constexpr ByteSet( const std::initializer_list< std::byte > values ) noexcept : ByteSet( values.begin(), values.end() ) {}
+
+			constexpr void
+			insert( const std::byte value ) noexcept
+			{
+				if( table[ std::to_integer< unsigned char >( value ) ] ) return;
+				table[ std::to_integer< unsigned char >( value ) ]= true;
+				if( count < C::vectorSetLimit ) members[ count ]= value;
+				++count;
+			}
+
+			constexpr bool contains( const std::byte value ) const noexcept { return table[ std::to_integer< unsigned char >( value ) ]; }
+			constexpr std::size_t size() const noexcept { return count; }
+	};
+
+	/*!
+	 * Find the first byte equal to `value` in `[first, last)`, or `last` if there is none.
+	 *
+	 * This is `memchr`, which the C library vectorizes.
+	 */
+	inline const std::byte *
+	exports::findByte( const std::byte *const first, const std::byte *const last, const std::byte value ) noexcept
+	{
+		if( first == last ) return last;
+		const void *const found= std::memchr( first, std::to_integer< unsigned char >( value ), last - first );
+		return found ? static_cast< const std::byte * >( found ) : last;
+	}
+
+	/*!
+	 * Find the first byte in `[first, last)` which is a member of `set`, or `last` if there is none.
+	 *
+	 * Small sets are scanned 16 bytes at a time where SSE2 is available.
+	 */
+	inline const std::byte *
+	exports::findAnyByte( const std::byte *first, const std::byte *const last, const ByteSet &set ) noexcept
+	{
+		if( set.count == 0 ) return last;
+		if( set.count == 1 ) return findByte( first, last, set.members[ 0 ] );
+
+#if defined( __SSE2__ )
+		if( set.count <= C::vectorSetLimit )
+		{
+			__m128i needles[ C::vectorSetLimit ];
+			for( std::size_t i= 0; i < set.count; ++i ) needles[ i ]= _mm_set1_epi8( std::to_integer< char >( set.members[ i ] ) );
+
+			for( ; last - first >= 16; first+= 16 )
+			{
+				const __m128i chunk= _mm_loadu_si128( reinterpret_cast< const __m128i * >( first ) );
+				__m128i hits= _mm_cmpeq_epi8( chunk, needles[ 0 ] );
+				for( std::size_t i= 1; i < set.count; ++i ) hits= _mm_or_si128( hits, _mm_cmpeq_epi8( chunk, needles[ i ] ) );
+				if( const unsigned mask= _mm_movemask_epi8( hits ) ) return first + std::countr_zero( mask );
+			}
+		}
+#endif
+
+		for( ; first != last; ++first ) if( set.contains( *first ) ) return first;
+		return last;
+	}
+
+	/*!
+	 * Find the first occurrence of the pattern `[patternFirst, patternLast)` in `[first, last)`, or `last` if
+	 * there is none.  An empty pattern matches at `first`.
+	 */
+	inline const std::byte *
+	exports::findPattern( const std::byte *const first, const std::byte *const last,
+			const std::byte *const patternFirst, const std::byte *const patternLast ) noexcept
+	{
+		if( patternFirst == patternLast ) return first;
+		if( last - first < patternLast - patternFirst ) return last;
+		const void *const found= ::memmem( first, last - first, patternFirst, patternLast - patternFirst );
+		return found ? static_cast< const std::byte * >( found ) : last;
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline byte_search
+{
+	using namespace detail::byte_search::exports;
+}
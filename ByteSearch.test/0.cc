@@ -0,0 +1,74 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../ByteSearch.h"
+
+#include <string>
+#include <algorithm>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	const std::byte *bytes( const std::string &s ) { return reinterpret_cast< const std::byte * >( s.data() ); }
+
+	std::size_t
+	position( const std::string &s, const std::byte *const found )
+	{
+		return found == bytes( s ) + s.size() ? std::string::npos : found - bytes( s );
+	}
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+	using namespace std::literals::string_literals;
+
+	"find_byte"_test <=[]( TestState test )
+	{
+		const std::string text= "the quick brown fox\njumps over\nthe lazy dog";
+		test.expect( position( text, Alepha::findByte( bytes( text ), bytes( text ) + text.size(), std::byte{ '\n' } ) ) == text.find( '\n' ) );
+		test.expect( position( text, Alepha::findByte( bytes( text ), bytes( text ) + text.size(), std::byte{ '!' } ) ) == std::string::npos );
+		test.expect( position( text, Alepha::findByte( bytes( text ), bytes( text ), std::byte{ 't' } ) ) == 0 );
+	};
+
+	"find_any_byte"_test <=[]( TestState test )
+	{
+		// Long enough to exercise the vector loop and the scalar tail, with matches at every alignment.
+		std::string text( 100, 'x' );
+		for( std::size_t at= 0; at < text.size(); ++at )
+		{
+			std::string probe= text;
+			probe[ at ]= ( at % 2 ) ? ';' : ',';
+			const Alepha::ByteSet small{ std::byte{ ',' }, std::byte{ ';' }, std::byte{ '\n' } };
+			test.expect( position( probe, Alepha::findAnyByte( bytes( probe ), bytes( probe ) + probe.size(), small ) ) == at );
+
+			const std::string many= "abcdefghijklmnopqrstuvw,;";
+			const Alepha::ByteSet large{ bytes( many ), bytes( many ) + many.size() };
+			test.expect( large.size() > 8 );
+			test.expect( position( probe, Alepha::findAnyByte( bytes( probe ), bytes( probe ) + probe.size(), large ) ) == at );
+		}
+
+		const Alepha::ByteSet none;
+		test.expect( position( text, Alepha::findAnyByte( bytes( text ), bytes( text ) + text.size(), none ) ) == std::string::npos );
+		const Alepha::ByteSet absent{ std::byte{ 'y' }, std::byte{ 'z' } };
+		test.expect( position( text, Alepha::findAnyByte( bytes( text ), bytes( text ) + text.size(), absent ) ) == std::string::npos );
+	};
+
+	"find_pattern"_test <=[]( TestState test )
+	{
+		const std::string text= "GET / HTTP/1.1\r\nHost: x\r\n\r\nbody";
+		for( const std::string &pattern: { "\r\n\r\n"s, "\r\n"s, "body"s, "GET"s, "missing"s, ""s, text + "!" } )
+		{
+			const auto found= Alepha::findPattern( bytes( text ), bytes( text ) + text.size(), bytes( pattern ), bytes( pattern ) + pattern.size() );
+			test.expect( position( text, found ) == text.find( pattern ) );
+		}
+	};
+};
@@ -0,0 +1,250 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstddef>
+
+#include <ios>
+#include <algorithm>
+#include <utility>
+#include <optional>
+#include <concepts>
+#include <streambuf>
+
+#include "ByteAllocator.h"
+#include "AllocationPolicy.h"
+
+namespace Alepha::inline Cavorite  ::detail::  chain_streambuf
+{
+	template< typename T >
+	concept SegmentedBytes= requires( const T &t )
+	{
+		{ t.chain_view()[ 0 ].byte_data() } -> std::convertible_to< const std::byte * >;
+		{ t.chain_view()[ 0 ].size() } -> std::convertible_to< std::size_t >;
+		{ t.chain_view().size() } -> std::convertible_to< std::size_t >;
+	};
+
+	template< typename Storage >
+	concept CarvableStorage= std::constructible_from< Storage, std::size_t, AllocationPolicy, ByteAllocator & >
+			and std::movable< Storage >
+			and requires( Storage &s, const std::size_t n )
+	{
+		{ s.byte_data() } -> std::convertible_to< std::byte * >;
+		{ s.size() } -> std::convertible_to< std::size_t >;
+		{ s.carveHead( n ) } -> std::same_as< Storage >;
+	};
+
+	template< typename Chain, typename Storage >
+	concept AppendableChain= requires( Chain &chain, Storage &block ) { chain.append( block ); };
+
+	inline namespace exports
+	{
+		template< SegmentedBytes Chain > class ChainInputStreambuf;
+		template< typename Chain, CarvableStorage Storage > requires AppendableChain< Chain, Storage > class ChainOutputStreambuf;
+	}
+
+	namespace C
+	{
+		// The size of each block an output streambuf fills.  As with `DataChain`'s read segments, this leaves room
+		// for the storage header, so that a block fits in a 4 KiB block of a `SlabPool`.
+		const std::size_t outputBlockSize= 4 * 1024 - 256;
+	}
+
+	/*!
+	 * A read-only `std::streambuf` over a `DataChain`, which copies nothing.
+	 *
+	 * The get area is each segment of the chain in turn, so an `std::istream` reads straight out of the chain's
+	 * own storage.  Seeking is supported, by position from the start of the chain.
+	 *
+	 * @note The chain must outlive the streambuf, and must not be changed while it is in use.
+	 */
+	template< SegmentedBytes Chain >
+	class exports::ChainInputStreambuf
+		: public std::streambuf
+	{
+		private:
+			const Chain &chain;
+
+			// The segment after the one in the get area, and where in the chain the get area starts.
+			std::size_t nextSegment= 0;
+			std::size_t segmentStart= 0;
+
+			void
+			load( const std::size_t segment, const std::size_t offset )
+			{
+				const auto &block= chain.chain_view()[ segment ];
+				char *const first= const_cast< char * >( reinterpret_cast< const char * >( block.byte_data() ) );
+				setg( first, first + offset, first + block.size() );
+				nextSegment= segment + 1;
+			}
+
+		protected:
+			int_type
+			underflow() override
+			{
+				if( gptr() == egptr() )
+				{
+					const auto &view= chain.chain_view();
+					segmentStart+= egptr() - eback();
+					while( nextSegment < view.size() and view[ nextSegment ].size() == 0 ) ++nextSegment;
+					if( nextSegment == view.size() ) return traits_type::eof();
+					load( nextSegment, 0 );
+				}
+				return traits_type::to_int_type( *gptr() );
+			}
+
+			std::streamsize
+			showmanyc() override
+			{
+				const auto &view= chain.chain_view();
+				std::streamsize rv= egptr() - gptr();
+				for( std::size_t segment= nextSegment; segment < view.size(); ++segment ) rv+= view[ segment ].size();
+				return rv ? rv : -1;
+			}
+
+			pos_type
+			seekoff( const off_type offset, const std::ios_base::seekdir direction, const std::ios_base::openmode which ) override
+			{
+				if( not ( which & std::ios_base::in ) ) return pos_type( off_type( -1 ) );
+
+				off_type base= 0;
+				if( direction == std::ios_base::cur ) base= segmentStart + ( gptr() - eback() );
+				else if( direction == std::ios_base::end )
+				{
+					for( const auto &block: chain.chain_view() ) base+= block.size();
+				}
+				return seekpos( pos_type( base + offset ), which );
+			}
+
+			pos_type
+			seekpos( const pos_type position, const std::ios_base::openmode which ) override
+			{
+				if( not ( which & std::ios_base::in ) or off_type( position ) < 0 ) return pos_type( off_type( -1 ) );
+
+				const auto &view= chain.chain_view();
+				std::size_t remaining= off_type( position );
+				std::size_t start= 0;
+				for( std::size_t segment= 0; segment < view.size(); ++segment )
+				{
+					const std::size_t size= view[ segment ].size();
+					if( remaining < size )
+					{
+						segmentStart= start;
+						load( segment, remaining );
+						return position;
+					}
+					remaining-= size;
+					start+= size;
+				}
+				if( remaining ) return pos_type( off_type( -1 ) );
+
+				// Exactly the end of the chain.
+				segmentStart= start;
+				nextSegment= view.size();
+				setg( nullptr, nullptr, nullptr );
+				return position;
+			}
+
+		public:
+			explicit ChainInputStreambuf( const Chain &chain ) : chain( chain ) {}
+	};
+
+	/*!
+	 * A write-only `std::streambuf` which appends to a `DataChain`.
+	 *
+	 * The put area is a freshly allocated block (normally a `Blob`).  When it fills, it is appended to the chain
+	 * and a new one is allocated.  Flushing the stream appends only what has been written so far, carved off the
+	 * front of the block; the rest of the block goes on being written into, and the chain stitches the adjacent
+	 * pieces back together as they arrive.  So formatting through an `std::ostream` -- including the filtering
+	 * done by `StartWrap` and `StartSubstitutions` -- builds the chain in place, with no intermediate string.
+	 *
+	 * Everything written is in the chain once the streambuf is flushed or destroyed.
+	 */
+	template< typename Chain, CarvableStorage Storage >
+	requires AppendableChain< Chain, Storage >
+	class exports::ChainOutputStreambuf
+		: public std::streambuf
+	{
+		private:
+			Chain &chain;
+			std::size_t blockSize;
+			ByteAllocator &allocator;
+
+			// The unwritten remainder of the current block, whose start is `pbase()`.
+			std::optional< Storage > block;
+
+			void
+			publish()
+			{
+				if( not block ) return;
+
+				if( const std::size_t written= pptr() - pbase() )
+				{
+					Storage piece= block->carveHead( written );
+					chain.append( piece );
+				}
+
+				if( block->size() == 0 )
+				{
+					block.reset();
+					setp( nullptr, nullptr );
+				}
+				else
+				{
+					char *const first= reinterpret_cast< char * >( block->byte_data() );
+					setp( first, first + block->size() );
+				}
+			}
+
+		protected:
+			int_type
+			overflow( const int_type ch ) override
+			{
+				publish();
+				if( traits_type::eq_int_type( ch, traits_type::eof() ) ) return traits_type::not_eof( ch );
+
+				if( not block )
+				{
+					block.emplace( blockSize, AllocationPolicy::Uninitialized, allocator );
+					char *const first= reinterpret_cast< char * >( block->byte_data() );
+					setp( first, first + block->size() );
+				}
+				*pptr()= traits_type::to_char_type( ch );
+				pbump( 1 );
+				return ch;
+			}
+
+			int
+			sync() override
+			{
+				publish();
+				return 0;
+			}
+
+		public:
+			/*!
+			 * @param chain The chain to append to.
+			 * @param blockSize The size of each block which is allocated to be written into.
+			 * @param allocator Where the blocks come from.
+			 */
+			explicit
+			ChainOutputStreambuf( Chain &chain, const std::size_t blockSize= C::outputBlockSize,
+					ByteAllocator &allocator= getDefaultAllocator() )
+				: chain( chain ), blockSize( std::max< std::size_t >( blockSize, 1 ) ), allocator( allocator )
+			{}
+
+			ChainOutputStreambuf( const ChainOutputStreambuf & )= delete;
+			ChainOutputStreambuf &operator= ( const ChainOutputStreambuf & )= delete;
+
+			~ChainOutputStreambuf() override
+			{
+				try { publish(); }
+				catch( ... ) {}
+			}
+	};
+}
+
+namespace Alepha::Cavorite::inline exports::inline chain_streambuf
+{
+	using namespace detail::chain_streambuf::exports;
+}
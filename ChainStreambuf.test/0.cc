@@ -0,0 +1,181 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../ChainStreambuf.h"
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iterator>
+
+#include <Alepha/word_wrap.h>
+#include <Alepha/string_algorithms.h>
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	// Stand-ins for `Blob` and `DataChain`: carving shares storage, and appending re-stitches adjacent pieces.
+	struct Storage
+	{
+		std::shared_ptr< std::byte[] > storage;
+		std::size_t offset= 0;
+		std::size_t length= 0;
+
+		Storage( const std::size_t size, Alepha::AllocationPolicy, Alepha::ByteAllocator & )
+			: storage( new std::byte[ size ] ), length( size )
+		{}
+
+		Storage( std::shared_ptr< std::byte[] > storage, const std::size_t offset, const std::size_t length )
+			: storage( std::move( storage ) ), offset( offset ), length( length )
+		{}
+
+		std::byte *byte_data() const { return storage.get() + offset; }
+		std::size_t size() const { return length; }
+
+		Storage
+		carveHead( const std::size_t amount )
+		{
+			Storage rv{ storage, offset, amount };
+			offset+= amount;
+			length-= amount;
+			return rv;
+		}
+	};
+
+	struct Chain
+	{
+		std::vector< Storage > segments;
+
+		const std::vector< Storage > &chain_view() const { return segments; }
+
+		void
+		append( Storage &block )
+		{
+			if( not segments.empty() and segments.back().storage == block.storage
+					and segments.back().offset + segments.back().length == block.offset )
+			{
+				segments.back().length+= block.length;
+			}
+			else segments.push_back( std::move( block ) );
+		}
+
+		std::string
+		text() const
+		{
+			std::string rv;
+			for( const auto &segment: segments ) rv.append( reinterpret_cast< const char * >( segment.byte_data() ), segment.size() );
+			return rv;
+		}
+	};
+
+	Chain
+	chainOf( const std::vector< std::string > &pieces )
+	{
+		Chain rv;
+		for( const auto &piece: pieces )
+		{
+			Storage block{ piece.size(), Alepha::AllocationPolicy::Uninitialized, Alepha::getDefaultAllocator() };
+			std::copy( piece.begin(), piece.end(), reinterpret_cast< char * >( block.byte_data() ) );
+			rv.segments.push_back( std::move( block ) );
+		}
+		return rv;
+	}
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"input"_test <=[]( TestState test )
+	{
+		const Chain chain= chainOf( { "12 3", "", "4 fi", "ve", " six\nseven" } );
+		Alepha::ChainInputStreambuf buffer{ chain };
+		std::istream in{ &buffer };
+
+		int a, b;
+		std::string word;
+		in >> a >> b >> word;
+		test.expect( a == 12 and b == 34 and word == "five" );
+		test.expect( in.tellg() == 10 );
+
+		std::string rest{ std::istreambuf_iterator< char >{ in }, {} };
+		test.expect( rest == " six\nseven" );
+
+		in.clear();
+		in.seekg( 6 );
+		std::getline( in, word );
+		test.expect( word == "five six" );
+		in.seekg( -3, std::ios::end );
+		in >> word;
+		test.expect( word == "ven" );
+		in.seekg( 0, std::ios::end );
+		test.expect( in.tellg() == 20 and in.peek() == EOF );
+	};
+
+	"input_reads_in_place"_test <=[]( TestState test )
+	{
+		struct Inspectable : Alepha::ChainInputStreambuf< Chain >
+		{
+			using ChainInputStreambuf::ChainInputStreambuf;
+			const std::byte *next() const { return reinterpret_cast< const std::byte * >( gptr() ); }
+		};
+
+		const Chain chain= chainOf( { "abc", "def" } );
+		Inspectable buffer{ chain };
+		test.expect( buffer.in_avail() == 6 );
+		test.expect( buffer.sgetc() == 'a' );
+		test.expect( buffer.in_avail() == 3 );
+		test.expect( buffer.next() == chain.segments[ 0 ].byte_data() );
+
+		buffer.pubseekpos( 4 );
+		test.expect( buffer.sgetc() == 'e' );
+		test.expect( buffer.next() == chain.segments[ 1 ].byte_data() + 1 );
+	};
+
+	"output"_test <=[]( TestState test )
+	{
+		Chain chain;
+		{
+			Alepha::ChainOutputStreambuf< Chain, Storage > buffer{ chain, 16 };
+			std::ostream out{ &buffer };
+			out << "value=" << 42 << ' ' << 2.5 << std::flush;
+			test.expect( chain.text() == "value=42 2.5" );
+			out << " and then a good deal more text than one block holds";
+		}
+		test.expect( chain.text() == "value=42 2.5 and then a good deal more text than one block holds" );
+
+		// A flush carves the written part off, and the next write continues in the same block -- the two pieces
+		// are stitched back together.
+		test.expect( chain.segments.size() == 4 );
+		for( const auto &segment: chain.segments ) test.expect( segment.size() <= 16 );
+	};
+
+	"formatting_filters"_test <=[]( TestState test )
+	{
+		const std::string text= "The quick brown fox jumps over the lazy dog, again and again, $animal$.";
+		const auto format= [&]( std::ostream &out )
+		{
+			out << Alepha::StartWrap{ 20 } << Alepha::StartSubstitutions{ '$', { { "animal", []{ return std::string{ "forever" }; } } } }
+					<< text << Alepha::EndSubstitutions << Alepha::EndWrap;
+		};
+
+		std::ostringstream expected;
+		format( expected );
+
+		Chain chain;
+		{
+			Alepha::ChainOutputStreambuf< Chain, Storage > buffer{ chain, 32 };
+			std::ostream out{ &buffer };
+			format( out );
+		}
+		test.expect( chain.text() == expected.str() );
+	};
+};
@@ -0,0 +1,320 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <concepts>
+
+#if defined( __x86_64__ )
+#include <nmmintrin.h>
+#endif
+
+namespace Alepha::inline Cavorite  ::detail::  checksum
+{
+	inline namespace exports
+	{
+		class Crc32c;
+		class Hash64;
+
+		template< typename T > concept ContiguousBytes= requires( const T &t )
+		{
+			{ t.byte_data() } -> std::convertible_to< const std::byte * >;
+			{ t.size() } -> std::convertible_to< std::size_t >;
+		};
+
+		template< typename T > concept SegmentedBytes= requires( const T &t )
+		{
+			{ *begin( t.chain_view() ) } -> ContiguousBytes;
+		};
+	}
+
+	namespace C
+	{
+		// The reflected Castagnoli polynomial, as used by iSCSI, ext4 and SSE4.2's `crc32` instruction.
+		const std::uint32_t castagnoli= 0x82F6'3B78;
+	}
+
+	// Slicing-by-8 tables: `crcTables[ k ][ b ]` is the CRC of byte `b` followed by `k` zero bytes.
+	constexpr auto crcTables= []
+	{
+		std::array< std::array< std::uint32_t, 256 >, 8 > rv{};
+		for( std::uint32_t b= 0; b < 256; ++b )
+		{
+			std::uint32_t crc= b;
+			for( int bit= 0; bit < 8; ++bit ) crc= ( crc >> 1 ) ^ ( crc & 1 ? C::castagnoli : 0 );
+			rv[ 0 ][ b ]= crc;
+		}
+		for( std::size_t k= 1; k < 8; ++k )
+		{
+			for( std::uint32_t b= 0; b < 256; ++b ) rv[ k ][ b ]= ( rv[ k - 1 ][ b ] >> 8 ) ^ rv[ 0 ][ rv[ k - 1 ][ b ] & 0xFF ];
+		}
+		return rv;
+	}();
+
+	inline std::uint64_t
+	load64( const std::byte *const data ) noexcept
+	{
+		std::uint64_t rv;
+		std::memcpy( &rv, data, sizeof( rv ) );
+		if constexpr( std::endian::native == std::endian::big ) rv= __builtin_bswap64( rv );
+		return rv;
+	}
+
+	inline std::uint32_t
+	load32( const std::byte *const data ) noexcept
+	{
+		std::uint32_t rv;
+		std::memcpy( &rv, data, sizeof( rv ) );
+		if constexpr( std::endian::native == std::endian::big ) rv= __builtin_bswap32( rv );
+		return rv;
+	}
+
+	// These kernels work on the raw (uninverted) register.
+
+	inline std::uint32_t
+	crc32cPortable( std::uint32_t crc, const std::byte *data, std::size_t length ) noexcept
+	{
+		const auto &t= crcTables;
+		for( ; length >= 8; data+= 8, length-= 8 )
+		{
+			const std::uint64_t word= load64( data ) ^ crc;
+			crc= t[ 7 ][ word & 0xFF ] ^ t[ 6 ][ ( word >> 8 ) & 0xFF ] ^ t[ 5 ][ ( word >> 16 ) & 0xFF ] ^ t[ 4 ][ ( word >> 24 ) & 0xFF ]
+					^ t[ 3 ][ ( word >> 32 ) & 0xFF ] ^ t[ 2 ][ ( word >> 40 ) & 0xFF ] ^ t[ 1 ][ ( word >> 48 ) & 0xFF ] ^ t[ 0 ][ word >> 56 ];
+		}
+		while( length-- ) crc= ( crc >> 8 ) ^ t[ 0 ][ ( crc ^ std::to_integer< std::uint32_t >( *data++ ) ) & 0xFF ];
+		return crc;
+	}
+
+#if defined( __x86_64__ )
+	[[gnu::target( "sse4.2" )]] inline std::uint32_t
+	crc32cHardware( std::uint32_t crc, const std::byte *data, std::size_t length ) noexcept
+	{
+		std::uint64_t wide= crc;
+		for( ; length >= 8; data+= 8, length-= 8 ) wide= _mm_crc32_u64( wide, load64( data ) );
+		crc= wide;
+		while( length-- ) crc= _mm_crc32_u8( crc, std::to_integer< std::uint8_t >( *data++ ) );
+		return crc;
+	}
+#endif
+
+	using Crc32cKernel= std::uint32_t ( std::uint32_t, const std::byte *, std::size_t ) noexcept;
+
+	// Chosen once, the first time a CRC is computed, by what the running CPU supports.
+	inline Crc32cKernel *
+	crc32cKernel() noexcept
+	{
+		static Crc32cKernel *const rv= []() -> Crc32cKernel *
+		{
+#if defined( __x86_64__ )
+			if( __builtin_cpu_supports( "sse4.2" ) ) return crc32cHardware;
+#endif
+			return crc32cPortable;
+		}();
+		return rv;
+	}
+
+	/*!
+	 * A running CRC32C (Castagnoli) checksum.
+	 *
+	 * Data can be fed in any number of pieces; the result is the same as for one contiguous buffer.  The
+	 * SSE4.2 `crc32` instruction is used when the CPU has it, and a slicing-by-8 table otherwise.
+	 */
+	class exports::Crc32c
+	{
+		private:
+			std::uint32_t state= ~std::uint32_t{};
+
+		public:
+			Crc32c &
+			update( const std::byte *const data, const std::size_t length ) noexcept
+			{
+				state= crc32cKernel()( state, data, length );
+				return *this;
+			}
+
+			Crc32c &update( const ContiguousBytes auto &data ) noexcept { return update( data.byte_data(), data.size() ); }
+
+			Crc32c &
+			update( const SegmentedBytes auto &data ) noexcept
+			{
+				for( const auto &segment: data.chain_view() ) update( segment );
+				return *this;
+			}
+
+			std::uint32_t value() const noexcept { return ~state; }
+
+			static bool
+			hardwareAccelerated() noexcept
+			{
+#if defined( __x86_64__ )
+				return crc32cKernel() == crc32cHardware;
+#else
+				return false;
+#endif
+			}
+	};
+
+	namespace C
+	{
+		const std::uint64_t prime1= 0x9E37'79B1'85EB'CA87;
+		const std::uint64_t prime2= 0xC2B2'AE3D'27D4'EB4F;
+		const std::uint64_t prime3= 0x1656'67B1'9E37'79F9;
+		const std::uint64_t prime4= 0x85EB'CA77'C2B2'AE63;
+		const std::uint64_t prime5= 0x27D4'EB2F'1656'67C5;
+	}
+
+	/*!
+	 * A running 64-bit non-cryptographic hash.
+	 *
+	 * This is XXH64, so results match other implementations of it.  As with `Crc32c`, data can be fed in any
+	 * number of pieces.
+	 */
+	class exports::Hash64
+	{
+		private:
+			std::array< std::uint64_t, 4 > lanes;
+			std::array< std::byte, 32 > pending;
+			std::size_t pendingLength= 0;
+			std::uint64_t totalLength= 0;
+			std::uint64_t seed;
+
+			static std::uint64_t
+			round( std::uint64_t lane, const std::uint64_t input ) noexcept
+			{
+				lane+= input * C::prime2;
+				lane= std::rotl( lane, 31 );
+				return lane * C::prime1;
+			}
+
+			static std::uint64_t
+			merge( std::uint64_t hash, const std::uint64_t lane ) noexcept
+			{
+				hash^= round( 0, lane );
+				return hash * C::prime1 + C::prime4;
+			}
+
+			void
+			stripe( const std::byte *const data ) noexcept
+			{
+				for( std::size_t i= 0; i < 4; ++i ) lanes[ i ]= round( lanes[ i ], load64( data + 8 * i ) );
+			}
+
+		public:
+			explicit
+			Hash64( const std::uint64_t seed= 0 ) noexcept
+				: lanes{ seed + C::prime1 + C::prime2, seed + C::prime2, seed, seed - C::prime1 }, seed( seed )
+			{}
+
+			Hash64 &
+			update( const std::byte *data, std::size_t length ) noexcept
+			{
+				totalLength+= length;
+
+				if( pendingLength )
+				{
+					const std::size_t taken= std::min( length, pending.size() - pendingLength );
+					std::memcpy( pending.data() + pendingLength, data, taken );
+					pendingLength+= taken;
+					data+= taken;
+					length-= taken;
+					if( pendingLength < pending.size() ) return *this;
+					stripe( pending.data() );
+					pendingLength= 0;
+				}
+
+				for( ; length >= 32; data+= 32, length-= 32 ) stripe( data );
+
+				std::memcpy( pending.data(), data, length );
+				pendingLength= length;
+				return *this;
+			}
+
+			Hash64 &update( const ContiguousBytes auto &data ) noexcept { return update( data.byte_data(), data.size() ); }
+
+			Hash64 &
+			update( const SegmentedBytes auto &data ) noexcept
+			{
+				for( const auto &segment: data.chain_view() ) update( segment );
+				return *this;
+			}
+
+			std::uint64_t
+			value() const noexcept
+			{
+				std::uint64_t hash;
+				if( totalLength >= 32 )
+				{
+					hash= std::rotl( lanes[ 0 ], 1 ) + std::rotl( lanes[ 1 ], 7 ) + std::rotl( lanes[ 2 ], 12 ) + std::rotl( lanes[ 3 ], 18 );
+					for( const auto lane: lanes ) hash= merge( hash, lane );
+				}
+				else hash= seed + C::prime5;
+
+				hash+= totalLength;
+
+				const std::byte *data= pending.data();
+				std::size_t length= pendingLength;
+				for( ; length >= 8; data+= 8, length-= 8 )
+				{
+					hash^= round( 0, load64( data ) );
+					hash= std::rotl( hash, 27 ) * C::prime1 + C::prime4;
+				}
+				if( length >= 4 )
+				{
+					hash^= load32( data ) * C::prime1;
+					hash= std::rotl( hash, 23 ) * C::prime2 + C::prime3;
+					data+= 4;
+					length-= 4;
+				}
+				for( ; length; ++data, --length )
+				{
+					hash^= std::to_integer< std::uint64_t >( *data ) * C::prime5;
+					hash= std::rotl( hash, 11 ) * C::prime1;
+				}
+
+				hash^= hash >> 33;
+				hash*= C::prime2;
+				hash^= hash >> 29;
+				hash*= C::prime3;
+				hash^= hash >> 32;
+				return hash;
+			}
+	};
+
+	namespace exports
+	{
+		/*!
+		 * The CRC32C of a `Buffer`, `Blob`, or `DataChain`.  A `DataChain` is checksummed segment by segment, in
+		 * place.
+		 */
+		template< typename Bytes >
+		requires( ContiguousBytes< Bytes > or SegmentedBytes< Bytes > )
+		std::uint32_t
+		crc32c( const Bytes &data ) noexcept
+		{
+			return Crc32c{}.update( data ).value();
+		}
+
+		/*!
+		 * The 64-bit hash (XXH64) of a `Buffer`, `Blob`, or `DataChain`.  A `DataChain` is hashed segment by
+		 * segment, in place.
+		 */
+		template< typename Bytes >
+		requires( ContiguousBytes< Bytes > or SegmentedBytes< Bytes > )
+		std::uint64_t
+		hash64( const Bytes &data, const std::uint64_t seed= 0 ) noexcept
+		{
+			return Hash64{ seed }.update( data ).value();
+		}
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline checksum
+{
+	using namespace detail::checksum::exports;
+}
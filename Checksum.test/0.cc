@@ -0,0 +1,92 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Checksum.h"
+#include "../Buffer.h"
+#include "../DataChain.h"
+
+#include <string>
+#include <random>
+#include <vector>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	Alepha::Buffer< Alepha::Const >
+	bytes( const std::string &text )
+	{
+		return { text.data(), text.size() };
+	}
+
+	Alepha::DataChain
+	split( const std::string &text, const std::vector< std::size_t > &cuts )
+	{
+		Alepha::DataChain rv;
+		std::size_t from= 0;
+		for( const auto cut: cuts )
+		{
+			rv.append( bytes( text.substr( from, cut - from ) ) );
+			from= cut;
+		}
+		rv.append( bytes( text.substr( from ) ) );
+		return rv;
+	}
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"crc32c_vectors"_test <=[]( TestState test )
+	{
+		test.expect( Alepha::crc32c( bytes( "123456789" ) ) == 0xE306'9283 );
+		test.expect( Alepha::crc32c( bytes( std::string( 32, '\0' ) ) ) == 0x8A91'36AA );
+		test.expect( Alepha::crc32c( bytes( std::string( 32, '\xFF' ) ) ) == 0x62A8'AB43 );
+		test.expect( Alepha::crc32c( Alepha::Buffer< Alepha::Const >{} ) == 0 );
+	};
+
+	"crc32c_kernels_agree"_test <=[]( TestState test )
+	{
+		namespace detail= Alepha::Cavorite::detail::checksum;
+		std::mt19937 random{ 42 };
+		std::vector< std::byte > data( 1000 );
+		for( auto &b: data ) b= std::byte( random() );
+		for( std::size_t length= 0; length <= data.size(); length+= 37 )
+		{
+			const std::uint32_t portable= detail::crc32cPortable( ~0u, data.data(), length );
+			test.expect( portable == detail::crc32cKernel()( ~0u, data.data(), length ) );
+		}
+	};
+
+	"hash64_vectors"_test <=[]( TestState test )
+	{
+		test.expect( Alepha::hash64( Alepha::Buffer< Alepha::Const >{} ) == 0xEF46'DB37'51D8'E999 );
+		test.expect( Alepha::hash64( bytes( "a" ) ) == 0xD24E'C4F1'A98C'6E5B );
+		test.expect( Alepha::hash64( bytes( "abc" ) ) == 0x44BC'2CF5'AD77'0999 );
+		test.expect( Alepha::hash64( bytes( "Nobody inspects the spammish repetition" ) ) == 0xFBCE'A83C'8A37'8BF1 );
+		test.expect( Alepha::hash64( bytes( "abc" ), 1 ) != Alepha::hash64( bytes( "abc" ) ) );
+	};
+
+	"segmented_matches_contiguous"_test <=[]( TestState test )
+	{
+		std::string text;
+		for( int i= 0; i < 300; ++i ) text+= std::to_string( i * i );
+
+		const auto whole= bytes( text );
+		for( const auto &cuts: std::vector< std::vector< std::size_t > >{ {}, { 1 }, { 31, 32, 33 }, { 5, 70, 71, 200, 401 }, { 0, 0, 600 } } )
+		{
+			const Alepha::DataChain chain= split( text, cuts );
+			test.expect( Alepha::crc32c( chain ) == Alepha::crc32c( whole ) );
+			test.expect( Alepha::hash64( chain ) == Alepha::hash64( whole ) );
+			test.expect( Alepha::hash64( chain, 99 ) == Alepha::hash64( whole, 99 ) );
+		}
+	};
+};
@@ -0,0 +1,43 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Checksum.h"
+
+#include <chrono>
+#include <vector>
+#include <iostream>
+
+/*
+ * Throughput of the checksum and hash kernels over a buffer which fits in the last level cache.
+ */
+
+namespace
+{
+	template< typename Function >
+	double
+	throughput( const std::vector< std::byte > &data, const std::size_t rounds, Function function )
+	{
+		std::uint64_t sink= 0;
+		const auto start= std::chrono::steady_clock::now();
+		for( std::size_t round= 0; round < rounds; ++round ) sink+= function( data.data(), data.size() );
+		const std::chrono::duration< double > elapsed= std::chrono::steady_clock::now() - start;
+		if( sink == 42 ) std::cout << "";
+		return data.size() * rounds / elapsed.count() / ( 1 << 30 );
+	}
+}
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	namespace detail= Alepha::Cavorite::detail::checksum;
+	const std::size_t rounds= argcnt > 1 ? std::stoul( argvec[ 1 ] ) : 50;
+
+	std::vector< std::byte > data( 1 << 20 );
+	for( std::size_t i= 0; i < data.size(); ++i ) data[ i ]= std::byte( i * 131 );
+
+	std::cout << "CRC32C (dispatched, " << ( Alepha::Crc32c::hardwareAccelerated() ? "SSE4.2" : "table" ) << "): "
+			<< throughput( data, rounds, []( auto *p, auto n ) { return Alepha::Crc32c{}.update( p, n ).value(); } ) << " GiB/s" << std::endl;
+	std::cout << "CRC32C (table): "
+			<< throughput( data, rounds, []( auto *p, auto n ) { return detail::crc32cPortable( ~0u, p, n ); } ) << " GiB/s" << std::endl;
+	std::cout << "Hash64: "
+			<< throughput( data, rounds, []( auto *p, auto n ) { return Alepha::Hash64{}.update( p, n ).value(); } ) << " GiB/s" << std::endl;
+}
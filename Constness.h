@@ -0,0 +1,46 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <type_traits>
+
+namespace Alepha::inline Cavorite  ::detail::  constness
+{
+	inline namespace exports
+	{
+		/*!
+		 * Whether a view may modify what it views.
+		 *
+		 * Views such as `Buffer` take this as a template parameter, rather than being instantiated on a `const`
+		 * qualified type, so that the mutable and the read-only flavors are one template.
+		 */
+		enum Constness : bool { Const= true, Mutable= false };
+	}
+
+	template< typename T, Constness constness >
+	struct maybe_const { using type= T; };
+
+	template< typename T >
+	struct maybe_const< T, Const > { using type= const T; };
+
+	// Pointers and references are made to point, or refer, to `const`.
+	template< typename T >
+	struct maybe_const< T *, Const > { using type= const T *; };
+
+	template< typename T >
+	struct maybe_const< T &, Const > { using type= const T &; };
+
+	namespace exports
+	{
+		template< typename T, Constness constness >
+		using maybe_const_t= typename maybe_const< T, constness >::type;
+
+		template< typename T, Constness constness >
+		using maybe_const_ptr_t= maybe_const_t< T *, constness >;
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline constness
+{
+	using namespace detail::constness::exports;
+}
@@ -0,0 +1,898 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include <ctime>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+
+#include <map>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <optional>
+#include <concepts>
+#include <exception>
+#include <coroutine>
+#include <type_traits>
+#include <system_error>
+#include <unordered_map>
+
+#include "Thread.h"
+#include "SlabPool.h"
+#include "ThreadPool.h"
+
+namespace Alepha::inline Cavorite  ::detail::  coroutine
+{
+	inline namespace exports
+	{
+		template< typename T= void > class Task;
+		template< typename T > class Spawned;
+		class Reactor;
+
+		// What a spawned coroutine is cancelled with, unless it is cancelled with some other `Notification`.
+		using CoroutineCancellation= create_exception< struct coroutine_cancellation, Notification >;
+
+		// Thrown on waiting for a descriptor to become ready in a way some other coroutine is already waiting for.
+		using ReactorBusyError= synthetic_exception< struct reactor_busy_error, Error >;
+	}
+
+	namespace C
+	{
+		// How many readiness events the reactor takes from the kernel at once.
+		const int reactorEventBatch= 64;
+	}
+
+	struct Context;
+
+	/*!
+	 * A suspended coroutine, and where it is waiting.
+	 *
+	 * Whoever takes a waiter out of what it is waiting in -- the reactor when its event comes, or a cancellation
+	 * before then -- has the sole right to resume it.
+	 */
+	struct Waiter
+	{
+		std::coroutine_handle<> handle;
+		Context *context= nullptr;
+
+		// Take this waiter back out of what it is waiting in.  This fails when it has already been taken out.
+		virtual bool withdraw() noexcept= 0;
+
+		// Post the coroutine back to its pool.  If that fails, the whole chain is abandoned instead.
+		void resume() noexcept;
+
+		protected:
+			~Waiter()= default;
+	};
+
+	/*!
+	 * The state shared by a spawned coroutine and every `Task` it awaits, down the chain.
+	 */
+	struct Context
+	{
+		ThreadPool *executor= nullptr;
+
+		// The outermost coroutine of the chain, which owns every frame under it.
+		std::coroutine_handle<> outermost;
+
+		// The cancellation waiting to be delivered, published and consumed by exchange, as a thread's is.
+		std::atomic< std::exception_ptr * > notification= nullptr;
+
+		// What the chain is waiting in, while it can be cancelled out of it.  This is only set or cleared under
+		// `access`, and a cancellation withdraws it under `access`, so it is never withdrawn after it is gone.
+		Mutex access;
+		Waiter *suspended= nullptr;
+
+		virtual ~Context() { delete notification.load( std::memory_order_acquire ); }
+
+		// Called by the outermost coroutine of the chain as it finishes, to take its result and free its frame.
+		virtual void complete( std::coroutine_handle<> handle ) noexcept= 0;
+
+		// End a suspended chain which cannot be resumed, destroying its frames.  It counts as cancelled by `reason`.
+		virtual void abandon( std::exception_ptr reason ) noexcept= 0;
+
+		bool cancellationPending() const noexcept { return notification.load( std::memory_order_acquire ); }
+
+		// Raise the pending cancellation, if there is one.  Each cancellation is raised once.
+		void
+		checkCancellation()
+		{
+			if( not notification.load( std::memory_order_relaxed ) ) [[likely]] return;
+			if( const std::unique_ptr< std::exception_ptr > pending{ notification.exchange( nullptr, std::memory_order_acq_rel ) } )
+			{
+				std::rethrow_exception( std::move( *pending ) );
+			}
+		}
+
+		void
+		cancel( std::exception_ptr &&exception )
+		{
+			delete notification.exchange( new std::exception_ptr( std::move( exception ) ), std::memory_order_acq_rel );
+
+			Waiter *withdrawn= nullptr;
+			{
+				lock_guard lock( access );
+				if( suspended and suspended->withdraw() ) withdrawn= std::exchange( suspended, nullptr );
+			}
+			if( withdrawn ) withdrawn->resume();
+		}
+	};
+
+	inline void
+	Waiter::resume() noexcept
+	{
+		try
+		{
+			context->executor->post( [handle= handle]{ handle.resume(); } );
+		}
+		catch( ... )
+		{
+			// Typically a `PoolShutdownError`.  Nothing else can ever resume the chain, and this waiter dies with it.
+			context->abandon( std::current_exception() );
+		}
+	}
+
+	/*!
+	 * The base for awaiting something which can be cancelled while it is waited for.
+	 *
+	 * `enlist` puts the waiter wherever it waits, or says that there is no need to wait.  Once the waiter is
+	 * enlisted the coroutine may be resumed at any moment, so nothing may touch it after that -- though it cannot get
+	 * past `await_resume` until this has let go of the context's lock.
+	 */
+	template< typename Derived >
+	struct CancellableWait
+		: Waiter
+	{
+		template< typename Promise >
+		bool
+		await_suspend( const std::coroutine_handle< Promise > coroutine )
+		{
+			handle= coroutine;
+			context= coroutine.promise().context;
+
+			lock_guard lock( context->access );
+			if( context->cancellationPending() ) return false;
+			if( not static_cast< Derived * >( this )->enlist() ) return false;
+			context->suspended= this;
+			return true;
+		}
+
+		bool await_ready() const noexcept { return false; }
+
+		void
+		await_resume()
+		{
+			{
+				lock_guard lock( context->access );
+				context->suspended= nullptr;
+			}
+			context->checkCancellation();
+		}
+	};
+
+	struct PromiseBase
+	{
+		Context *context= nullptr;
+		std::coroutine_handle<> continuation;
+		std::exception_ptr failure;
+
+		// Only the outermost coroutine of a chain holds the context, so that it outlives the chain.
+		std::shared_ptr< Context > owner;
+
+		// Frames are recycled through the process slab pool, so that short coroutines never reach `malloc`.
+		static void *operator new( const std::size_t size ) { return SlabPool::process().allocate( size ); }
+
+		static void
+		operator delete( void *const frame, const std::size_t size ) noexcept
+		{
+			SlabPool::process().deallocate( static_cast< std::byte * >( frame ), size );
+		}
+
+		std::suspend_always initial_suspend() const noexcept { return {}; }
+
+		struct FinalAwaiter
+		{
+			bool await_ready() const noexcept { return false; }
+			void await_resume() const noexcept {}
+
+			template< typename Promise >
+			std::coroutine_handle<>
+			await_suspend( const std::coroutine_handle< Promise > coroutine ) const noexcept
+			{
+				PromiseBase &promise= coroutine.promise();
+				if( promise.continuation ) return promise.continuation;
+
+				// The Context may go as soon as the frame has, so the reference to it has to outlive that.
+				const std::shared_ptr< Context > keep= std::move( promise.owner );
+				keep->complete( coroutine );
+				return std::noop_coroutine();
+			}
+		};
+
+		FinalAwaiter final_suspend() const noexcept { return {}; }
+
+		void unhandled_exception() noexcept { failure= std::current_exception(); }
+
+		void
+		rethrow() const
+		{
+			if( failure ) std::rethrow_exception( failure );
+		}
+	};
+
+	template< typename T >
+	struct Promise
+		: PromiseBase
+	{
+		std::optional< T > value;
+
+		Task< T > get_return_object() noexcept;
+
+		template< typename Value >
+		requires std::convertible_to< Value, T >
+		void
+		return_value( Value &&result )
+		{
+			value.emplace( std::forward< Value >( result ) );
+		}
+
+		T
+		take()
+		{
+			rethrow();
+			return std::move( *value );
+		}
+	};
+
+	template<>
+	struct Promise< void >
+		: PromiseBase
+	{
+		Task< void > get_return_object() noexcept;
+
+		void return_void() const noexcept {}
+
+		void take() const { rethrow(); }
+	};
+
+	/*!
+	 * A lazily started coroutine, producing a `T`.
+	 *
+	 * A `Task` does nothing until it is awaited by another `Task`, which it then runs in, or is handed to `spawn`,
+	 * which starts a chain of them on a `ThreadPool`.  Awaiting a `Task` gives its result, or throws what it threw.
+	 *
+	 * Every `co_await` in a spawned chain is a point where the chain can be cancelled: if it has been, the
+	 * coroutine resumes by throwing the `Notification` it was cancelled with.  Waits for time, for descriptors and
+	 * for other spawned coroutines are cut short to do so.  As with a thread, each cancellation is raised once, so a
+	 * coroutine which catches it can go on to clean up, awaiting as it needs to.
+	 *
+	 * Frames are allocated from `SlabPool::process()`.
+	 */
+	template< typename T >
+	class exports::Task
+	{
+		public:
+			using promise_type= Promise< T >;
+
+		private:
+			std::coroutine_handle< promise_type > coroutine;
+
+			template< typename > friend class Spawned;
+			friend promise_type;
+
+			explicit Task( const std::coroutine_handle< promise_type > coroutine ) noexcept : coroutine( coroutine ) {}
+
+			struct Awaiter
+			{
+				std::coroutine_handle< promise_type > coroutine;
+
+				bool await_ready() const noexcept { return false; }
+
+				template< typename Parent >
+				std::coroutine_handle<>
+				await_suspend( const std::coroutine_handle< Parent > parent ) noexcept
+				{
+					coroutine.promise().context= parent.promise().context;
+					coroutine.promise().continuation= parent;
+					return coroutine;
+				}
+
+				T
+				await_resume()
+				{
+					coroutine.promise().context->checkCancellation();
+					return coroutine.promise().take();
+				}
+			};
+
+		public:
+			~Task() { if( coroutine ) coroutine.destroy(); }
+
+			Task( Task &&orig ) noexcept : coroutine( std::exchange( orig.coroutine, nullptr ) ) {}
+
+			Task &
+			operator= ( Task orig ) noexcept
+			{
+				std::swap( coroutine, orig.coroutine );
+				return *this;
+			}
+
+			Awaiter operator co_await() && noexcept { return { coroutine }; }
+	};
+
+	template< typename T >
+	Task< T >
+	Promise< T >::get_return_object() noexcept
+	{
+		return Task< T >{ std::coroutine_handle< Promise >::from_promise( *this ) };
+	}
+
+	inline Task< void >
+	Promise< void >::get_return_object() noexcept
+	{
+		return Task< void >{ std::coroutine_handle< Promise >::from_promise( *this ) };
+	}
+
+	enum class State { Running, Finished, Cancelled };
+
+	/*!
+	 * The outermost coroutine of a spawned chain: its result, and who is waiting for it.
+	 */
+	template< typename T >
+	struct Root
+		: Context
+	{
+		std::atomic< State > state= State::Running;
+		std::optional< std::conditional_t< std::is_void_v< T >, bool, T > > value;
+		std::exception_ptr failure;
+
+		// The coroutine awaiting this one, if any; or `finished`, once this one is.
+		static inline Waiter *const finished= reinterpret_cast< Waiter * >( std::uintptr_t{ 1 } );
+		std::atomic< Waiter * > joiner= nullptr;
+
+		void
+		complete( const std::coroutine_handle<> handle ) noexcept override
+		{
+			auto &promise= std::coroutine_handle< Promise< T > >::from_address( handle.address() ).promise();
+			State outcome= State::Finished;
+			try
+			{
+				if constexpr( std::is_void_v< T > )
+				{
+					promise.take();
+					value.emplace( true );
+				}
+				else value.emplace( promise.take() );
+			}
+			catch( const Notification & )
+			{
+				// As in a thread, a notification which escapes is not fatal.  It just ends the chain.
+				failure= std::current_exception();
+				outcome= State::Cancelled;
+			}
+			catch( ... )
+			{
+				failure= std::current_exception();
+			}
+			handle.destroy();
+			finish( outcome );
+		}
+
+		void
+		abandon( std::exception_ptr reason ) noexcept override
+		{
+			// A cancellation must not find the waiter which is about to be destroyed.
+			{
+				lock_guard lock( access );
+				suspended= nullptr;
+			}
+
+			auto &promise= std::coroutine_handle< Promise< T > >::from_address( outermost.address() ).promise();
+			const std::shared_ptr< Context > keep= std::move( promise.owner );
+			outermost.destroy();
+			failure= std::move( reason );
+			finish( State::Cancelled );
+		}
+
+		void
+		finish( const State outcome ) noexcept
+		{
+			state.store( outcome, std::memory_order_release );
+			state.notify_all();
+			if( Waiter *const waiting= joiner.exchange( finished, std::memory_order_acq_rel ); waiting and waiting != finished )
+			{
+				waiting->resume();
+			}
+		}
+
+		bool done() const noexcept { return state.load( std::memory_order_acquire ) != State::Running; }
+
+		// Wait for the result, blocking this thread.
+		State
+		await() const noexcept
+		{
+			for( State current= state.load( std::memory_order_acquire ); ; current= state.load( std::memory_order_acquire ) )
+			{
+				if( current != State::Running ) return current;
+				state.wait( current, std::memory_order_acquire );
+			}
+		}
+
+		T
+		take()
+		{
+			if( failure ) std::rethrow_exception( failure );
+			if constexpr( not std::is_void_v< T > ) return std::move( *value );
+		}
+	};
+
+	/*!
+	 * The caller's hold on a spawned coroutine, through which it can be waited for, awaited, or cancelled.
+	 *
+	 * Dropping it leaves the coroutine running.
+	 */
+	template< typename T >
+	class exports::Spawned
+	{
+		private:
+			std::shared_ptr< Root< T > > root;
+
+			struct Awaiter
+				: CancellableWait< Awaiter >
+			{
+				Root< T > &awaited;
+
+				explicit Awaiter( Root< T > &awaited ) noexcept : awaited( awaited ) {}
+
+				bool
+				enlist() noexcept
+				{
+					Waiter *expected= nullptr;
+					return awaited.joiner.compare_exchange_strong( expected, this, std::memory_order_acq_rel );
+				}
+
+				bool
+				withdraw() noexcept override
+				{
+					Waiter *expected= this;
+					return awaited.joiner.compare_exchange_strong( expected, nullptr, std::memory_order_acq_rel );
+				}
+
+				T
+				await_resume()
+				{
+					CancellableWait< Awaiter >::await_resume();
+					return awaited.take();
+				}
+			};
+
+		public:
+			explicit
+			Spawned( ThreadPool &pool, Task< T > &&task )
+				: root( std::make_shared< Root< T > >() )
+			{
+				const auto coroutine= std::exchange( task.coroutine, nullptr );
+				root->executor= &pool;
+				root->outermost= coroutine;
+				coroutine.promise().context= root.get();
+				coroutine.promise().owner= root;
+				try
+				{
+					pool.post( [coroutine]{ coroutine.resume(); } );
+				}
+				catch( ... )
+				{
+					coroutine.destroy();
+					throw;
+				}
+			}
+
+			/*!
+			 * Cancel the coroutine.
+			 *
+			 * The chain resumes from its current `co_await` by throwing the given `Notification` (or a
+			 * `CoroutineCancellation`).  If it is waiting, the wait is cut short; if it is running, the notification
+			 * is raised at its next `co_await`.
+			 *
+			 * @return Whether the cancellation reached the coroutine before it finished.
+			 */
+			bool cancel() { return cancel( build_exception< CoroutineCancellation >( "Coroutine cancelled." ) ); }
+
+			template< typename Exc >
+			requires std::derived_from< std::decay_t< Exc >, Notification >
+			bool
+			cancel( Exc &&exception )
+			{
+				if( root->done() ) return false;
+				root->cancel( std::make_exception_ptr( std::forward< Exc >( exception ) ) );
+				return true;
+			}
+
+			bool done() const noexcept { return root->done(); }
+
+			/*!
+			 * Wait until the coroutine has finished or been cancelled, blocking this thread.
+			 *
+			 * @return Whether the coroutine ran to completion.
+			 * @throw Whatever the coroutine threw, other than a `Notification`.
+			 */
+			bool
+			wait() const
+			{
+				if( root->await() == State::Cancelled ) return false;
+				if( root->failure ) std::rethrow_exception( root->failure );
+				return true;
+			}
+
+			/*!
+			 * Wait for the coroutine's result, blocking this thread.  This may only be done once.
+			 *
+			 * @throw Whatever the coroutine threw, including the `Notification` which ended it.
+			 */
+			T
+			get()
+			{
+				root->await();
+				return root->take();
+			}
+
+			/*!
+			 * Await the coroutine's result from another coroutine, without blocking a thread.  This may only be done
+			 * once, and by one coroutine.
+			 *
+			 * @throw Whatever the coroutine threw, including the `Notification` which ended it.
+			 */
+			Awaiter operator co_await() && noexcept { return Awaiter{ *root }; }
+	};
+
+	struct PoolHop
+	{
+		ThreadPool &pool;
+		Context *context= nullptr;
+
+		bool await_ready() const noexcept { return false; }
+
+		template< typename Promise >
+		void
+		await_suspend( const std::coroutine_handle< Promise > coroutine )
+		{
+			context= coroutine.promise().context;
+			context->executor= &pool;
+			pool.post( [coroutine]{ coroutine.resume(); } );
+		}
+
+		void await_resume() const { context->checkCancellation(); }
+	};
+
+	namespace exports
+	{
+		/*!
+		 * Start `task` on `pool`.
+		 *
+		 * The task, and the tasks it awaits, run on the pool's workers.  Whenever it waits on a `Reactor`, it is
+		 * resumed on the pool again.
+		 *
+		 * @throw PoolShutdownError if the pool is shutting down.
+		 */
+		template< typename T >
+		[[nodiscard]] Spawned< T >
+		spawn( ThreadPool &pool, Task< T > &&task )
+		{
+			return Spawned< T >{ pool, std::move( task ) };
+		}
+
+		/*!
+		 * Move the awaiting coroutine onto `pool`, and have it resumed there after any later waits.
+		 */
+		inline PoolHop resumeOn( ThreadPool &pool ) noexcept { return PoolHop{ pool }; }
+	}
+
+	/*!
+	 * Waits on timers and on file descriptors, for coroutines.
+	 *
+	 * One thread sleeps in `epoll_wait` for all of them, so thousands of waiting coroutines cost no thread each.
+	 * Timers share a single `timerfd`, armed for the earliest deadline.  A coroutine whose wait is over is resumed on
+	 * the `ThreadPool` it was spawned on (or last moved to by `resumeOn`).
+	 *
+	 * A descriptor can have one coroutine waiting for it to be readable and one for it to be writable.  Waits are
+	 * level triggered, and as with any readiness notification, the operation may still find that it would block.
+	 *
+	 * @note Coroutines still waiting when the reactor is destroyed are never resumed.  The reactor must be destroyed
+	 * before the pools which it resumes coroutines on are shut down.  A coroutine whose pool has already shut down
+	 * when its wait is over is abandoned: its frames are destroyed, and it ends as though cancelled by the
+	 * `PoolShutdownError`.
+	 */
+	class exports::Reactor
+	{
+		public:
+			using Clock= std::chrono::steady_clock;
+
+		private:
+			struct Interest
+			{
+				Waiter *reader= nullptr;
+				Waiter *writer= nullptr;
+			};
+
+			struct TimerWait
+				: CancellableWait< TimerWait >
+			{
+				Reactor &reactor;
+				const Clock::time_point deadline;
+				std::multimap< Clock::time_point, Waiter * >::iterator position;
+
+				explicit TimerWait( Reactor &reactor, const Clock::time_point deadline ) noexcept : reactor( reactor ), deadline( deadline ) {}
+
+				bool enlist() { return reactor.addTimer( *this ); }
+				bool withdraw() noexcept override { return reactor.removeTimer( *this ); }
+			};
+
+			struct DescriptorWait
+				: CancellableWait< DescriptorWait >
+			{
+				Reactor &reactor;
+				const int fd;
+				const bool writing;
+
+				explicit DescriptorWait( Reactor &reactor, const int fd, const bool writing ) noexcept : reactor( reactor ), fd( fd ), writing( writing ) {}
+
+				bool enlist() { reactor.addDescriptor( *this ); return true; }
+				bool withdraw() noexcept override { return reactor.removeDescriptor( *this ); }
+			};
+
+			int epoll= -1;
+			int timer= -1;
+			int wakeup= -1;
+
+			Mutex access;
+			std::multimap< Clock::time_point, Waiter * > timers;
+			std::unordered_map< int, Interest > interests;
+
+			std::atomic< bool > stopping= false;
+			std::optional< Thread > thread;
+
+			static int
+			check( const int result, const char *const what )
+			{
+				if( result == -1 ) throw std::system_error{ errno, std::generic_category(), what };
+				return result;
+			}
+
+			void
+			watch( const int fd, const std::uint32_t events )
+			{
+				epoll_event event{};
+				event.events= events;
+				event.data.fd= fd;
+				check( ::epoll_ctl( epoll, EPOLL_CTL_ADD, fd, &event ), "Unable to watch descriptor" );
+			}
+
+			// Set the timerfd to go off at the earliest deadline.  Called under `access`.
+			void
+			arm() noexcept
+			{
+				itimerspec setting{};
+				if( not timers.empty() )
+				{
+					const auto nanoseconds= std::chrono::duration_cast< std::chrono::nanoseconds >( timers.begin()->first.time_since_epoch() ).count();
+					setting.it_value= { std::time_t( nanoseconds / 1'000'000'000 ), long( nanoseconds % 1'000'000'000 ) };
+					// A zero setting would disarm it.
+					if( not setting.it_value.tv_sec and not setting.it_value.tv_nsec ) setting.it_value.tv_nsec= 1;
+				}
+				::timerfd_settime( timer, TFD_TIMER_ABSTIME, &setting, nullptr );
+			}
+
+			// Returns whether there is anything to wait for.
+			bool
+			addTimer( TimerWait &wait )
+			{
+				if( wait.deadline <= Clock::now() ) return false;
+
+				lock_guard lock( access );
+				wait.position= timers.emplace( wait.deadline, &wait );
+				if( wait.position == timers.begin() ) arm();
+				return true;
+			}
+
+			bool
+			removeTimer( TimerWait &wait ) noexcept
+			{
+				lock_guard lock( access );
+				if( wait.position == timers.end() ) return false;
+				timers.erase( std::exchange( wait.position, timers.end() ) );
+				return true;
+			}
+
+			// Tell epoll what is now waited for on `fd`.  Called under `access`.
+			void
+			update( const int fd, const Interest &interest, const bool registered )
+			{
+				epoll_event event{};
+				event.events= ( interest.reader ? static_cast< std::uint32_t >( EPOLLIN ) : 0 ) | ( interest.writer ? static_cast< std::uint32_t >( EPOLLOUT ) : 0 );
+				event.data.fd= fd;
+
+				if( not event.events )
+				{
+					// The descriptor may have been closed already, which took it out of the set.
+					if( registered ) ::epoll_ctl( epoll, EPOLL_CTL_DEL, fd, nullptr );
+					interests.erase( fd );
+					return;
+				}
+
+				if( registered and ::epoll_ctl( epoll, EPOLL_CTL_MOD, fd, &event ) == 0 ) return;
+				check( ::epoll_ctl( epoll, EPOLL_CTL_ADD, fd, &event ), "Unable to watch descriptor" );
+			}
+
+			void
+			addDescriptor( DescriptorWait &wait )
+			{
+				lock_guard lock( access );
+				Interest &interest= interests[ wait.fd ];
+				const bool registered= interest.reader or interest.writer;
+				Waiter *&slot= wait.writing ? interest.writer : interest.reader;
+				if( slot ) throw build_exception< ReactorBusyError >( "Another coroutine is already waiting on this descriptor." );
+
+				slot= &wait;
+				try
+				{
+					update( wait.fd, interest, registered );
+				}
+				catch( ... )
+				{
+					slot= nullptr;
+					if( not registered ) interests.erase( wait.fd );
+					throw;
+				}
+			}
+
+			bool
+			removeDescriptor( DescriptorWait &wait ) noexcept
+			{
+				lock_guard lock( access );
+				const auto found= interests.find( wait.fd );
+				if( found == interests.end() ) return false;
+				Waiter *&slot= wait.writing ? found->second.writer : found->second.reader;
+				if( slot != &wait ) return false;
+
+				slot= nullptr;
+				try { update( wait.fd, found->second, true ); }
+				catch( const std::system_error & ) {}
+				return true;
+			}
+
+			void
+			run()
+			{
+				epoll_event events[ C::reactorEventBatch ];
+				std::vector< Waiter * > ready;
+				while( not stopping.load( std::memory_order_acquire ) )
+				{
+					const int count= ::epoll_wait( epoll, events, C::reactorEventBatch, -1 );
+					if( count == -1 )
+					{
+						if( errno == EINTR ) continue;
+						check( count, "Unable to wait for descriptors" );
+					}
+
+					{
+						lock_guard lock( access );
+						for( int index= 0; index < count; ++index )
+						{
+							const int fd= events[ index ].data.fd;
+							std::uint64_t discard;
+							if( fd == wakeup ) continue;
+							if( fd == timer )
+							{
+								[[maybe_unused]] const auto drained= ::read( timer, &discard, sizeof( discard ) );
+								const auto now= Clock::now();
+								while( not timers.empty() and timers.begin()->first <= now )
+								{
+									Waiter *const expired= timers.begin()->second;
+									static_cast< TimerWait * >( expired )->position= timers.end();
+									timers.erase( timers.begin() );
+									ready.push_back( expired );
+								}
+								arm();
+								continue;
+							}
+
+							const auto found= interests.find( fd );
+							if( found == interests.end() ) continue;
+							Interest &interest= found->second;
+							const bool failed= events[ index ].events & ( EPOLLERR | EPOLLHUP );
+							if( interest.reader and ( failed or events[ index ].events & EPOLLIN ) ) ready.push_back( std::exchange( interest.reader, nullptr ) );
+							if( interest.writer and ( failed or events[ index ].events & EPOLLOUT ) ) ready.push_back( std::exchange( interest.writer, nullptr ) );
+							try { update( fd, interest, true ); }
+							catch( const std::system_error & ) {}
+						}
+					}
+
+					for( Waiter *const waiter: ready ) waiter->resume();
+					ready.clear();
+				}
+			}
+
+		public:
+			~Reactor()
+			{
+				if( thread )
+				{
+					stopping.store( true, std::memory_order_release );
+					const std::uint64_t one= 1;
+					[[maybe_unused]] const auto written= ::write( wakeup, &one, sizeof( one ) );
+					thread->join();
+				}
+				for( const int fd: { wakeup, timer, epoll } ) if( fd != -1 ) ::close( fd );
+			}
+
+			/*!
+			 * Start the reactor's thread.
+			 *
+			 * @throw std::system_error if the epoll set, timer or wakeup descriptors cannot be made.
+			 */
+			Reactor()
+			{
+				try
+				{
+					epoll= check( ::epoll_create1( EPOLL_CLOEXEC ), "Unable to create epoll set" );
+					timer= check( ::timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC ), "Unable to create timer" );
+					wakeup= check( ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC ), "Unable to create wakeup event" );
+					watch( timer, EPOLLIN );
+					watch( wakeup, EPOLLIN );
+					thread.emplace( [this]{ run(); } );
+				}
+				catch( ... )
+				{
+					for( const int fd: { wakeup, timer, epoll } ) if( fd != -1 ) ::close( fd );
+					throw;
+				}
+			}
+
+			Reactor( const Reactor & )= delete;
+			Reactor &operator= ( const Reactor & )= delete;
+
+			/*!
+			 * Await `deadline`.
+			 *
+			 * @throw Notification if the coroutine is cancelled meanwhile.
+			 */
+			TimerWait sleepUntil( const Clock::time_point deadline ) noexcept { return TimerWait{ *this, deadline }; }
+
+			template< typename Rep, typename Period >
+			TimerWait
+			sleepFor( const std::chrono::duration< Rep, Period > duration ) noexcept
+			{
+				return sleepUntil( Clock::now() + std::chrono::duration_cast< Clock::duration >( duration ) );
+			}
+
+			/*!
+			 * Await `fd` becoming readable, or failing.
+			 *
+			 * @throw ReactorBusyError if another coroutine is already waiting for it to be readable.
+			 * @throw Notification if the coroutine is cancelled meanwhile.
+			 */
+			DescriptorWait readable( const int fd ) noexcept { return DescriptorWait{ *this, fd, false }; }
+
+			/*!
+			 * Await `fd` becoming writable, or failing.
+			 *
+			 * @throw ReactorBusyError if another coroutine is already waiting for it to be writable.
+			 * @throw Notification if the coroutine is cancelled meanwhile.
+			 */
+			DescriptorWait writable( const int fd ) noexcept { return DescriptorWait{ *this, fd, true }; }
+	};
+}
+
+namespace Alepha::Cavorite::inline exports::inline coroutine
+{
+	using namespace detail::coroutine::exports;
+}
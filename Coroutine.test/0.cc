@@ -0,0 +1,272 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Coroutine.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	using namespace std::literals::chrono_literals;
+
+	using StopNotification= Alepha::create_exception< struct stop_notification, Alepha::Notification >;
+
+	Alepha::Task< int >
+	square( const int n )
+	{
+		co_return n * n;
+	}
+
+	Alepha::Task< int >
+	sumOfSquares( const int n )
+	{
+		int rv= 0;
+		for( int i= 1; i <= n; ++i ) rv+= co_await square( i );
+		co_return rv;
+	}
+
+	Alepha::Task<>
+	fail()
+	{
+		throw std::runtime_error{ "failed" };
+		co_return;
+	}
+
+	Alepha::Task< std::string >
+	catchFailure()
+	{
+		try { co_await fail(); }
+		catch( const std::runtime_error &error ) { co_return error.what(); }
+		co_return "nothing";
+	}
+
+	Alepha::Task< std::chrono::steady_clock::duration >
+	sleeper( Alepha::Reactor &reactor, const std::chrono::milliseconds duration )
+	{
+		const auto start= std::chrono::steady_clock::now();
+		co_await reactor.sleepFor( duration );
+		co_return std::chrono::steady_clock::now() - start;
+	}
+
+	Alepha::Task< std::string >
+	readLine( Alepha::Reactor &reactor, const int fd )
+	{
+		co_await reactor.readable( fd );
+		char buffer[ 64 ];
+		const auto amount= ::read( fd, buffer, sizeof( buffer ) );
+		co_return std::string( buffer, amount );
+	}
+
+	// Catches its cancellation, and then can still wait for other things.
+	Alepha::Task< std::string >
+	stoppable( Alepha::Reactor &reactor )
+	{
+		try
+		{
+			co_await reactor.sleepFor( 1h );
+		}
+		catch( const StopNotification & )
+		{
+		}
+		co_await reactor.sleepFor( 1ms );
+		co_return "stopped";
+	}
+
+	Alepha::Task< int >
+	delayed( Alepha::Reactor &reactor, const int value )
+	{
+		co_await reactor.sleepFor( 1ms );
+		co_return value;
+	}
+
+	Alepha::Task< int >
+	fanOut( Alepha::ThreadPool &pool, Alepha::Reactor &reactor, const int width )
+	{
+		std::vector< Alepha::Spawned< int > > children;
+		for( int i= 0; i < width; ++i ) children.push_back( Alepha::spawn( pool, delayed( reactor, i ) ) );
+
+		int rv= 0;
+		for( auto &child: children ) rv+= co_await std::move( child );
+		co_return rv;
+	}
+
+	Alepha::Task< int >
+	sleepThenCount( Alepha::Reactor &reactor, const std::chrono::milliseconds duration )
+	{
+		co_await sleeper( reactor, duration );
+		co_return 1;
+	}
+
+	Alepha::Task< std::string >
+	awaitFailure( Alepha::Spawned< int > awaited )
+	{
+		try { co_await std::move( awaited ); }
+		catch( const Alepha::PoolShutdownError & ) { co_return "shut down"; }
+		co_return "finished";
+	}
+
+	struct Pipe
+	{
+		int ends[ 2 ];
+
+		Pipe() { if( ::pipe( ends ) ) throw std::runtime_error{ "pipe" }; }
+		~Pipe() { ::close( ends[ 0 ] ); ::close( ends[ 1 ] ); }
+	};
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"task_chain"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		test.expect( Alepha::spawn( pool, sumOfSquares( 10 ) ).get() == 385 );
+	};
+
+	"failures"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		test.expect( Alepha::spawn( pool, catchFailure() ).get() == "failed" );
+
+		auto failing= Alepha::spawn( pool, fail() );
+		bool thrown= false;
+		try { failing.wait(); }
+		catch( const std::runtime_error & ) { thrown= true; }
+		test.expect( thrown );
+	};
+
+	"timer"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		Alepha::Reactor reactor;
+		auto longer= Alepha::spawn( pool, sleeper( reactor, 40ms ) );
+		auto shorter= Alepha::spawn( pool, sleeper( reactor, 20ms ) );
+		test.expect( shorter.get() >= 20ms );
+		test.expect( longer.get() >= 40ms );
+	};
+
+	"descriptor"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		Alepha::Reactor reactor;
+		Pipe pipe;
+
+		auto reader= Alepha::spawn( pool, readLine( reactor, pipe.ends[ 0 ] ) );
+		std::this_thread::sleep_for( 10ms );
+		test.expect( not reader.done() );
+		test.expect( ::write( pipe.ends[ 1 ], "hello", 5 ) == 5 );
+		test.expect( reader.get() == "hello" );
+	};
+
+	"busy_descriptor"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		Alepha::Reactor reactor;
+		Pipe pipe;
+
+		auto first= Alepha::spawn( pool, readLine( reactor, pipe.ends[ 0 ] ) );
+		std::this_thread::sleep_for( 10ms );
+		auto second= Alepha::spawn( pool, readLine( reactor, pipe.ends[ 0 ] ) );
+
+		bool busy= false;
+		try { second.wait(); }
+		catch( const Alepha::ReactorBusyError & ) { busy= true; }
+		test.expect( busy );
+
+		test.expect( first.cancel() );
+		test.expect( not first.wait() );
+	};
+
+	"cancel_timer"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		Alepha::Reactor reactor;
+
+		auto stopped= Alepha::spawn( pool, stoppable( reactor ) );
+		std::this_thread::sleep_for( 10ms );
+		test.expect( stopped.cancel( Alepha::build_exception< StopNotification >( "stop" ) ) );
+		test.expect( stopped.get() == "stopped" );
+		test.expect( not stopped.cancel() );
+	};
+
+	"cancel_descriptor"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		Alepha::Reactor reactor;
+		Pipe pipe;
+
+		auto reader= Alepha::spawn( pool, readLine( reactor, pipe.ends[ 0 ] ) );
+		std::this_thread::sleep_for( 10ms );
+		reader.cancel( Alepha::build_exception< StopNotification >( "stop" ) );
+
+		// The cancellation ends the chain as a `Notification`, which is not a failure.
+		test.expect( not reader.wait() );
+		bool thrown= false;
+		try { reader.get(); }
+		catch( const StopNotification & ) { thrown= true; }
+		test.expect( thrown );
+
+		// The descriptor can be waited on again.
+		auto again= Alepha::spawn( pool, readLine( reactor, pipe.ends[ 0 ] ) );
+		test.expect( ::write( pipe.ends[ 1 ], "again", 5 ) == 5 );
+		test.expect( again.get() == "again" );
+	};
+
+	"pool_shut_down_while_waiting"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 1 };
+		Alepha::ThreadPool other{ 1 };
+		Alepha::Reactor reactor;
+
+		auto waiting= Alepha::spawn( pool, sleepThenCount( reactor, 30ms ) );
+		auto joiner= Alepha::spawn( other, awaitFailure( Alepha::spawn( pool, sleepThenCount( reactor, 30ms ) ) ) );
+		std::this_thread::sleep_for( 10ms );
+		pool.shutdown();
+
+		// The chain cannot be resumed on its pool, so it is abandoned rather than left hanging.
+		test.expect( not waiting.wait() );
+		bool thrown= false;
+		try { waiting.get(); }
+		catch( const Alepha::PoolShutdownError & ) { thrown= true; }
+		test.expect( thrown );
+
+		test.expect( joiner.get() == "shut down" );
+	};
+
+	"fan_out"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		Alepha::Reactor reactor;
+		test.expect( Alepha::spawn( pool, fanOut( pool, reactor, 1000 ) ).get() == 999 * 1000 / 2 );
+	};
+
+	"frames_recycled"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 1 };
+		const auto round= [&]
+		{
+			for( int i= 0; i < 1000; ++i ) Alepha::spawn( pool, sumOfSquares( 3 ) ).get();
+		};
+
+		round();
+		const std::size_t reserved= Alepha::SlabPool::process().reservedBytes();
+		round();
+		test.expect( Alepha::SlabPool::process().reservedBytes() == reserved );
+	};
+};
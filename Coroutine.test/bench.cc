@@ -0,0 +1,79 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Coroutine.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+/*
+ * Waiting many things out at once: coroutines on a few pool workers, against a blocked thread for each wait.
+ *
+ * Each of `width` waiters sleeps for a millisecond, `rounds` times over.  The coroutine case also shows the cost
+ * of spawning and finishing short coroutines, whose frames come from the slab pool.
+ */
+
+namespace
+{
+	using namespace std::literals::chrono_literals;
+
+	template< typename Function >
+	double
+	milliseconds( Function function )
+	{
+		const auto start= std::chrono::steady_clock::now();
+		function();
+		const std::chrono::duration< double, std::milli > elapsed= std::chrono::steady_clock::now() - start;
+		return elapsed.count();
+	}
+
+	Alepha::Task< int >
+	trivial( const int n )
+	{
+		co_return n;
+	}
+
+	Alepha::Task<>
+	waiter( Alepha::Reactor &reactor, const int rounds )
+	{
+		for( int round= 0; round < rounds; ++round ) co_await reactor.sleepFor( 1ms );
+	}
+}
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	const int width= argcnt > 1 ? std::stoi( argvec[ 1 ] ) : 1000;
+	const int rounds= 10;
+	const int spawns= 100'000;
+
+	Alepha::ThreadPool pool{ 2 };
+	Alepha::Reactor reactor;
+
+	std::cout << "Spawning " << spawns << " short coroutines: " << milliseconds( [&]
+	{
+		std::vector< Alepha::Spawned< int > > spawned;
+		spawned.reserve( spawns );
+		for( int i= 0; i < spawns; ++i ) spawned.push_back( Alepha::spawn( pool, trivial( i ) ) );
+		for( auto &each: spawned ) each.wait();
+	} ) << " ms" << std::endl;
+
+	std::cout << width << " coroutines on " << pool.size() << " workers, " << rounds << " waits each: " << milliseconds( [&]
+	{
+		std::vector< Alepha::Spawned< void > > spawned;
+		for( int i= 0; i < width; ++i ) spawned.push_back( Alepha::spawn( pool, waiter( reactor, rounds ) ) );
+		for( auto &each: spawned ) each.wait();
+	} ) << " ms" << std::endl;
+
+	std::cout << width << " threads, " << rounds << " waits each: " << milliseconds( [&]
+	{
+		std::vector< std::unique_ptr< Alepha::Thread > > threads;
+		for( int i= 0; i < width; ++i ) threads.push_back( std::make_unique< Alepha::Thread >( [&]
+		{
+			for( int round= 0; round < rounds; ++round ) std::this_thread::sleep_for( 1ms );
+		} ) );
+		for( auto &thread: threads ) thread->join();
+	} ) << " ms" << std::endl;
+}
@@ -2,170 +2,924 @@ static_assert( __cplusplus > 2020'00 );
 
 #pragma once
 
+#include <sys/uio.h>
+
+#include <cerrno>
+#include <climits>
+
+#include <limits>
+
 #include <deque>
+#include <vector>
+#include <optional>
+#include <system_error>
+#include <tuple>
 #include <utility>
 #include <algorithm>
 #include <iterator>
-#include <numeric>
+#include <compare>
 
-#include "comparisons.h"
 #include "Buffer.h"
 #include "Blob.h"
+#include "ByteSearch.h"
+#include "Transfer.h"
 
 namespace Alepha::inline Cavorite  ::detail::  data_chain
 {
 	inline namespace exports
 	{
 		class DataChain;
+		struct CompactionPolicy;
+		struct CompactionStatistics;
 	}
 
+	namespace C
+	{
+		// The capacity of each segment `readFrom` reads into.  This leaves room for the storage header, so that a
+		// segment fits in a 64 KiB block of a `SlabPool`.
+		const std::size_t readSegmentSize= 64 * 1024 - 256;
+
+		// A single `readv` or `writev` call takes at most this many segments.
+		const std::size_t maximumIOSegments= IOV_MAX;
+
+		// The capacity of the segments which compaction packs small segments into.  As above, this is sized so
+		// that a segment fits in a 4 KiB block of a `SlabPool`.
+		const std::size_t compactedSegmentSize= 4 * 1024 - 256;
+	}
+
+	/*!
+	 * When a `DataChain` copies small segments together.
+	 *
+	 * Chains built from many small reads end up with many small segments, which makes iteration and I/O slow.
+	 * Compaction copies runs of adjacent small segments into new, page sized segments.  The default policy never
+	 * compacts.
+	 */
+	struct exports::CompactionPolicy
+	{
+		// Segments holding fewer bytes than this are candidates for compaction.
+		std::size_t minimumSegmentSize= 0;
+
+		// When an append leaves the chain with more segments than this, the chain is compacted.
+		std::size_t maximumSegmentCount= std::numeric_limits< std::size_t >::max();
+	};
+
+	/*!
+	 * How much copying compaction has done on a `DataChain`.
+	 */
+	struct exports::CompactionStatistics
+	{
+		std::size_t compactions= 0;
+		std::size_t segmentsMerged= 0;
+		std::size_t bytesCopied= 0;
+	};
+
 	using std::begin, std::end;
 
+	/*!
+	 * A sequence of bytes spread over a chain of `Blob` segments.
+	 *
+	 * Alongside the segments, the chain keeps an index of where each segment starts.  Positions are recorded in
+	 * a running coordinate space: `origin` is the coordinate of the first byte in the chain and `extent` is the
+	 * coordinate one past the last.  Appending only ever adds to `extent` and consuming from the front only ever
+	 * adds to `origin`, so neither operation has to rewrite the index.  This makes `size` constant time, and lets
+	 * iterators find the segment for any position by binary search.
+	 */
 	class exports::DataChain
 	{
 		private:
 			using Chain= std::deque< Blob >;
 			Chain chain;
 
+			// `starts[ i ]` is the coordinate of the first byte of `chain[ i ]`.
+			std::deque< std::size_t > starts;
+			std::size_t origin= 0;
+			std::size_t extent= 0;
+
+			CompactionPolicy policy;
+			CompactionStatistics statistics;
+
+			// The segment count at which an append next compacts.  When compaction cannot get the chain below
+			// the policy's maximum (because its segments are not small), this backs off so that appends stay
+			// amortized constant time.  It comes back down as the chain shrinks.
+			std::size_t compactionTrigger= std::numeric_limits< std::size_t >::max();
+
+			std::size_t
+			backedOffTrigger() const noexcept
+			{
+				return std::max( policy.maximumSegmentCount, 2 * chain.size() );
+			}
+
+			void shrunk() noexcept { compactionTrigger= std::min( compactionTrigger, backedOffTrigger() ); }
+
+			// The index of the segment holding the byte at `coordinate`, which must be in the chain.
+			std::size_t
+			segmentAt( const std::size_t coordinate ) const noexcept
+			{
+				using std::begin, std::end;
+				return std::upper_bound( begin( starts ), end( starts ), coordinate ) - begin( starts ) - 1;
+			}
+
+			void
+			popFront() noexcept
+			{
+				chain.pop_front();
+				starts.pop_front();
+				origin= starts.empty() ? extent : starts.front();
+				shrunk();
+			}
+
+			// Drop the first `amount` bytes, which must be in the chain.
+			void
+			discardHead( std::size_t amount ) noexcept
+			{
+				while( amount and chain.front().size() <= amount )
+				{
+					amount-= chain.front().size();
+					popFront();
+				}
+				if( amount )
+				{
+					std::ignore= chain.front().carveHead( amount );
+					starts.front()+= amount;
+					origin+= amount;
+				}
+			}
+
+			void
+			popBack() noexcept
+			{
+				extent= starts.back();
+				chain.pop_back();
+				starts.pop_back();
+				shrunk();
+			}
+
+			// Drop the last `amount` bytes, which must be in the chain.
+			void
+			discardTail( std::size_t amount ) noexcept
+			{
+				while( amount and chain.back().size() <= amount )
+				{
+					amount-= chain.back().size();
+					popBack();
+				}
+				if( amount )
+				{
+					chain.back().setSize( chain.back().size() - amount );
+					extent-= amount;
+				}
+			}
+
 			template< Constness constness >
-			class Iterator : comparable
+			class Iterator
 			{
 				public:
-					using iterator_category= std::forward_iterator_tag;
+					using iterator_category= std::random_access_iterator_tag;
 					using value_type= std::byte;
 					using difference_type= std::ptrdiff_t;
-					using pointer= std::byte *;
-					using reference= std::byte &;
+					using pointer= maybe_const_t< std::byte *, constness >;
+					using reference= maybe_const_t< std::byte &, constness >;
 
 				private:
-					using ChainIter= decltype( std::declval< maybe_const_t< Chain, constness > >().begin() );
-					ChainIter position;
-					std::size_t offset;
+					maybe_const_t< DataChain, constness > *owner= nullptr;
+					std::size_t segment= 0;
+					std::size_t offset= 0;
+
+					friend DataChain;
+
+					explicit
+					Iterator( maybe_const_t< DataChain, constness > *const owner, const std::size_t segment, const std::size_t offset ) noexcept
+						: owner( owner ), segment( segment ), offset( offset ) {}
+
+					std::size_t
+					coordinate() const noexcept
+					{
+						if( segment == owner->chain.size() ) return owner->extent;
+						return owner->starts[ segment ] + offset;
+					}
 
 					void
-					advance() noexcept
+					seek( const std::size_t target ) noexcept
 					{
-						if( ++offset < pos->size() ) return;
-						++pos;
-						offset= 0;
+						// Moves within the current segment, which are the overwhelmingly common case, need no search.
+						if( segment < owner->chain.size() and target >= owner->starts[ segment ]
+								and target - owner->starts[ segment ] < owner->chain[ segment ].size() )
+						{
+							offset= target - owner->starts[ segment ];
+						}
+						else if( target == owner->extent )
+						{
+							segment= owner->chain.size();
+							offset= 0;
+						}
+						else
+						{
+							segment= owner->segmentAt( target );
+							offset= target - owner->starts[ segment ];
+						}
 					}
 
-					friend DataChain;
+				public:
+					Iterator() noexcept= default;
 
-					explicit Iterator( const ChainIter pos, cosnt std::size_t offset ) noexcept : pos( pos ), offset( offset ) {}
+					// Mutable iterators convert to const ones.
+					operator Iterator< Const > () const noexcept
+					requires( constness == Mutable )
+					{
+						return Iterator< Const >{ owner, segment, offset };
+					}
 
-				public:
-					auto
-					value_lens() const noexcept( noexcept( std::tie( pos, offset ) ) )
+					// The capability based `comparable` cannot see through the `Constness` template parameter, so
+					// the comparisons are spelled out here.
+					friend bool operator == ( const Iterator &, const Iterator & ) noexcept= default;
+					friend auto operator <=> ( const Iterator &, const Iterator & ) noexcept= default;
+
+					Iterator &
+					operator ++() noexcept
+					{
+						if( ++offset < owner->chain[ segment ].size() ) return *this;
+						++segment;
+						offset= 0;
+						return *this;
+					}
+
+					Iterator
+					operator++ ( int ) noexcept
 					{
-						return std::tie( pos, offset );
+						Iterator rv= *this;
+						++*this;
+						return rv;
 					}
 
-					Iterator &operator ++() noexcept { advance(); return *this; }
+					Iterator &
+					operator --() noexcept
+					{
+						if( offset-- ) return *this;
+						--segment;
+						offset= owner->chain[ segment ].size() - 1;
+						return *this;
+					}
 
 					Iterator
-					operator++ ( int )
-					noexcept
-					(
-						noexcept( Iterator{ std::declval< Iterator >() } )
-							and
-						noexcept( advance() )
-					)
-					{
-						Iterator rv{ *this; }
-						advance();
+					operator-- ( int ) noexcept
+					{
+						Iterator rv= *this;
+						--*this;
 						return rv;
 					}
 
-					maybe_const_t< std::byte &, constness >
-					operator *() const noexcept( noexcept( pos->byte_data()[ offset ] ) )
+					Iterator &operator+= ( const difference_type amount ) noexcept { seek( coordinate() + amount ); return *this; }
+					Iterator &operator-= ( const difference_type amount ) noexcept { return *this+= -amount; }
+
+					friend Iterator operator + ( Iterator it, const difference_type amount ) noexcept { return it+= amount; }
+					friend Iterator operator + ( const difference_type amount, Iterator it ) noexcept { return it+= amount; }
+					friend Iterator operator - ( Iterator it, const difference_type amount ) noexcept { return it-= amount; }
+
+					friend difference_type
+					operator - ( const Iterator &lhs, const Iterator &rhs ) noexcept
 					{
-						return pos->byte_data()[ offset ];
+						return lhs.coordinate() - rhs.coordinate();
 					}
 
-				public:
-					template< typename T > void operator []( T ) const= delete;
-					template< typename T > void operator []( T )= delete;
+					reference operator *() const noexcept { return owner->chain[ segment ].byte_data()[ offset ]; }
 
-					using iterator= Iterator< Mutable >;
-					using const_iterator= Iterator< Const >;
+					reference operator []( const difference_type index ) const noexcept { return *( *this + index ); }
+			};
 
-					auto begin() noexcept { using std::begin; return iterator{ begin( chain ), 0 }; }
-					auto end() noexcept { using std::end; return iterator{ end( chain ), 0 }; }
+		public:
+			using iterator= Iterator< Mutable >;
+			using const_iterator= Iterator< Const >;
 
-					auto begin() const noexcept { using std::begin; return const_iterator{ begin( chain ), 0 }; }
-					auto end() const noexcept { using std::end; return const_iterator{ end( chain ), 0 }; }
+			auto begin() noexcept { return iterator{ this, 0, 0 }; }
+			auto end() noexcept { return iterator{ this, chain.size(), 0 }; }
 
-					auto cbegin() const noexcept { return begin(); }
-					auto cend() const noexcept { return end(); }
+			auto begin() const noexcept { return const_iterator{ this, 0, 0 }; }
+			auto end() const noexcept { return const_iterator{ this, chain.size(), 0 }; }
 
-					// Please note that this non-const view form provides direct access to the chain.
-					// This class doesn't store any additional state, so modification of this chain is
-					// likely safe, for now.  But in the future, this could change.  Manual modification
-					// of this chain is strongly discouraged.
-					Chain &chain_view() noexcept { return chain; }
-					const Chain &chain_view() const noexcept { return chain; }
+			auto cbegin() const noexcept { return begin(); }
+			auto cend() const noexcept { return end(); }
 
-					std::size_t
-					size() const
+			// The chain is only exposed read-only, as `DataChain` keeps an index over it which direct modification
+			// would invalidate.
+			const Chain &chain_view() const noexcept { return chain; }
+
+			std::size_t size() const noexcept { return extent - origin; }
+
+			std::size_t chain_length() const noexcept { return chain.size(); }
+			bool chain_empty() const noexcept { return chain.empty(); }
+
+			void
+			clear() noexcept
+			{
+				chain.clear();
+				starts.clear();
+				origin= extent= 0;
+				compactionTrigger= policy.maximumSegmentCount;
+			}
+
+			void
+			append( Blob &block )
+			{
+				if( block.size() == 0 ) return;
+				const std::size_t amount= block.size();
+
+				// If we're getting a `Blob` which is contiguous we try to re-stitch them, which leaves the index alone:
+				if( not chain.empty() )
+				{
+					if( const auto contiguous= chain.back().isContiguousWith( std::move( block ) ) )
 					{
-						using std::begin, std::end;
-						return std::accumulate( begin( chain_view() ), end( chain_view() ), std::size_t{},
-								[] ( const std::size_t lhs, const auto &rhs ) { return lhs + rhs.size(); } );
+						contiguous.compose();
+						extent+= amount;
+						return;
+					}
+				}
+
+				// As a fallback, we just have to put it at the back of our list:
+				starts.push_back( extent );
+				try
+				{
+					chain.push_back( std::move( block ) );
+				}
+				catch( ... )
+				{
+					starts.pop_back();
+					throw;
+				}
+				extent+= amount;
+
+				if( chain.size() > compactionTrigger ) [[unlikely]] compactOnAppend();
+			}
+
+			void
+			append( const Buffer< Const > &buffer )
+			{
+				if( buffer.size() == 0 ) return;
+				Blob block{ buffer };
+				append( block );
+			}
+
+			/*!
+			 * Set the policy for compacting small segments.
+			 *
+			 * The chain is not compacted by this call, only by later appends or calls to `compact`.
+			 */
+			void
+			setCompactionPolicy( const CompactionPolicy newPolicy ) noexcept
+			{
+				policy= newPolicy;
+				compactionTrigger= policy.maximumSegmentCount;
+			}
+
+			const CompactionPolicy &compactionPolicy() const noexcept { return policy; }
+			const CompactionStatistics &compactionStatistics() const noexcept { return statistics; }
+
+			/*!
+			 * Copy each run of adjacent small segments (as the compaction policy defines them) into as few new
+			 * segments as will hold it.
+			 *
+			 * A small segment with no small neighbours is left alone, as copying it gains nothing.  This function
+			 * has the strong guarantee: if allocation fails, the chain is unchanged.
+			 */
+			void
+			compact()
+			{
+				const std::size_t capacity= std::max( C::compactedSegmentSize, policy.minimumSegmentSize );
+				const auto small= [&]( const std::size_t index ) { return chain[ index ].size() < policy.minimumSegmentSize; };
+
+				// First, do all of the copying into packed segments, each replacing `[first, last)` of the chain.
+				// This is the only part which can fail, and it leaves the chain alone.
+				struct Replacement
+				{
+					std::size_t first;
+					std::size_t last;
+					Blob packed;
+				};
+				std::vector< Replacement > replacements;
+				std::size_t bytesCopied= 0;
+
+				for( std::size_t index= 0; index < chain.size(); )
+				{
+					if( not small( index ) or index + 1 == chain.size() or not small( index + 1 ) )
+					{
+						++index;
+						continue;
 					}
 
-					std::size_t chain_length() const noexcept { return chain.size(); }
-					std::size_t chain_empty() const noexcept { return chain.empty(); }
+					while( index < chain.size() and small( index ) )
+					{
+						Replacement replacement{ index, index, Blob{ capacity, AllocationPolicy::Uninitialized } };
+						std::size_t filled= 0;
+						for( ; index < chain.size() and small( index ) and filled + chain[ index ].size() <= capacity; ++index )
+						{
+							std::copy_n( chain[ index ].byte_data(), chain[ index ].size(), replacement.packed.byte_data() + filled );
+							filled+= chain[ index ].size();
+						}
+						replacement.last= index;
+						replacement.packed.setSize( filled );
+						bytesCopied+= filled;
+						replacements.push_back( std::move( replacement ) );
+					}
+				}
+				if( replacements.empty() ) return;
+
+				// Then slide everything down into place.  Nothing from here on can throw.
+				using std::begin, std::end;
+				std::size_t write= 0;
+				std::size_t segmentsMerged= 0;
+				auto next= begin( replacements );
+				for( std::size_t read= 0; read < chain.size(); ++write )
+				{
+					if( next != end( replacements ) and next->first == read )
+					{
+						chain[ write ]= std::move( next->packed );
+						segmentsMerged+= next->last - next->first;
+						read= next++->last;
+					}
+					else chain[ write ]= std::move( chain[ read++ ] );
 
-					void clear() noexcept { chain.clear(); }
+					starts[ write ]= write ? starts[ write - 1 ] + chain[ write - 1 ].size() : origin;
+				}
+				chain.erase( begin( chain ) + write, end( chain ) );
+				starts.erase( begin( starts ) + write, end( starts ) );
 
-					void
-					append( Blob &block )
-					{
-						// Base case is fast:
-						if( chain.empty() ) return chain.push_back( std::move( block ) );
+				++statistics.compactions;
+				statistics.segmentsMerged+= segmentsMerged;
+				statistics.bytesCopied+= bytesCopied;
+			}
+
+		private:
+			void
+			compactOnAppend() noexcept
+			{
+				// The append is already done, so failing to compact must not be reported as if it had failed -- the
+				// caller would append the same data again.  The chain is only left less compact than it could be.
+				try
+				{
+					compact();
+				}
+				catch( ... ) {}
+				compactionTrigger= backedOffTrigger();
+			}
+
+			// Run a search kernel over each segment in turn, starting `from` bytes into the chain.  The kernel takes
+			// the `[first, last)` range of a segment and returns a pointer to its match, or `last`.
+			template< typename Kernel >
+			std::size_t
+			scan( const std::size_t from, Kernel kernel ) const
+			{
+				if( from >= size() ) return npos;
+				for( std::size_t segment= segmentAt( origin + from ), offset= origin + from - starts[ segment ];
+						segment < chain.size(); ++segment, offset= 0 )
+				{
+					const std::byte *const first= chain[ segment ].byte_data();
+					const std::byte *const last= first + chain[ segment ].size();
+					const std::byte *const found= kernel( first + offset, last );
+					if( found != last ) return starts[ segment ] + ( found - first ) - origin;
+				}
+				return npos;
+			}
+
+			// Whether `pattern` occurs at `position`, possibly across several segments.
+			bool
+			matchesAt( const std::size_t position, const Buffer< Const > pattern ) const noexcept
+			{
+				if( pattern.size() > size() - position ) return false;
+				return std::equal( pattern.byte_data(), pattern.byte_data() + pattern.size(), begin() + position );
+			}
 
-						// If we're getting a `Blob` which is contiguous we try to re-stitch them:
-						if( const auto contiguous= chain.back().isContiguousWith( std::move( block ) ) ) contiguous.compose();
-						// As a fallback, we just have to put it at the back of our list:
-						else chain.push_back( std::move( block ) );
+			// Copy `amount` bytes starting at `first` to `destination`, one segment at a time.
+			void
+			copyOut( const_iterator first, std::size_t amount, std::byte *destination ) const
+			{
+				for( std::size_t segment= first.segment, offset= first.offset; amount; ++segment, offset= 0 )
+				{
+					const Blob &source= chain[ segment ];
+					const std::size_t piece= std::min( amount, source.size() - offset );
+					std::copy_n( source.byte_data() + offset, piece, destination );
+					destination+= piece;
+					amount-= piece;
+				}
+			}
+
+		public:
+			static constexpr std::size_t npos= -1;
+
+			/*!
+			 * Find the first byte equal to `value`, at or after position `from`.
+			 *
+			 * Each segment is scanned in place with a vectorized search.  The result is a position (a byte count
+			 * from the front of the chain) suitable for `carveHead`.
+			 *
+			 * @return The position of the match, or `npos` if there is none.
+			 */
+			std::size_t
+			find( const std::byte value, const std::size_t from= 0 ) const
+			{
+				return scan( from, [value]( const std::byte *const first, const std::byte *const last )
+				{
+					return findByte( first, last, value );
+				});
+			}
+
+			/*!
+			 * Find the first byte which is a member of `set`, at or after position `from`.
+			 *
+			 * @return The position of the match, or `npos` if there is none.
+			 */
+			std::size_t
+			findAny( const ByteSet &set, const std::size_t from= 0 ) const
+			{
+				return scan( from, [&set]( const std::byte *const first, const std::byte *const last )
+				{
+					return findAnyByte( first, last, set );
+				});
+			}
+
+			/*!
+			 * Find the first occurrence of `pattern`, at or after position `from`.
+			 *
+			 * Matches which straddle segment boundaries are found too.  Each segment is first searched in place for
+			 * a match wholly inside it, and only then are the few positions near its end, where a match would run
+			 * into the next segment, checked across the boundary.
+			 *
+			 * @return The position of the match, or `npos` if there is none.  An empty pattern matches at `from`.
+			 */
+			std::size_t
+			find( const Buffer< Const > pattern, const std::size_t from= 0 ) const
+			{
+				if( pattern.size() == 0 ) return from <= size() ? from : npos;
+				if( pattern.size() == 1 ) return find( pattern.byte_data()[ 0 ], from );
+				if( from >= size() ) return npos;
+
+				const std::byte *const patternFirst= pattern.byte_data();
+				const std::byte *const patternLast= patternFirst + pattern.size();
+				for( std::size_t segment= segmentAt( origin + from ), offset= origin + from - starts[ segment ];
+						segment < chain.size(); ++segment, offset= 0 )
+				{
+					const std::byte *const first= chain[ segment ].byte_data();
+					const std::byte *const last= first + chain[ segment ].size();
+
+					const std::byte *const inside= findPattern( first + offset, last, patternFirst, patternLast );
+					if( inside != last ) return starts[ segment ] + ( inside - first ) - origin;
+
+					// No match lies wholly inside, so try the starts which would cross into the following segments.
+					const std::size_t overlap= std::min< std::size_t >( pattern.size() - 1, last - first - offset );
+					for( const std::byte *candidate= last - overlap;
+							( candidate= findByte( candidate, last, *patternFirst ) ) != last; ++candidate )
+					{
+						const std::size_t position= starts[ segment ] + ( candidate - first ) - origin;
+						if( matchesAt( position, pattern ) ) return position;
 					}
+				}
+				return npos;
+			}
+
+			/*!
+			 * Remove the first `amount` bytes from this chain, and return them as a new chain.
+			 *
+			 * No data are copied.  Whole segments are moved to the result, and a segment which straddles the cut is
+			 * carved, so that both chains share its storage.
+			 *
+			 * `carveHead< Blob >` instead returns the bytes as a single `Blob`.  When they lie inside the first
+			 * segment, which is the common case for framed data, that is a slice of it and nothing is copied.
+			 * Otherwise they are copied once into a new `Blob`.
+			 *
+			 * @throw DataCarveTooLargeError if the chain holds fewer than `amount` bytes.
+			 */
+			template< typename Result= DataChain >
+			Result
+			carveHead( const std::size_t amount )
+			{
+				if( amount > size() ) throw DataCarveTooLargeError( nullptr, amount, size() );
+
+				if constexpr( std::is_same_v< Result, Blob > ) return carveHeadSegment( amount );
+				else return carveHeadChain( amount );
+			}
+
+			/*!
+			 * Remove the last `amount` bytes from this chain, and return them as a new chain.
+			 *
+			 * `carveTail< Blob >` returns the bytes as a single `Blob`, as `carveHead< Blob >` does.
+			 *
+			 * @see `DataChain::carveHead`
+			 *
+			 * @throw DataCarveTooLargeError if the chain holds fewer than `amount` bytes.
+			 */
+			template< typename Result= DataChain >
+			Result
+			carveTail( const std::size_t amount )
+			{
+				if( amount > size() ) throw DataCarveTooLargeError( nullptr, amount, size() );
 
-					void append( const Buffer< Const > &buffer ) { if( buffer.size() ) chain.emplace_back( buffer ); }
+				if constexpr( std::is_same_v< Result, Blob > ) return carveTailSegment( amount );
+				else return carveTailChain( amount );
+			}
 
-					Blob
-					peekHead( const std::size_t amount )
+		private:
+			DataChain
+			carveHeadChain( std::size_t amount )
+			{
+				DataChain rv;
+				while( amount )
+				{
+					Blob &front= chain.front();
+					if( front.size() <= amount )
 					{
-						if( amount == 0 ) return Blob{};
-						if( chain.empty() or size() < amount )
-						{
-							// TODO: Build a more specific exception for this case?
-							throw DataCarveToLargeError( nullptr, amount, size() );
-						}
+						amount-= front.size();
+						Blob whole= std::move( front );
+						popFront();
+						rv.append( whole );
+					}
+					else
+					{
+						Blob slice= front.carveHead( amount );
+						starts.front()+= amount;
+						origin+= amount;
+						rv.append( slice );
+						amount= 0;
+					}
+				}
+				return rv;
+			}
 
-						// TODO: This should be in a common helper with part of `carveHead`'s internals:
-						Blob rv{ amount };
-						std::copy_n( begin(), amount, rv.byte_data() );
+			DataChain
+			carveTailChain( std::size_t amount )
+			{
+				// The pieces come off back to front.
+				std::deque< Blob > pieces;
+				while( amount )
+				{
+					Blob &back= chain.back();
+					if( back.size() <= amount )
+					{
+						amount-= back.size();
+						pieces.push_front( std::move( back ) );
+						popBack();
+					}
+					else
+					{
+						pieces.push_front( back.carveTail( amount ) );
+						extent-= amount;
+						amount= 0;
+					}
+				}
 
-						return rv;
+				DataChain rv;
+				for( Blob &piece: pieces ) rv.append( piece );
+				return rv;
+			}
+
+			Blob
+			carveHeadSegment( const std::size_t amount )
+			{
+				if( amount == 0 ) return Blob{};
+
+				Blob &front= chain.front();
+				if( front.size() == amount )
+				{
+					Blob rv= std::move( front );
+					popFront();
+					return rv;
+				}
+
+				if( front.size() > amount )
+				{
+					Blob rv= front.carveHead( amount );
+					starts.front()+= amount;
+					origin+= amount;
+					return rv;
+				}
+
+				Blob rv{ amount, AllocationPolicy::Uninitialized };
+				copyOut( begin(), amount, rv.byte_data() );
+				discardHead( amount );
+				return rv;
+			}
+
+			Blob
+			carveTailSegment( const std::size_t amount )
+			{
+				if( amount == 0 ) return Blob{};
+
+				Blob &back= chain.back();
+				if( back.size() == amount )
+				{
+					Blob rv= std::move( back );
+					popBack();
+					return rv;
+				}
+
+				if( back.size() > amount )
+				{
+					Blob rv= back.carveTail( amount );
+					extent-= amount;
+					return rv;
+				}
+
+				Blob rv{ amount, AllocationPolicy::Uninitialized };
+				copyOut( end() - amount, amount, rv.byte_data() );
+				discardTail( amount );
+				return rv;
+			}
+
+		public:
+
+			/*!
+			 * Make the first `amount` bytes of this chain contiguous, and view them.
+			 *
+			 * When the first segment already holds `amount` bytes, which is the common case for framed data, this
+			 * is free.  Otherwise the bytes are copied once into a single new segment, which replaces the segments
+			 * they came from.  The view is valid until the chain is next modified.
+			 *
+			 * @throw DataCarveTooLargeError if the chain holds fewer than `amount` bytes.
+			 */
+			Buffer< Mutable >
+			linearize( const std::size_t amount )
+			{
+				if( amount > size() ) throw DataCarveTooLargeError( nullptr, amount, size() );
+				if( amount == 0 ) return {};
+
+				if( chain.front().size() < amount )
+				{
+					// Everything which can fail happens before the chain is touched: the copy, and then a slot in
+					// front for it, which starts out empty.
+					Blob merged{ amount, AllocationPolicy::Uninitialized };
+					copyOut( begin(), amount, merged.byte_data() );
+
+					chain.emplace_front();
+					try
+					{
+						starts.push_front( origin );
+					}
+					catch( ... )
+					{
+						chain.pop_front();
+						throw;
 					}
 
-					Blob
-					peekTail( const std::size_t amount )
+					// Now drop the copied bytes from behind the slot, and fill it.  None of this throws.
+					std::size_t remaining= amount;
+					while( remaining and chain[ 1 ].size() <= remaining )
 					{
-						if( amount == 0 ) return Data{};
-						if( chain.empty() or size() < amount )
-						{
-							// TODO: Build a more specific exception for this case?
-							throw DataCarveToLargeError( nullptr, amount, size() );
-						}
-						
-						// TODO: This should be in a common helper with part of `carveTail`'s internals:
-						Blob rv{ amount };
-						std::copy_n( std::prev( end(), amount ), amount, rv.byte_data() );
+						remaining-= chain[ 1 ].size();
+						chain.erase( std::next( chain.begin() ) );
+						starts.erase( std::next( starts.begin() ) );
+					}
+					shrunk();
+					if( remaining )
+					{
+						std::ignore= chain[ 1 ].carveHead( remaining );
+						starts[ 1 ]+= remaining;
+					}
+					chain.front()= std::move( merged );
+				}
+
+				return { chain.front().byte_data(), amount };
+			}
+
+			/*!
+			 * Write as much of this chain as possible to a file descriptor, in one `writev` call, and consume
+			 * whatever was written.
+			 *
+			 * @param fd The descriptor to write to.  It may be nonblocking.
+			 * @return The number of bytes written, which is 0 when the descriptor would block or the chain is empty.
+			 *
+			 * @throw std::system_error if the write fails.
+			 */
+			std::size_t
+			writeTo( const int fd )
+			{
+				if( chain.empty() ) return 0;
+
+				std::vector< iovec > segments;
+				segments.reserve( std::min( chain.size(), C::maximumIOSegments ) );
+				for( const Blob &segment: chain )
+				{
+					if( segments.size() == C::maximumIOSegments ) break;
+					segments.push_back( { const_cast< std::byte * >( segment.byte_data() ), segment.size() } );
+				}
+
+				ssize_t written;
+				do written= ::writev( fd, segments.data(), segments.size() );
+				while( written == -1 and errno == EINTR );
+
+				if( written == -1 )
+				{
+					if( errno == EAGAIN or errno == EWOULDBLOCK ) return 0;
+					throw std::system_error{ errno, std::generic_category(), "Unable to write `DataChain` to descriptor" };
+				}
+
+				discardHead( written );
+				return written;
+			}
+
+			/*!
+			 * Write as much of this chain as possible to a file descriptor, by the cheapest path the kernel offers
+			 * for each segment, and consume whatever was moved.
+			 *
+			 * Unlike `writeTo`, this keeps going until the descriptor would block, and file mapped segments are sent
+			 * from their files without passing through user space.
+			 *
+			 * @see `transfer::transferTo`
+			 */
+			TransferResult
+			transferTo( const int fd, const TransferOptions &options= {} )
+			{
+				const TransferResult rv= transfer::transferTo( fd, *this, options );
+				discardHead( rv.bytes );
+				return rv;
+			}
+
+			/*!
+			 * Read from a file descriptor, in one `readv` call, and append what was read to this chain.
+			 *
+			 * The data are read directly into new `Blob` segments from the default allocator, so no copies are
+			 * made.  A segment which is only partly filled is trimmed to what was read.
+			 *
+			 * @param fd The descriptor to read from.  It may be nonblocking.
+			 * @param hint About how many bytes to try to read.
+			 * @return The number of bytes read, which is 0 at end of file, or nothing when the descriptor would block.
+			 *
+			 * @throw std::system_error if the read fails.
+			 */
+			std::optional< std::size_t >
+			readFrom( const int fd, const std::size_t hint= C::readSegmentSize )
+			{
+				std::vector< Blob > blocks;
+				std::vector< iovec > segments;
+				for( std::size_t remaining= std::max< std::size_t >( hint, 1 );
+						remaining and segments.size() < C::maximumIOSegments; )
+				{
+					const std::size_t amount= std::min( remaining, C::readSegmentSize );
+					blocks.emplace_back( amount, AllocationPolicy::Uninitialized );
+					segments.push_back( { blocks.back().byte_data(), amount } );
+					remaining-= amount;
+				}
+
+				ssize_t got;
+				do got= ::readv( fd, segments.data(), segments.size() );
+				while( got == -1 and errno == EINTR );
+
+				if( got == -1 )
+				{
+					if( errno == EAGAIN or errno == EWOULDBLOCK ) return std::nullopt;
+					throw std::system_error{ errno, std::generic_category(), "Unable to read `DataChain` from descriptor" };
+				}
+
+				std::size_t remaining= got;
+				for( Blob &block: blocks )
+				{
+					if( remaining == 0 ) break;
+					if( block.size() <= remaining )
+					{
+						remaining-= block.size();
+						append( block );
+					}
+					else
+					{
+						Blob filled= block.carveHead( remaining );
+						append( filled );
+						remaining= 0;
+					}
+				}
+				return got;
+			}
 
-						return rv;
-							
-			};
+			Blob
+			peekHead( const std::size_t amount ) const
+			{
+				if( amount == 0 ) return Blob{};
+				if( size() < amount )
+				{
+					// TODO: Build a more specific exception for this case?
+					throw DataCarveTooLargeError( nullptr, amount, size() );
+				}
+
+				Blob rv{ amount, AllocationPolicy::Uninitialized };
+				copyOut( begin(), amount, rv.byte_data() );
+
+				return rv;
+			}
+
+			Blob
+			peekTail( const std::size_t amount ) const
+			{
+				if( amount == 0 ) return Blob{};
+				if( size() < amount )
+				{
+					// TODO: Build a more specific exception for this case?
+					throw DataCarveTooLargeError( nullptr, amount, size() );
+				}
+
+				Blob rv{ amount, AllocationPolicy::Uninitialized };
+				copyOut( end() - amount, amount, rv.byte_data() );
+
+				return rv;
+			}
 	};
 }
+
+namespace Alepha::Cavorite::inline exports::inline data_chain
+{
+	using namespace detail::data_chain::exports;
+}
@@ -0,0 +1,493 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../DataChain.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	Alepha::Blob
+	blobOf( const std::string &text )
+	{
+		return Alepha::Blob{ Alepha::Buffer< Alepha::Const >{ text.data(), text.size() } };
+	}
+
+	void
+	appendText( Alepha::DataChain &chain, const std::string &text )
+	{
+		auto blob= blobOf( text );
+		chain.append( blob );
+	}
+
+	std::string
+	textOf( const Alepha::DataChain &chain )
+	{
+		std::string rv;
+		for( const std::byte b: chain ) rv.push_back( static_cast< char >( b ) );
+		return rv;
+	}
+
+	std::string
+	drain( const int fd, const std::size_t amount )
+	{
+		std::string rv( amount, '\0' );
+		std::size_t got= 0;
+		while( got < amount )
+		{
+			const ssize_t n= ::read( fd, rv.data() + got, amount - got );
+			if( n <= 0 ) break;
+			got+= n;
+		}
+		rv.resize( got );
+		return rv;
+	}
+
+	struct Pipe
+	{
+		int fds[ 2 ];
+
+		Pipe() { if( ::pipe2( fds, O_CLOEXEC ) ) std::abort(); }
+		~Pipe() { ::close( fds[ 0 ] ); ::close( fds[ 1 ] ); }
+	};
+
+	struct TempFile
+	{
+		std::filesystem::path path;
+		int fd;
+
+		TempFile()
+		{
+			std::string name= ( std::filesystem::temp_directory_path() / "Alepha.DataChain.XXXXXX" ).string();
+			fd= ::mkstemp( name.data() );
+			path= name;
+		}
+
+		~TempFile() { ::close( fd ); std::filesystem::remove( path ); }
+	};
+
+	// A chain of many small, separately allocated segments, so that none of them can be stitched together.
+	std::string
+	buildFragmented( Alepha::DataChain &chain, const std::size_t segments )
+	{
+		std::string contents;
+		for( std::size_t i= 0; i < segments; ++i )
+		{
+			const std::string piece= std::to_string( i ) + ";";
+			appendText( chain, piece );
+			contents+= piece;
+		}
+		return contents;
+	}
+
+	std::string
+	textOf( const Alepha::Blob &blob )
+	{
+		return { reinterpret_cast< const char * >( blob.byte_data() ), blob.size() };
+	}
+
+	// Refuses to allocate, to check what a failure leaves behind.
+	struct FailingAllocator
+		: Alepha::ByteAllocator
+	{
+		std::byte *allocate( std::size_t ) override { throw std::bad_alloc{}; }
+		void deallocate( std::byte *, std::size_t ) noexcept override {}
+	};
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+	using namespace std::literals::string_literals;
+
+	"write_more_segments_than_iov_max_to_file"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		const std::string contents= buildFragmented( chain, IOV_MAX * 2 + 17 );
+		test.expect( chain.chain_length() == IOV_MAX * 2 + 17 );
+
+		TempFile file;
+		std::size_t calls= 0, total= 0;
+		while( chain.size() )
+		{
+			const std::size_t written= chain.writeTo( file.fd );
+			test.expect( written > 0 );
+			total+= written;
+			++calls;
+		}
+		test.expect( calls == 3 );
+		test.expect( total == contents.size() );
+		test.expect( chain.chain_empty() );
+
+		test.expect( ::lseek( file.fd, 0, SEEK_SET ) == 0 );
+		Alepha::DataChain back;
+		while( back.readFrom( file.fd, 1000 ).value() );
+		test.expect( back.size() == contents.size() );
+		test.expect( textOf( back ) == contents );
+	};
+
+	"short_writes_to_full_pipe"_test <=[]( TestState test )
+	{
+		Pipe pipe;
+		::fcntl( pipe.fds[ 1 ], F_SETFL, O_NONBLOCK );
+		const std::size_t capacity= ::fcntl( pipe.fds[ 1 ], F_GETPIPE_SZ );
+
+		// Each segment is larger than the pipe buffer's pages, so the pipe fills part way through a segment.
+		Alepha::DataChain chain;
+		std::string contents;
+		for( std::size_t i= 0; contents.size() < capacity * 3; ++i )
+		{
+			const std::string piece( 1000 + i, static_cast< char >( 'a' + i % 26 ) );
+			appendText( chain, piece );
+			contents+= piece;
+		}
+
+		std::string received;
+		std::size_t shortWrites= 0;
+		while( chain.size() )
+		{
+			const std::size_t before= chain.size();
+			const std::size_t written= chain.writeTo( pipe.fds[ 1 ] );
+			test.expect( chain.size() == before - written );
+			if( not chain.size() ) break;
+
+			// The pipe is full, so empty it before trying again.
+			if( written ) ++shortWrites;
+			received+= drain( pipe.fds[ 0 ], contents.size() - chain.size() - received.size() );
+		}
+		test.expect( shortWrites > 0 );
+		::close( pipe.fds[ 1 ] );
+		pipe.fds[ 1 ]= ::open( "/dev/null", O_RDONLY | O_CLOEXEC );
+		received+= drain( pipe.fds[ 0 ], contents.size() - received.size() );
+		test.expect( received == contents );
+	};
+
+	"read_from_pipe"_test <=[]( TestState test )
+	{
+		Pipe pipe;
+		::fcntl( pipe.fds[ 0 ], F_SETFL, O_NONBLOCK );
+
+		Alepha::DataChain chain;
+		test.expect( not chain.readFrom( pipe.fds[ 0 ] ) );
+
+		const std::string message= "hello, chain";
+		test.expect( ::write( pipe.fds[ 1 ], message.data(), message.size() ) == ssize_t( message.size() ) );
+
+		// A read which asks for more than is there is trimmed to what was read.
+		const auto got= chain.readFrom( pipe.fds[ 0 ], 3 * Alepha::Cavorite::detail::data_chain::C::readSegmentSize );
+		test.expect( got and *got == message.size() );
+		test.expect( chain.size() == message.size() and chain.chain_length() == 1 );
+		test.expect( textOf( chain ) == message );
+
+		::close( pipe.fds[ 1 ] );
+		pipe.fds[ 1 ]= ::open( "/dev/null", O_RDONLY | O_CLOEXEC );
+		const auto eof= chain.readFrom( pipe.fds[ 0 ] );
+		test.expect( eof and *eof == 0 );
+	};
+
+	"pipe_round_trip"_test <=[]( TestState test )
+	{
+		Pipe pipe;
+		Alepha::DataChain chain;
+		const std::string contents= buildFragmented( chain, IOV_MAX + 5 );
+		test.expect( contents.size() < std::size_t( ::fcntl( pipe.fds[ 1 ], F_GETPIPE_SZ ) ) );
+
+		while( chain.size() ) chain.writeTo( pipe.fds[ 1 ] );
+
+		Alepha::DataChain back;
+		while( back.size() < contents.size() ) test.expect( back.readFrom( pipe.fds[ 0 ], 100 ).value_or( 0 ) > 0 );
+		test.expect( textOf( back ) == contents );
+	};
+
+	"carve_chains"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		const std::string first( 100, 'a' ), second( 100, 'b' ), third( 100, 'c' );
+		appendText( chain, first );
+		appendText( chain, second );
+		appendText( chain, third );
+
+		auto head= chain.carveHead( 150 );
+		test.expect( textOf( head ) == first + second.substr( 0, 50 ) and head.chain_length() == 2 );
+		test.expect( chain.size() == 150 and chain.chain_length() == 2 );
+
+		auto tail= chain.carveTail( 120 );
+		test.expect( textOf( tail ) == second.substr( 50, 20 ) + third and tail.chain_length() == 2 );
+		test.expect( textOf( chain ) == second.substr( 20, 30 ) and chain.find( std::byte{ 'b' } ) == 0 );
+
+		try
+		{
+			std::ignore= chain.carveHead( 31 );
+			test.expect( false );
+		}
+		catch( const Alepha::DataCarveTooLargeError & ) {}
+		test.expect( chain.size() == 30 );
+	};
+
+	"carve_blobs"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		std::string contents;
+		for( const char c: { 'x', 'y', 'z' } )
+		{
+			appendText( chain, std::string( 100, c ) );
+			contents+= std::string( 100, c );
+		}
+
+		// Inside the first segment, a `Blob` is a slice of it.
+		const std::byte *const front= chain.chain_view().front().byte_data();
+		const Alepha::Blob slice= chain.carveHead< Alepha::Blob >( 60 );
+		test.expect( slice.byte_data() == front and textOf( slice ) == contents.substr( 0, 60 ) );
+
+		// The rest of that segment is the whole segment, moved out.
+		const std::byte *const rest= chain.chain_view().front().byte_data();
+		const Alepha::Blob whole= chain.carveHead< Alepha::Blob >( 40 );
+		test.expect( whole.byte_data() == rest and chain.chain_length() == 2 );
+
+		// Across segments, the bytes are copied.
+		const Alepha::Blob spanning= chain.carveTail< Alepha::Blob >( 150 );
+		test.expect( textOf( spanning ) == contents.substr( 150 ) );
+		test.expect( textOf( chain ) == contents.substr( 100, 50 ) and chain.chain_length() == 1 );
+
+		const Alepha::Blob last= chain.carveTail< Alepha::Blob >( 50 );
+		test.expect( last.size() == 50 and chain.size() == 0 and chain.chain_empty() );
+		test.expect( chain.carveHead< Alepha::Blob >( 0 ).size() == 0 );
+	};
+
+	"linearize"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		std::string contents;
+		for( int i= 0; i < 10; ++i )
+		{
+			const std::string piece( 64, static_cast< char >( 'a' + i ) );
+			appendText( chain, piece );
+			contents+= piece;
+		}
+
+		// Already contiguous, so nothing is copied.
+		const std::byte *const front= chain.chain_view().front().byte_data();
+		test.expect( chain.linearize( 64 ).byte_data() == front );
+
+		const auto view= chain.linearize( 200 );
+		test.expect( std::string( reinterpret_cast< const char * >( view.byte_data() ), view.size() ) == contents.substr( 0, 200 ) );
+		test.expect( chain.chain_length() == 8 and chain.size() == contents.size() );
+		test.expect( textOf( chain ) == contents );
+		test.expect( chain.find( std::byte{ 'd' } ) == 192 and chain.find( std::byte{ 'e' } ) == 256 );
+
+		chain.linearize( chain.size() );
+		test.expect( chain.chain_length() == 1 and textOf( chain ) == contents );
+	};
+
+	"linearize_failure_leaves_chain"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		const std::string first( 100, 'p' ), second( 100, 'q' );
+		appendText( chain, first );
+		appendText( chain, second );
+
+		FailingAllocator failing;
+		auto &original= Alepha::getDefaultAllocator();
+		Alepha::setDefaultAllocator( failing );
+		bool threw= false;
+		try
+		{
+			chain.linearize( 150 );
+		}
+		catch( const std::bad_alloc & ) { threw= true; }
+		Alepha::setDefaultAllocator( original );
+
+		test.expect( threw );
+		test.expect( chain.chain_length() == 2 and textOf( chain ) == first + second );
+	};
+
+	"index_and_iterators"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		std::string contents;
+		for( std::size_t length: { 1, 70, 3, 200, 1, 1, 64, 90 } )
+		{
+			const std::string piece( length, static_cast< char >( 'a' + contents.size() % 26 ) );
+			appendText( chain, piece );
+			contents+= piece;
+		}
+		test.expect( chain.size() == contents.size() and chain.end() - chain.begin() == std::ptrdiff_t( contents.size() ) );
+
+		bool same= true;
+		for( std::size_t i= 0; i < contents.size(); ++i ) same= same and chain.begin()[ i ] == std::byte( contents[ i ] );
+		test.expect( same );
+
+		// Stepping across segment boundaries, both ways.
+		auto it= chain.begin() + 70;
+		test.expect( *it == std::byte( contents[ 70 ] ) and *++it == std::byte( contents[ 71 ] ) );
+		test.expect( *--it == std::byte( contents[ 70 ] ) and *--it == std::byte( contents[ 69 ] ) );
+		test.expect( *( chain.end() - 1 ) == std::byte( contents.back() ) );
+		test.expect( chain.begin() + contents.size() == chain.end() );
+
+		// Writes go through mutable iterators, which convert to const ones.
+		*( chain.begin() + 300 )= std::byte{ '!' };
+		contents[ 300 ]= '!';
+		const Alepha::DataChain::const_iterator view= chain.begin() + 300;
+		test.expect( *view == std::byte{ '!' } and view < chain.cend() and view > chain.cbegin() );
+
+		// Consuming from the front moves the origin but leaves positions relative to the new front.
+		std::ignore= chain.carveHead( 72 );
+		contents.erase( 0, 72 );
+		test.expect( chain.size() == contents.size() and textOf( chain ) == contents );
+		test.expect( chain.begin()[ 200 ] == std::byte( contents[ 200 ] ) );
+
+		// Appends after consumption extend the same index.
+		appendText( chain, "tail" );
+		contents+= "tail";
+		test.expect( textOf( chain ) == contents and *( chain.end() - 4 ) == std::byte{ 't' } );
+	};
+
+	"find_across_segments"_test <=[]( TestState test )
+	{
+		const std::string contents= "GET / HTTP/1.1\r\nHost: example\r\n\r\nbody of the request, which ends here";
+
+		// Cut the same text up several ways, so that matches land inside segments and straddle their boundaries.
+		for( const std::size_t cut: { 1, 2, 3, 7, 64 } )
+		{
+			Alepha::DataChain chain;
+			for( std::size_t at= 0; at < contents.size(); at+= cut ) appendText( chain, contents.substr( at, cut ) );
+
+			bool same= true;
+			for( const std::string &pattern: { "\r\n\r\n"s, "\r\n"s, "body"s, "GET"s, "here"s, "missing"s, "e"s, ""s, contents, contents + "!" } )
+			{
+				const Alepha::Buffer< Alepha::Const > needle{ pattern.data(), pattern.size() };
+				for( std::size_t from: { 0, 1, 16, 30, 60 } )
+				{
+					const auto expected= contents.find( pattern, from );
+					same= same and chain.find( needle, from ) == ( expected == std::string::npos ? Alepha::DataChain::npos : expected );
+				}
+			}
+			test.expect( same );
+
+			test.expect( chain.find( std::byte{ ':' } ) == contents.find( ':' ) );
+			test.expect( chain.find( std::byte{ '\n' }, 16 ) == contents.find( '\n', 16 ) );
+			test.expect( chain.find( std::byte{ '~' } ) == Alepha::DataChain::npos );
+			test.expect( chain.find( std::byte{ 'G' }, contents.size() ) == Alepha::DataChain::npos );
+
+			const Alepha::ByteSet separators{ std::byte{ '\r' }, std::byte{ ',' } };
+			test.expect( chain.findAny( separators ) == contents.find_first_of( "\r," ) );
+			test.expect( chain.findAny( separators, 35 ) == contents.find_first_of( "\r,", 35 ) );
+			test.expect( chain.findAny( Alepha::ByteSet{ std::byte{ '~' } } ) == Alepha::DataChain::npos );
+		}
+	};
+
+	"compaction_on_append"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		test.expect( chain.compactionStatistics().compactions == 0 );
+		chain.setCompactionPolicy( { .minimumSegmentSize= 100, .maximumSegmentCount= 16 } );
+
+		const std::string contents= buildFragmented( chain, 1000 );
+		test.expect( textOf( chain ) == contents );
+
+		// Merged segments stop being small, so the chain can outgrow the maximum; the trigger backs off to keep
+		// the copying amortized, but the chain is still a small fraction of what was appended.
+		test.expect( chain.chain_length() < 100 );
+		const auto &statistics= chain.compactionStatistics();
+		test.expect( statistics.compactions > 0 and statistics.segmentsMerged > 900 );
+		test.expect( statistics.bytesCopied <= 2 * contents.size() );
+	};
+
+	"compaction_leaves_large_segments"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		std::string contents;
+		const auto add= [&]( const std::string &piece ) { appendText( chain, piece ); contents+= piece; };
+
+		add( std::string( 500, 'L' ) );
+		add( "a" );
+		add( "b" );
+		add( std::string( 500, 'M' ) );
+		add( "c" );
+		add( std::string( 500, 'N' ) );
+		add( "d" );
+		add( "e" );
+
+		chain.setCompactionPolicy( { .minimumSegmentSize= 100 } );
+		test.expect( chain.chain_length() == 8 );
+		chain.compact();
+
+		// Only the runs of small neighbours are merged.  The lone small segment is not worth copying.
+		test.expect( chain.chain_length() == 6 and textOf( chain ) == contents );
+		test.expect( chain.compactionStatistics().segmentsMerged == 4 and chain.compactionStatistics().bytesCopied == 4 );
+		test.expect( chain.find( std::byte{ 'e' } ) == contents.find( 'e' ) and chain.begin()[ 501 ] == std::byte{ 'b' } );
+
+		chain.compact();
+		test.expect( chain.compactionStatistics().compactions == 1 );
+	};
+
+	"compaction_skips_large_segments"_test <=[]( TestState test )
+	{
+		// Segments which are not small are never copied, however long the chain gets.
+		Alepha::DataChain chain;
+		chain.setCompactionPolicy( { .minimumSegmentSize= 10, .maximumSegmentCount= 4 } );
+		std::string contents;
+		for( int i= 0; i < 200; ++i )
+		{
+			const std::string piece( 60, static_cast< char >( 'a' + i % 26 ) );
+			appendText( chain, piece );
+			contents+= piece;
+		}
+		test.expect( chain.chain_length() == 200 and textOf( chain ) == contents );
+		test.expect( chain.compactionStatistics().compactions == 0 and chain.compactionStatistics().bytesCopied == 0 );
+	};
+
+	"compaction_trigger_comes_back_down"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		chain.setCompactionPolicy( { .minimumSegmentSize= 10, .maximumSegmentCount= 4 } );
+		for( int i= 0; i < 200; ++i ) appendText( chain, std::string( 60, 'x' ) );
+
+		// Once the large segments are consumed, a few small appends past the maximum compact again.
+		std::ignore= chain.carveHead( 198 * 60 );
+		test.expect( chain.chain_length() == 2 );
+		for( const char *const piece: { "a", "b", "c" } ) appendText( chain, piece );
+		test.expect( chain.compactionStatistics().compactions == 1 and chain.chain_length() == 3 );
+		test.expect( textOf( chain ) == std::string( 120, 'x' ) + "abc" );
+	};
+
+	"compaction_failure_keeps_append"_test <=[]( TestState test )
+	{
+		Alepha::DataChain chain;
+		chain.setCompactionPolicy( { .minimumSegmentSize= 100, .maximumSegmentCount= 4 } );
+		std::vector< Alepha::Blob > pieces;
+		for( const char *const piece: { "a", "b", "c", "d", "e" } ) pieces.push_back( blobOf( piece ) );
+
+		FailingAllocator failing;
+		auto &original= Alepha::getDefaultAllocator();
+		Alepha::setDefaultAllocator( failing );
+		bool threw= false;
+		try
+		{
+			for( auto &piece: pieces ) chain.append( piece );
+		}
+		catch( const std::bad_alloc & ) { threw= true; }
+		Alepha::setDefaultAllocator( original );
+
+		// The append which could not compact still happened, once, and said so.
+		test.expect( not threw and chain.chain_length() == 5 and textOf( chain ) == "abcde" );
+		test.expect( chain.compactionStatistics().compactions == 0 );
+	};
+};
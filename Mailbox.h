@@ -0,0 +1,316 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstddef>
+
+#include <atomic>
+#include <utility>
+#include <optional>
+#include <concepts>
+
+#include "Thread.h"
+
+namespace Alepha::inline Cavorite  ::detail::  mailbox
+{
+	inline namespace exports
+	{
+		template< typename Item > concept Weighted= requires( const Item &item )
+		{
+			{ mailboxWeight( item ) } -> std::convertible_to< std::size_t >;
+		};
+
+		template< typename Sink, typename Item > concept MailboxSink= requires( Sink &sink, Item &item )
+		{
+			sink.append( item );
+		};
+
+		template< Weighted Item > class Mailbox;
+	}
+
+	/*!
+	 * A multi-producer, single-consumer queue, bounded by total weight rather than by count.
+	 *
+	 * The weight of an item is `mailboxWeight( item )` -- for a `Blob` that is its size in bytes.  A producer
+	 * which would take the mailbox over its capacity waits until the consumer has taken enough out.  A single
+	 * item heavier than the whole capacity is still let in once the mailbox is empty, so that it cannot wedge.
+	 *
+	 * Pushing and popping are lock free while there is room and there are items: producers link onto an
+	 * intrusive list with one atomic exchange, and weight is reserved with a compare-and-swap.  The mutex is
+	 * only taken by threads which have to wait, and by whoever has to wake them.  Those waits are on an
+	 * `Alepha::ConditionVariable`, so an `Alepha::Thread` blocked in a mailbox can be interrupted with a
+	 * `Notification`.
+	 *
+	 * Only one thread may consume (`pop`, `tryPop`, `drainAll` and `tryDrainAll`) at a time.
+	 */
+	template< Weighted Item >
+	class exports::Mailbox
+	{
+		private:
+			struct Node
+			{
+				std::atomic< Node * > next= nullptr;
+				std::optional< Item > item;
+				std::size_t weight= 0;
+			};
+
+			// Producers exchange themselves in at the `head`; the consumer owns `tail`, which is always a node
+			// whose item has already been taken.
+			alignas( 64 ) std::atomic< Node * > head;
+			alignas( 64 ) Node *tail;
+
+			alignas( 64 ) std::atomic< std::size_t > load= 0;
+			const std::size_t capacity_;
+
+			std::atomic< bool > closed_= false;
+
+			Mutex access;
+			ConditionVariable spaceAvailable;
+			ConditionVariable itemAvailable;
+			std::atomic< std::size_t > producersWaiting= 0;
+			std::atomic< std::size_t > consumerWaiting= 0;
+
+			bool
+			reserve( const std::size_t weight ) noexcept
+			{
+				std::size_t current= load.load( std::memory_order_relaxed );
+				do
+				{
+					if( current and current + weight > capacity_ ) return false;
+				}
+				while( not load.compare_exchange_weak( current, current + weight ) );
+				return true;
+			}
+
+			void
+			link( Item &&item, const std::size_t weight )
+			{
+				Node *const node= new Node;
+				node->item.emplace( std::move( item ) );
+				node->weight= weight;
+				head.exchange( node, std::memory_order_acq_rel )->next.store( node, std::memory_order_release );
+				wake( consumerWaiting, itemAvailable );
+			}
+
+			// The waiter counts its interest before checking its condition under the lock, and the waker changes
+			// the state before checking for interest.  So either the waiter sees the change, or the waker sees the
+			// waiter and takes the lock, which it can only get once the waiter is really waiting.  The state changes
+			// (such as `link`'s release store) are weaker than sequentially consistent, so both sides fence between
+			// their store and their load.
+			void
+			wake( std::atomic< std::size_t > &waiting, ConditionVariable &condition )
+			{
+				std::atomic_thread_fence( std::memory_order_seq_cst );
+				if( not waiting.load( std::memory_order_relaxed ) ) return;
+				{ lock_guard lock( access ); }
+				condition.notify_all();
+			}
+
+			template< typename Predicate >
+			void
+			waitFor( std::atomic< std::size_t > &waiting, ConditionVariable &condition, Predicate predicate )
+			{
+				unique_lock lock( access );
+				++waiting;
+				std::atomic_thread_fence( std::memory_order_seq_cst );
+				try
+				{
+					condition.wait( lock, predicate );
+				}
+				catch( ... )
+				{
+					--waiting;
+					throw;
+				}
+				--waiting;
+			}
+
+			bool ready() const noexcept { return tail->next.load( std::memory_order_acquire ); }
+
+			// Unlinks the next item, without giving back its weight.
+			Node *
+			unlink() noexcept
+			{
+				Node *const next= tail->next.load( std::memory_order_acquire );
+				if( not next ) return nullptr;
+				delete tail;
+				tail= next;
+				return next;
+			}
+
+			void
+			release( const std::size_t weight )
+			{
+				if( not weight ) return;
+				load.fetch_sub( weight );
+				wake( producersWaiting, spaceAvailable );
+			}
+
+		public:
+			/*!
+			 * @param capacity The total weight which the mailbox holds before producers have to wait.
+			 */
+			explicit
+			Mailbox( const std::size_t capacity )
+				: head( new Node ), tail( head.load() ), capacity_( capacity )
+			{}
+
+			Mailbox( const Mailbox & )= delete;
+			Mailbox &operator= ( const Mailbox & )= delete;
+
+			~Mailbox()
+			{
+				while( unlink() );
+				delete tail;
+			}
+
+			std::size_t capacity() const noexcept { return capacity_; }
+
+			/*!
+			 * The weight of the items which are in the mailbox, or which are on their way in.
+			 */
+			std::size_t weight() const noexcept { return load.load(); }
+
+			/*!
+			 * Stop accepting items.
+			 *
+			 * Producers waiting for room, and any later pushes, fail.  The consumer still gets everything which
+			 * was already in the mailbox, after which `pop` returns nothing rather than waiting.
+			 */
+			void
+			close()
+			{
+				closed_= true;
+				{ lock_guard lock( access ); }
+				spaceAvailable.notify_all();
+				itemAvailable.notify_all();
+			}
+
+			bool closed() const noexcept { return closed_.load(); }
+
+			/*!
+			 * Add `item`, if there is room for it right now.
+			 *
+			 * @return Whether `item` was taken.  If it was not, then it has not been moved from.
+			 */
+			bool
+			tryPush( Item &&item )
+			{
+				const std::size_t weight= mailboxWeight( std::as_const( item ) );
+				if( closed() or not reserve( weight ) ) return false;
+				link( std::move( item ), weight );
+				return true;
+			}
+
+			/*!
+			 * Add `item`, waiting for room for it if need be.
+			 *
+			 * @return Whether `item` was taken.  It is only refused if the mailbox is closed.
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 */
+			bool
+			push( Item &&item )
+			{
+				const std::size_t weight= mailboxWeight( std::as_const( item ) );
+				if( closed() ) return false;
+				// Once room is reserved, the item goes in even if `close` races in meanwhile -- it was pushed first.
+				while( not reserve( weight ) )
+				{
+					waitFor( producersWaiting, spaceAvailable, [&]
+					{
+						const std::size_t current= load.load();
+						return closed() or not current or current + weight <= capacity_;
+					} );
+					if( closed() ) return false;
+				}
+				link( std::move( item ), weight );
+				return true;
+			}
+
+			/*!
+			 * Take the oldest item, if there is one.
+			 */
+			std::optional< Item >
+			tryPop()
+			{
+				Node *const node= unlink();
+				if( not node ) return std::nullopt;
+				std::optional< Item > rv= std::move( node->item );
+				node->item.reset();
+				release( node->weight );
+				return rv;
+			}
+
+			/*!
+			 * Take the oldest item, waiting for one if need be.
+			 *
+			 * @return The item, or nothing once the mailbox is closed and empty.
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 */
+			std::optional< Item >
+			pop()
+			{
+				while( not ready() and not closed() )
+				{
+					waitFor( consumerWaiting, itemAvailable, [&]{ return ready() or closed(); } );
+				}
+				return tryPop();
+			}
+
+			/*!
+			 * Move every item which is in the mailbox now into `sink`, by `sink.append( item )`.
+			 *
+			 * For a `Mailbox< Blob >`, the sink is typically a `DataChain`.  The weight of the whole batch is given
+			 * back at once, so producers are woken once per batch rather than once per item.
+			 *
+			 * @return The number of items moved.
+			 */
+			template< MailboxSink< Item > Sink >
+			std::size_t
+			tryDrainAll( Sink &sink )
+			{
+				std::size_t count= 0;
+				std::size_t weight= 0;
+				try
+				{
+					while( Node *const node= unlink() )
+					{
+						weight+= node->weight;
+						Item item= std::move( *node->item );
+						node->item.reset();
+						sink.append( item );
+						++count;
+					}
+				}
+				catch( ... )
+				{
+					release( weight );
+					throw;
+				}
+				release( weight );
+				return count;
+			}
+
+			/*!
+			 * As `tryDrainAll`, but first waits until there is at least one item.
+			 *
+			 * @return The number of items moved, which is only zero once the mailbox is closed and empty.
+			 * @throw Notification When the calling `Alepha::Thread` is interrupted while waiting.
+			 */
+			template< MailboxSink< Item > Sink >
+			std::size_t
+			drainAll( Sink &sink )
+			{
+				while( not ready() and not closed() )
+				{
+					waitFor( consumerWaiting, itemAvailable, [&]{ return ready() or closed(); } );
+				}
+				return tryDrainAll( sink );
+			}
+	};
+}
+
+namespace Alepha::Cavorite::inline exports::inline mailbox
+{
+	using namespace detail::mailbox::exports;
+}
@@ -0,0 +1,151 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Mailbox.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	// A stand-in for `Blob`: weighs its length.
+	struct Message
+	{
+		std::string text;
+
+		friend std::size_t mailboxWeight( const Message &m ) noexcept { return m.text.size(); }
+	};
+
+	struct Sink
+	{
+		std::vector< std::string > received;
+
+		void append( Message &m ) { received.push_back( std::move( m.text ) ); }
+	};
+
+	using StopNotification= Alepha::create_exception< struct stop_notification, Alepha::Notification >;
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"weight_bound"_test <=[]( TestState test )
+	{
+		Alepha::Mailbox< Message > mailbox{ 10 };
+		test.expect( mailbox.tryPush( { "abcd" } ) );
+		test.expect( mailbox.tryPush( { "efgh" } ) );
+		test.expect( mailbox.weight() == 8 );
+
+		Message refused{ "ijk" };
+		test.expect( not mailbox.tryPush( std::move( refused ) ) );
+		test.expect( refused.text == "ijk" );
+		test.expect( mailbox.tryPush( { "ij" } ) );
+
+		test.expect( mailbox.tryPop()->text == "abcd" );
+		test.expect( mailbox.weight() == 6 );
+		test.expect( mailbox.tryPush( std::move( refused ) ) );
+
+		Sink sink;
+		test.expect( mailbox.tryDrainAll( sink ) == 3 );
+		test.expect( sink.received == std::vector< std::string >{ "efgh", "ij", "ijk" } );
+		test.expect( mailbox.weight() == 0 );
+		test.expect( not mailbox.tryPop() );
+	};
+
+	"oversized_item"_test <=[]( TestState test )
+	{
+		Alepha::Mailbox< Message > mailbox{ 4 };
+		test.expect( mailbox.tryPush( { "far too heavy" } ) );
+		test.expect( not mailbox.tryPush( { "x" } ) );
+		test.expect( mailbox.tryPop()->text == "far too heavy" );
+		test.expect( mailbox.tryPush( { "x" } ) );
+	};
+
+	"producers_and_consumer"_test <=[]( TestState test )
+	{
+		const int producers= 4;
+		const int perProducer= 5000;
+		Alepha::Mailbox< Message > mailbox{ 64 };
+
+		std::vector< std::unique_ptr< Alepha::Thread > > threads;
+		for( int p= 0; p < producers; ++p )
+		{
+			threads.push_back( std::make_unique< Alepha::Thread >( [&mailbox, p]
+			{
+				for( int i= 0; i < perProducer; ++i ) mailbox.push( { std::to_string( p ) + ":" + std::to_string( i ) } );
+			} ) );
+		}
+
+		// Each producer's messages must arrive in the order it sent them.
+		std::vector< int > next( producers );
+		int received= 0;
+		bool ordered= true;
+		Sink sink;
+		while( received < producers * perProducer )
+		{
+			sink.received.clear();
+			received+= mailbox.drainAll( sink );
+			for( const auto &text: sink.received )
+			{
+				const auto colon= text.find( ':' );
+				const int p= std::stoi( text.substr( 0, colon ) );
+				ordered= ordered and std::stoi( text.substr( colon + 1 ) ) == next[ p ]++;
+			}
+			test.expect( mailbox.weight() <= mailbox.capacity() );
+		}
+		for( auto &thread: threads ) thread->join();
+
+		test.expect( ordered );
+		test.expect( not mailbox.tryPop() );
+	};
+
+	"interruptible_wait"_test <=[]( TestState test )
+	{
+		Alepha::Mailbox< Message > mailbox{ 4 };
+		mailbox.push( { "full" } );
+
+		std::atomic< bool > started= false;
+		bool interrupted= false;
+		Alepha::Thread producer{ [&]
+		{
+			started= true;
+			try { mailbox.push( { "more" } ); }
+			catch( const StopNotification & ) { interrupted= true; }
+		} };
+
+		// The interruption is held until the producer reaches its wait, so it need only have started.
+		while( not started ) std::this_thread::yield();
+		producer.interrupt( Alepha::build_exception< StopNotification >( "stop" ) );
+		producer.join();
+
+		test.expect( interrupted );
+		test.expect( mailbox.weight() == 4 );
+	};
+
+	"close"_test <=[]( TestState test )
+	{
+		Alepha::Mailbox< Message > mailbox{ 4 };
+		mailbox.push( { "last" } );
+
+		bool refused= false;
+		Alepha::Thread producer{ [&]{ refused= not mailbox.push( { "late" } ); } };
+		mailbox.close();
+		producer.join();
+
+		test.expect( refused );
+		test.expect( not mailbox.tryPush( { "" } ) );
+		test.expect( mailbox.pop()->text == "last" );
+		test.expect( not mailbox.pop() );
+	};
+};
@@ -0,0 +1,323 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstddef>
+
+#include <limits>
+#include <stdexcept>
+#include <filesystem>
+#include <system_error>
+
+#include "AutoRAII.h"
+#include "BlobStorage.h"
+#include "error.h"
+
+namespace Alepha::inline Cavorite  ::detail::  mapped_storage
+{
+	inline namespace exports
+	{
+		enum class MapMode;
+		enum class AccessAdvice;
+
+		struct MappedRegion;
+
+		MappedRegion mapAnonymousRegion( std::size_t length, std::size_t alignment= 0, bool hugePages= false );
+		MappedRegion mapMirroredRegion( std::size_t length );
+
+		constexpr std::size_t wholeFile= std::numeric_limits< std::size_t >::max();
+	}
+
+	namespace C
+	{
+		const bool debug= false;
+		const bool debugMappings= false or C::debug;
+	}
+
+	/*!
+	 * How a file region is mapped.
+	 *
+	 *  * `ReadOnly`: The pages are mapped for reading only, and writing to them faults.  So the mapping always
+	 *    matches the file, and can stand for it: with `keepFileSource`, `transferTo` sends it straight from the
+	 *    file.  As `Blob` objects hand out writable views, `Blob::mapFileReadOnly` gives a `const` one.  Use
+	 *    `Private` for data which is meant to be modified.
+	 *
+	 *  * `Private`: The pages are readable and writable, but writes are private copy-on-write pages.  The file is
+	 *    never modified.  Pages which are never written cost nothing extra.
+	 *
+	 *  * `Shared`: Writes go through to the file.  The file must be opened for writing.
+	 */
+	enum class exports::MapMode { ReadOnly, Private, Shared };
+
+	/*!
+	 * Access pattern hints for mapped memory, passed to `madvise`.
+	 */
+	enum class exports::AccessAdvice { Normal, Sequential, Random, WillNeed, DontNeed };
+
+	class MappedStorage final
+		: public BlobStorage
+	{
+		private:
+			void *const address;
+			const std::size_t extent;
+			const FileSource source;
+			const bool privately;
+
+			void
+			dispose() noexcept override
+			{
+				if( C::debugMappings ) error() << "Unmapping " << extent << " bytes at " << address << std::endl;
+				::munmap( address, extent );
+				if( source.fd != -1 ) ::close( source.fd );
+				delete this;
+			}
+
+		public:
+			explicit
+			MappedStorage( void *const address, const std::size_t extent, const bool privately, const FileSource source= {} ) noexcept
+				: address( address ), extent( extent ), source( source ), privately( privately )
+			{}
+
+			const FileSource *fileSource() const noexcept override { return source.fd == -1 ? nullptr : &source; }
+
+			bool privateMapping() const noexcept override { return privately; }
+	};
+
+	struct exports::MappedRegion
+	{
+		StorageReference storage;
+		std::byte *data= nullptr;
+		std::size_t length= 0;
+	};
+
+	inline int
+	adviceFlag( const AccessAdvice advice ) noexcept
+	{
+		switch( advice )
+		{
+			case AccessAdvice::Normal: return MADV_NORMAL;
+			case AccessAdvice::Sequential: return MADV_SEQUENTIAL;
+			case AccessAdvice::Random: return MADV_RANDOM;
+			case AccessAdvice::WillNeed: return MADV_WILLNEED;
+			case AccessAdvice::DontNeed: return MADV_DONTNEED;
+		}
+		return MADV_NORMAL;
+	}
+
+	namespace exports
+	{
+		/*!
+		 * Pass an access pattern hint for some mapped memory to the kernel.
+		 *
+		 * `madvise` works on whole pages, so the range is shrunk to the pages which lie wholly inside it.  Advice
+		 * never reaches memory outside the range, which may belong to someone else, but it is not given at all for a
+		 * range which holds no whole page.  Hints are advisory, so failures are ignored.
+		 *
+		 * @note `AccessAdvice::DontNeed` on a private mapping discards any private writes in the range, and on
+		 * anonymous memory it discards the data.  `Blob::advise` only allows it where that cannot be seen.
+		 */
+		inline void
+		adviseAccess( const void *const data, const std::size_t length, const AccessAdvice advice ) noexcept
+		{
+			const std::uintptr_t pageSize= ::sysconf( _SC_PAGESIZE );
+			const std::uintptr_t start= reinterpret_cast< std::uintptr_t >( data );
+			const std::uintptr_t first= ( start + pageSize - 1 ) / pageSize * pageSize;
+			const std::uintptr_t last= ( start + length ) / pageSize * pageSize;
+			if( first >= last ) return;
+			::madvise( reinterpret_cast< void * >( first ), last - first, adviceFlag( advice ) );
+		}
+
+		/*!
+		 * Map a region of a file into memory, as counted `Blob` storage.
+		 *
+		 * The mapping lives until the last reference to its storage is dropped, at which point it is unmapped.  The
+		 * file itself need not stay open, unless `keepFileSource` is asked for.
+		 *
+		 * @param path The file to map.
+		 * @param offset The byte offset of the region in the file.  It need not be page aligned.
+		 * @param length The number of bytes to map, or `wholeFile` for everything from `offset` to the end.
+		 * @param mode How the pages are mapped -- see `MapMode`.
+		 * @param advice An initial access pattern hint for the region.
+		 * @param keepFileSource Keep a descriptor for the file, as the storage's `fileSource`, so that `transferTo`
+		 * can send the region from the file without copying.  That costs a descriptor per mapping, held for as long
+		 * as the mapping is, so it is only done on request.  It has no effect on `Private` mappings, which may come
+		 * to differ from the file.
+		 *
+		 * @throw std::system_error if the file cannot be opened or mapped.
+		 * @throw std::out_of_range if the region extends past the end of the file.
+		 */
+		inline MappedRegion
+		mapFileRegion( const std::filesystem::path &path, const std::size_t offset, std::size_t length,
+				const MapMode mode, const AccessAdvice advice= AccessAdvice::Normal, const bool keepFileSource= false )
+		{
+			AutoRAII fd{ [&]{ return ::open( path.c_str(), ( mode == MapMode::Shared ? O_RDWR : O_RDONLY ) | O_CLOEXEC ); }, ::close };
+			if( fd == -1 ) throw std::system_error{ errno, std::generic_category(), "Unable to open `" + path.string() + "` for mapping" };
+
+			struct stat status;
+			if( ::fstat( fd, &status ) == -1 ) throw std::system_error{ errno, std::generic_category(), "Unable to stat `" + path.string() + "`" };
+			const std::size_t fileSize= status.st_size;
+
+			if( offset > fileSize ) throw std::out_of_range{ "Tried to map from offset " + std::to_string( offset ) + " of `" + path.string() + "`, which is only " + std::to_string( fileSize ) + " bytes long." };
+			if( length == wholeFile ) length= fileSize - offset;
+			if( length > fileSize - offset ) throw std::out_of_range{ "Tried to map " + std::to_string( length ) + " bytes from offset " + std::to_string( offset ) + " of `" + path.string() + "`, which is only " + std::to_string( fileSize ) + " bytes long." };
+			if( length == 0 ) return {};
+
+			// `mmap` offsets must be page aligned, so we map a little in front and point past it.
+			const std::size_t pageSize= ::sysconf( _SC_PAGESIZE );
+			const std::size_t slack= offset % pageSize;
+			const std::size_t extent= slack + length;
+
+			const int protection= mode == MapMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+			const int flags= mode == MapMode::Shared ? MAP_SHARED : MAP_PRIVATE;
+			void *const address= ::mmap( nullptr, extent, protection, flags, fd, offset - slack );
+			if( address == MAP_FAILED ) throw std::system_error{ errno, std::generic_category(), "Unable to map `" + path.string() + "`" };
+
+			// A private mapping may come to differ from the file, so only the others can stand for it.  Without a
+			// descriptor of its own, the storage simply has no `fileSource`.
+			FileSource source;
+			if( keepFileSource and mode != MapMode::Private and ( source.fd= ::fcntl( fd, F_DUPFD_CLOEXEC, 0 ) ) != -1 )
+			{
+				source.base= static_cast< const std::byte * >( address );
+				source.offset= offset - slack;
+			}
+
+			MappedRegion rv;
+			try
+			{
+				rv.storage= StorageReference{ new MappedStorage( address, extent, mode != MapMode::Shared, source ) };
+			}
+			catch( ... )
+			{
+				::munmap( address, extent );
+				if( source.fd != -1 ) ::close( source.fd );
+				throw;
+			}
+			if( C::debugMappings ) error() << "Mapped " << extent << " bytes of `" << path.string() << "` at " << address << std::endl;
+
+			rv.data= static_cast< std::byte * >( address ) + slack;
+			rv.length= length;
+			if( advice != AccessAdvice::Normal ) adviseAccess( rv.data, rv.length, advice );
+			return rv;
+		}
+	}
+
+	/*!
+	 * Map fresh anonymous memory, as counted `Blob` storage.
+	 *
+	 * Anonymous pages are zero filled by the kernel lazily, on first touch, so large zeroed buffers cost nothing
+	 * until they are used.
+	 *
+	 * @param length The number of bytes to map.
+	 * @param alignment When nonzero, a power of two (larger than a page) to align the start of the mapping to.
+	 * @param hugePages Ask the kernel to back the mapping with transparent huge pages.
+	 *
+	 * @throw std::system_error if the memory cannot be mapped.
+	 */
+	inline MappedRegion
+	exports::mapAnonymousRegion( const std::size_t length, const std::size_t alignment, const bool hugePages )
+	{
+		if( length == 0 ) return {};
+
+		// To align the mapping, we over-map and trim the excess from both ends.
+		const std::size_t pageSize= ::sysconf( _SC_PAGESIZE );
+		const std::size_t extent= ( length + pageSize - 1 ) / pageSize * pageSize;
+		const std::size_t padding= alignment > pageSize ? alignment : 0;
+
+		void *const mapped= ::mmap( nullptr, extent + padding, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+		if( mapped == MAP_FAILED ) throw std::system_error{ errno, std::generic_category(), "Unable to map " + std::to_string( length ) + " anonymous bytes" };
+
+		std::byte *address= static_cast< std::byte * >( mapped );
+		if( padding )
+		{
+			const std::size_t head= ( alignment - reinterpret_cast< std::uintptr_t >( mapped ) % alignment ) % alignment;
+			if( head ) ::munmap( address, head );
+			if( padding - head ) ::munmap( address + head + extent, padding - head );
+			address+= head;
+		}
+
+		if( hugePages ) ::madvise( address, extent, MADV_HUGEPAGE );
+
+		MappedRegion rv;
+		try
+		{
+			rv.storage= StorageReference{ new MappedStorage( address, extent, true ) };
+		}
+		catch( ... )
+		{
+			::munmap( address, extent );
+			throw;
+		}
+		if( C::debugMappings ) error() << "Mapped " << extent << " anonymous bytes at " << static_cast< void * >( address ) << std::endl;
+
+		rv.data= address;
+		rv.length= length;
+		return rv;
+	}
+
+	/*!
+	 * Map fresh memory twice, back to back, as counted `Blob` storage.
+	 *
+	 * The `length` bytes at `data` appear again at `data + length`, because both halves are mappings of the same
+	 * anonymous file.  So any run of up to `length` bytes starting in the first half is contiguous, even where it
+	 * wraps around -- which is what a ring buffer wants.
+	 *
+	 * @param length The number of distinct bytes.  It is rounded up to a whole number of pages, and the region's
+	 * `length` is the rounded size.  The mapping itself is twice that.
+	 *
+	 * @throw std::system_error if the memory cannot be created or mapped.
+	 */
+	inline MappedRegion
+	exports::mapMirroredRegion( const std::size_t length )
+	{
+		if( length == 0 ) return {};
+
+		const std::size_t pageSize= ::sysconf( _SC_PAGESIZE );
+		const std::size_t extent= ( length + pageSize - 1 ) / pageSize * pageSize;
+
+		AutoRAII fd{ []{ return ::memfd_create( "Alepha mirrored region", MFD_CLOEXEC ); }, ::close };
+		if( fd == -1 ) throw std::system_error{ errno, std::generic_category(), "Unable to create a mirrored region" };
+		if( ::ftruncate( fd, extent ) == -1 ) throw std::system_error{ errno, std::generic_category(), "Unable to size a mirrored region of " + std::to_string( extent ) + " bytes" };
+
+		// Reserve the whole span first, so that nothing else can land between the two halves.
+		void *const reserved= ::mmap( nullptr, 2 * extent, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+		if( reserved == MAP_FAILED ) throw std::system_error{ errno, std::generic_category(), "Unable to reserve a mirrored region of " + std::to_string( extent ) + " bytes" };
+
+		std::byte *const address= static_cast< std::byte * >( reserved );
+		for( std::byte *const half: { address, address + extent } )
+		{
+			if( ::mmap( half, extent, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) == MAP_FAILED )
+			{
+				const int failure= errno;
+				::munmap( reserved, 2 * extent );
+				throw std::system_error{ failure, std::generic_category(), "Unable to map a mirrored region of " + std::to_string( extent ) + " bytes" };
+			}
+		}
+
+		MappedRegion rv;
+		try
+		{
+			rv.storage= StorageReference{ new MappedStorage( address, 2 * extent, false ) };
+		}
+		catch( ... )
+		{
+			::munmap( address, 2 * extent );
+			throw;
+		}
+		if( C::debugMappings ) error() << "Mapped " << extent << " mirrored bytes at " << static_cast< void * >( address ) << std::endl;
+
+		rv.data= address;
+		rv.length= extent;
+		return rv;
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline mapped_storage
+{
+	using namespace detail::mapped_storage::exports;
+}
@@ -0,0 +1,171 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../MappedStorage.h"
+#include "../Blob.h"
+
+#include <unistd.h>
+
+#include <cstring>
+
+#include <fstream>
+#include <string>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	std::filesystem::path
+	makeFile( const std::string &contents )
+	{
+		const auto path= std::filesystem::temp_directory_path() / ( "alepha-mapped-storage-" + std::to_string( ::getpid() ) );
+		std::ofstream{ path, std::ios::binary } << contents;
+		return path;
+	}
+
+	std::string
+	text( const Alepha::MappedRegion &region )
+	{
+		return { reinterpret_cast< const char * >( region.data ), region.length };
+	}
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	using Alepha::MapMode;
+	using Alepha::AccessAdvice;
+	using Alepha::mapFileRegion;
+
+	"mapped_storage.whole_file"_test <=[]( TestState test )
+	{
+		const auto path= makeFile( "Hello, mapped world!" );
+		const auto region= mapFileRegion( path, 0, Alepha::wholeFile, MapMode::ReadOnly, AccessAdvice::Sequential );
+		test.expect( text( region ) == "Hello, mapped world!" );
+		test.expect( region.storage->useCount() == 1 );
+		std::filesystem::remove( path );
+	};
+
+	"mapped_storage.unaligned_offset"_test <=[]( TestState test )
+	{
+		std::string contents( 10'000, 'x' );
+		contents.replace( 5000, 5, "abcde" );
+		const auto path= makeFile( contents );
+
+		const auto region= mapFileRegion( path, 5000, 5, MapMode::Private );
+		test.expect( text( region ) == "abcde" );
+		std::filesystem::remove( path );
+	};
+
+	"mapped_storage.outlives_file_and_copies"_test <=[]( TestState test )
+	{
+		const auto path= makeFile( "persistent" );
+		Alepha::StorageReference kept;
+		const std::byte *data= nullptr;
+		{
+			auto region= mapFileRegion( path, 0, Alepha::wholeFile, MapMode::Private, AccessAdvice::WillNeed );
+			kept= region.storage;
+			data= region.data;
+			test.expect( region.storage->useCount() == 2 );
+		}
+		std::filesystem::remove( path );
+		test.expect( kept->useCount() == 1 );
+		test.expect( std::memcmp( data, "persistent", 10 ) == 0 );
+	};
+
+	"mapped_storage.private_writes_stay_private"_test <=[]( TestState test )
+	{
+		const auto path= makeFile( "original" );
+		{
+			const auto region= mapFileRegion( path, 0, Alepha::wholeFile, MapMode::Private );
+			std::memcpy( region.data, "modified", 8 );
+			test.expect( text( region ) == "modified" );
+		}
+		test.expect( text( mapFileRegion( path, 0, Alepha::wholeFile, MapMode::ReadOnly ) ) == "original" );
+		std::filesystem::remove( path );
+	};
+
+	"mapped_storage.read_only_is_const"_test <=[]( TestState test )
+	{
+		const auto path= makeFile( "original" );
+		static_assert( std::is_same_v< decltype( Alepha::Blob::mapFileReadOnly( path ) ), const Alepha::Blob > );
+
+		const auto blob= Alepha::Blob::mapFileReadOnly( path );
+		const Alepha::Buffer< Alepha::Const > view= blob;
+		test.expect( std::memcmp( view.byte_data(), "original", 8 ) == 0 and view.size() == 8 );
+
+		bool refused= false;
+		try { std::ignore= Alepha::Blob::mapFile( path, 0, Alepha::wholeFile, MapMode::ReadOnly ); }
+		catch( const std::invalid_argument & ) { refused= true; }
+		test.expect( refused );
+		std::filesystem::remove( path );
+	};
+
+	"mapped_storage.dont_need_only_inside_owned_private_pages"_test <=[]( TestState test )
+	{
+		const std::size_t pageSize= ::sysconf( _SC_PAGESIZE );
+		auto blob= Alepha::Blob::adopt( Alepha::mapAnonymousRegion( 3 * pageSize ) );
+		std::memset( blob.byte_data(), 'x', blob.size() );
+
+		// Not while anyone else can see the bytes.
+		{
+			const auto slice= blob.carveHead( 1 );
+			test.expect( not blob.advise( AccessAdvice::DontNeed ) );
+			test.expect( blob.byte_data()[ blob.size() - 1 ] == std::byte{ 'x' } );
+		}
+
+		// Now that this `Blob` is the only one, only the pages wholly inside it are dropped.
+		test.expect( blob.storageReference()->useCount() == 1 );
+		test.expect( blob.advise( AccessAdvice::DontNeed ) );
+		test.expect( blob.byte_data()[ 0 ] == std::byte{ 'x' } and blob.byte_data()[ pageSize - 2 ] == std::byte{ 'x' } );
+		test.expect( blob.byte_data()[ pageSize - 1 ] == std::byte{} and blob.byte_data()[ blob.size() - 1 ] == std::byte{} );
+
+		// Nor for memory which is not a private mapping.
+		Alepha::Blob heap{ 10 * pageSize };
+		test.expect( not heap.advise( AccessAdvice::DontNeed ) and heap.advise( AccessAdvice::WillNeed ) );
+		const auto shared= makeFile( std::string( pageSize, 's' ) );
+		auto mapped= Alepha::Blob::mapFile( shared, 0, Alepha::wholeFile, MapMode::Shared );
+		test.expect( not mapped.advise( AccessAdvice::DontNeed ) );
+		std::filesystem::remove( shared );
+	};
+
+	"mapped_storage.shared_writes_reach_the_file"_test <=[]( TestState test )
+	{
+		const auto path= makeFile( "original" );
+		{
+			const auto region= mapFileRegion( path, 0, Alepha::wholeFile, MapMode::Shared );
+			std::memcpy( region.data, "modified", 8 );
+		}
+		test.expect( text( mapFileRegion( path, 0, Alepha::wholeFile, MapMode::ReadOnly ) ) == "modified" );
+		std::filesystem::remove( path );
+	};
+
+	"mapped_storage.errors"_test <=[]( TestState test )
+	{
+		const auto path= makeFile( "short" );
+		try
+		{
+			std::ignore= mapFileRegion( path, 2, 10, MapMode::ReadOnly );
+			test.expect( false, "Mapping past the end should throw" );
+		}
+		catch( const std::out_of_range & ) {}
+
+		test.expect( not mapFileRegion( path, 5, Alepha::wholeFile, MapMode::ReadOnly ).storage );
+		std::filesystem::remove( path );
+
+		try
+		{
+			std::ignore= mapFileRegion( path, 0, 1, MapMode::ReadOnly );
+			test.expect( false, "Mapping a missing file should throw" );
+		}
+		catch( const std::system_error & ) {}
+	};
+};
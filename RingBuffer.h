@@ -0,0 +1,193 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstddef>
+
+#include <span>
+#include <algorithm>
+#include <string>
+#include <concepts>
+#include <stdexcept>
+
+#include "Buffer.h"
+#include "BlobStorage.h"
+#include "MappedStorage.h"
+
+namespace Alepha::inline Cavorite  ::detail::  ring_buffer
+{
+	// Anything built from a pointer and a length -- `Buffer`, or `std::span`.
+	template< typename Window, typename Pointer >
+	concept WindowOf= std::constructible_from< Window, Pointer, std::size_t >;
+
+	inline namespace exports
+	{
+		class RingBuffer;
+		class RingOverrunError;
+	}
+
+	/*!
+	 * Thrown when more bytes are committed or consumed than a `RingBuffer` has room or data for.
+	 */
+	class exports::RingOverrunError
+		: public virtual OutOfRangeError
+	{
+		public:
+			explicit
+			RingOverrunError( const std::string &action, const void *const location, const std::size_t requested, const std::size_t available )
+				: std::out_of_range( "Tried to " + action + " " + stringify( requested ) + " bytes of a ring buffer at location "
+						+ stringify( location ) + ", but only " + stringify( available ) + " are available." ),
+				OutOfRangeError( location, requested, available )
+			{}
+	};
+
+	/*!
+	 * A byte ring buffer whose readable and writable regions are always contiguous.
+	 *
+	 * The storage is a `mapMirroredRegion`: the same pages mapped twice, back to back.  So the bytes which wrap
+	 * around the end of the ring are also right after it, and a parser never has to handle a frame split in two.
+	 *
+	 * Producing is `writable` then `commit`; consuming is `readable` then `consume`.  The windows are `Buffer`s (or
+	 * anything else built from a pointer and a length), and stay valid until the next `commit` or `consume`.
+	 *
+	 * Consumed bytes can also be kept, without copying, by `carveHead`.  It gives a counted reference to the ring's
+	 * own storage, from which a `Blob` can be made.  While any reference to its storage besides its own is alive, the
+	 * ring writes over nothing from the oldest carved byte on, so holding slices leaves it less room.
+	 *
+	 * @note A `RingBuffer` is not thread safe.
+	 */
+	class exports::RingBuffer
+	{
+		private:
+			MappedRegion region;
+
+			// Offsets from `region.data`.  `head` is always in the first half, and `tail` is at most one ring ahead.
+			std::size_t head= 0;
+			std::size_t tail= 0;
+
+			// Where the oldest carved bytes start, while any carved slices may still be held.  This can be up to a
+			// ring behind `head`, and so below zero once `head` wraps; the offset arithmetic is modular.
+			std::size_t pinned= 0;
+			bool carved= false;
+
+			// The start of the bytes which must not be written over.
+			std::size_t
+			keep() const noexcept
+			{
+				if( carved and region.storage->useCount() > 1 ) return pinned;
+				return head;
+			}
+
+			void
+			advanceHead( const std::size_t amount ) noexcept
+			{
+				head+= amount;
+				if( head >= capacity() )
+				{
+					head-= capacity();
+					tail-= capacity();
+					if( carved ) pinned-= capacity();
+				}
+			}
+
+		public:
+			/*!
+			 * @param capacity The minimum number of bytes the ring holds.  It is rounded up to a whole number of pages.
+			 *
+			 * @throw std::system_error if the storage cannot be mapped.
+			 */
+			explicit RingBuffer( const std::size_t capacity ) : region( mapMirroredRegion( std::max< std::size_t >( capacity, 1 ) ) ) {}
+
+			RingBuffer( const RingBuffer & )= delete;
+			RingBuffer &operator= ( const RingBuffer & )= delete;
+
+			std::size_t capacity() const noexcept { return region.length; }
+
+			// The number of bytes committed and not yet consumed.
+			std::size_t size() const noexcept { return tail - head; }
+			bool empty() const noexcept { return tail == head; }
+
+			// The number of bytes which can be committed now.
+			std::size_t
+			room() noexcept
+			{
+				if( carved and region.storage->useCount() == 1 ) carved= false;
+				return capacity() - ( tail - keep() );
+			}
+
+			/*!
+			 * All the room there is to write into, in one piece.
+			 */
+			template< WindowOf< std::byte * > Window= std::span< std::byte > >
+			Window
+			writable() noexcept
+			{
+				const std::size_t amount= room();
+				return Window( region.data + tail, amount );
+			}
+
+			/*!
+			 * All the committed bytes, in one piece.
+			 */
+			template< WindowOf< const std::byte * > Window= std::span< const std::byte > >
+			Window
+			readable() const noexcept
+			{
+				return Window( static_cast< const std::byte * >( region.data + head ), size() );
+			}
+
+			/*!
+			 * Make the first `amount` bytes written into the `writable` window readable.
+			 *
+			 * @throw RingOverrunError if there is not that much room.
+			 */
+			void
+			commit( const std::size_t amount )
+			{
+				if( const std::size_t available= room(); amount > available ) throw RingOverrunError{ "commit", region.data + tail, amount, available };
+				tail+= amount;
+			}
+
+			/*!
+			 * Discard the first `amount` readable bytes, making room for more.
+			 *
+			 * @throw RingOverrunError if fewer bytes than that are readable.
+			 */
+			void
+			consume( const std::size_t amount )
+			{
+				if( amount > size() ) throw RingOverrunError{ "consume", region.data + head, amount, size() };
+				advanceHead( amount );
+			}
+
+			/*!
+			 * Consume the first `amount` readable bytes, keeping them as a slice of the ring's storage.
+			 *
+			 * A `Blob` made from the slice, by `Blob::adopt`, shares the ring's storage as a carved `Blob` shares its
+			 * parent's.  The bytes are not written over until
+			 * every such slice is gone.
+			 *
+			 * @throw RingOverrunError if fewer bytes than that are readable.
+			 */
+			MappedRegion
+			carveHead( const std::size_t amount )
+			{
+				if( amount > size() ) throw RingOverrunError{ "carve", region.data + head, amount, size() };
+
+				if( not carved or region.storage->useCount() == 1 )
+				{
+					pinned= head;
+					carved= true;
+				}
+
+				MappedRegion rv{ region.storage, region.data + head, amount };
+				advanceHead( amount );
+				return rv;
+			}
+	};
+}
+
+namespace Alepha::Cavorite::inline exports::inline ring_buffer
+{
+	using namespace detail::ring_buffer::exports;
+}
@@ -0,0 +1,124 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../RingBuffer.h"
+#include "../Blob.h"
+
+#include <cstring>
+
+#include <string>
+#include <string_view>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	void
+	put( Alepha::RingBuffer &ring, const std::string_view text )
+	{
+		std::memcpy( ring.writable().data(), text.data(), text.size() );
+		ring.commit( text.size() );
+	}
+
+	std::string
+	contents( const Alepha::RingBuffer &ring )
+	{
+		const auto bytes= ring.readable();
+		return { reinterpret_cast< const char * >( bytes.data() ), bytes.size() };
+	}
+
+	std::string_view
+	text( const Alepha::Blob &blob )
+	{
+		return { reinterpret_cast< const char * >( blob.byte_data() ), blob.size() };
+	}
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"mirrored_region"_test <=[]( TestState test )
+	{
+		const auto region= Alepha::mapMirroredRegion( 100 );
+		test.expect( region.length >= 100 and region.length % 4096 == 0 );
+
+		region.data[ 3 ]= std::byte{ 42 };
+		region.data[ region.length + 5 ]= std::byte{ 17 };
+		test.expect( region.data[ region.length + 3 ] == std::byte{ 42 } );
+		test.expect( region.data[ 5 ] == std::byte{ 17 } );
+	};
+
+	"contiguous_across_wrap"_test <=[]( TestState test )
+	{
+		Alepha::RingBuffer ring{ 4096 };
+		const std::size_t capacity= ring.capacity();
+		test.expect( ring.empty() and ring.room() == capacity );
+
+		// Move the head close to the end, so that the next frame straddles it.
+		ring.commit( capacity - 3 );
+		ring.consume( capacity - 3 );
+		test.expect( ring.empty() and ring.room() == capacity );
+
+		put( ring, "Hello, World!" );
+		test.expect( contents( ring ) == "Hello, World!" );
+		test.expect( ring.readable< Alepha::Buffer< Alepha::Const > >().size() == 13 );
+
+		ring.consume( 7 );
+		test.expect( contents( ring ) == "World!" );
+		test.expect( ring.room() == capacity - 6 );
+
+		put( ring, std::string( capacity - 6, 'x' ) );
+		test.expect( ring.room() == 0 and ring.size() == capacity );
+		test.expect( contents( ring ).starts_with( "World!xxx" ) );
+	};
+
+	"overruns"_test <=[]( TestState test )
+	{
+		Alepha::RingBuffer ring{ 1 };
+		put( ring, "abc" );
+
+		bool threw= false;
+		try { ring.consume( 4 ); }
+		catch( const Alepha::RingOverrunError &error ) { threw= error.getRequestedSize() == 4 and error.getAvailableSize() == 3; }
+		test.expect( threw );
+
+		threw= false;
+		try { ring.commit( ring.capacity() ); }
+		catch( const Alepha::RingOverrunError & ) { threw= true; }
+		test.expect( threw and contents( ring ) == "abc" );
+	};
+
+	"carved_slices_are_kept"_test <=[]( TestState test )
+	{
+		Alepha::RingBuffer ring{ 4096 };
+		const std::size_t capacity= ring.capacity();
+
+		put( ring, "header:body" );
+		{
+			const auto slice= Alepha::Blob::adopt( ring.carveHead( 6 ) );
+			test.expect( text( slice ) == "header" );
+			test.expect( contents( ring ) == ":body" );
+
+			// While the slice is held, nothing from its start on is room to write into.
+			test.expect( ring.room() == capacity - 11 );
+			ring.consume( 5 );
+			test.expect( ring.room() == capacity - 11 );
+
+			put( ring, std::string( capacity - 11, 'y' ) );
+			test.expect( ring.room() == 0 );
+			test.expect( text( slice ) == "header" );
+			ring.consume( capacity - 11 );
+		}
+
+		// With the slice gone, the whole ring is free again.
+		test.expect( ring.room() == capacity );
+	};
+};
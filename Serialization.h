@@ -0,0 +1,390 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstddef>
+
+#include <bit>
+#include <span>
+#include <tuple>
+#include <array>
+#include <string>
+#include <utility>
+#include <optional>
+#include <limits>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "BufferCursor.h"
+#include "AllocationPolicy.h"
+#include "Enum.h"
+
+#include "Reflection/tuplizeAggregate.h"
+
+namespace Alepha::inline Cavorite  ::detail::  serialization
+{
+	inline namespace exports
+	{
+		class SerializationError;
+
+		template< typename T > std::size_t serializedSize( const T &value );
+		template< typename T > void serialize( BufferWriter &writer, const T &value );
+		template< typename T > T deserialize( BufferReader &reader );
+	}
+
+	/*!
+	 * Thrown when encoded data cannot be decoded into the requested type.
+	 */
+	class exports::SerializationError
+		: public std::runtime_error
+	{
+		public:
+			using std::runtime_error::runtime_error;
+	};
+
+	/*
+	 * The wire format is simple and positional -- no field tags or type information is written:
+	 *
+	 *  * Numbers and plain `enum`s are fixed width, little endian.  `bool` is one byte.
+	 *  * An `Alepha::Enum` is its index, as a varint.
+	 *  * Strings, sequences, and associative containers are a varint element count, then the elements.
+	 *  * `std::array`, `std::pair` and `std::tuple` are their elements.
+	 *  * `std::optional` is a one byte flag, then the value if there is one.
+	 *  * Aggregates are their members, in declaration order.  Aggregates are taken apart with
+	 *    `Reflection::tuplizeAggregate`; one with a member which is constructible from anything (such as a
+	 *    `std::optional`) must declare its member count as `salient_members`.
+	 *
+	 * Any type whose in-memory representation already is its encoding (numbers on a little endian host, and
+	 * arrays and padding free aggregates made only of such) is "bulk", and is copied with a single `memcpy`.  A
+	 * sequence of bulk elements is one `memcpy` for the whole run.
+	 */
+
+	template< typename T >
+	struct is_std_array : std::false_type {};
+
+	template< typename T, std::size_t size >
+	struct is_std_array< std::array< T, size > > : std::true_type {};
+
+	template< typename T >
+	struct is_optional : std::false_type {};
+
+	template< typename T >
+	struct is_optional< std::optional< T > > : std::true_type {};
+
+	template< typename T >
+	struct is_span : std::false_type {};
+
+	template< typename T >
+	struct is_span< std::span< const T > > : std::true_type {};
+
+	template< typename T >
+	concept TupleLike= requires { std::tuple_size< T >::value; } and not is_std_array< T >::value;
+
+	template< typename T >
+	concept Sequence= requires( T &t )
+	{
+		t.size();
+		begin( t );
+		end( t );
+	};
+
+	template< typename T >
+	concept Contiguous= Sequence< T > and requires( T &t ) { t.data(); t.resize( 0 ); };
+
+	template< typename T >
+	concept Associative= Sequence< T > and requires { typename T::key_type; };
+
+	template< typename T >
+	concept ReflectedAggregate= std::is_aggregate_v< T > and not std::is_array_v< T > and not is_std_array< T >::value;
+
+	template< typename T >
+	using member_types_t= std::decay_t< decltype( Reflection::tuplizeAggregate( std::declval< T & >() ) ) >;
+
+	template< typename T >
+	consteval bool
+	isBulk()
+	{
+		if constexpr( std::endian::native != std::endian::little ) return false;
+		else if constexpr( std::is_same_v< T, bool > ) return false;
+		else if constexpr( std::is_arithmetic_v< T > or std::is_enum_v< T > ) return true;
+		else if constexpr( std::is_array_v< T > ) return isBulk< std::remove_extent_t< T > >();
+		else if constexpr( is_std_array< T >::value ) return isBulk< typename T::value_type >();
+		else if constexpr( ReflectedAggregate< T > )
+		{
+			return []< typename ... Members >( std::tuple< Members... > * )
+			{
+				// Padding would be encoded as garbage, so only tightly packed aggregates qualify.
+				return ( ... and isBulk< std::remove_cvref_t< Members > >() )
+						and ( 0 + ... + sizeof( std::remove_cvref_t< Members > ) ) == sizeof( T );
+			}( static_cast< member_types_t< T > * >( nullptr ) );
+		}
+		else return false;
+	}
+
+	template< typename T >
+	constexpr bool is_bulk_v= isBulk< T >();
+
+	// The size pass.
+
+	template< typename T >
+	std::size_t
+	encodedSize( const T &value )
+	{
+		if constexpr( is_bulk_v< T > ) return sizeof( T );
+		else if constexpr( std::is_same_v< T, bool > ) return 1;
+		else if constexpr( is_enum_v< T > ) return BufferWriter::varintSize( value.get_index() );
+		else if constexpr( is_optional< T >::value ) return 1 + ( value ? encodedSize( *value ) : 0 );
+		else if constexpr( TupleLike< T > )
+		{
+			return std::apply( []( const auto &... elements ) { return ( std::size_t{} + ... + encodedSize( elements ) ); }, value );
+		}
+		else if constexpr( std::is_array_v< T > or is_std_array< T >::value )
+		{
+			std::size_t rv= 0;
+			for( const auto &element: value ) rv+= encodedSize( element );
+			return rv;
+		}
+		else if constexpr( Sequence< T > )
+		{
+			using Element= std::remove_cvref_t< decltype( *begin( value ) ) >;
+			std::size_t rv= BufferWriter::varintSize( value.size() );
+			if constexpr( is_bulk_v< Element > ) rv+= value.size() * sizeof( Element );
+			else for( const auto &element: value ) rv+= encodedSize( element );
+			return rv;
+		}
+		else if constexpr( ReflectedAggregate< T > )
+		{
+			return encodedSize( Reflection::tuplizeAggregate( value ) );
+		}
+		else static_assert( sizeof( T ) == 0, "This type cannot be serialized." );
+	}
+
+	// The encoding pass.  Space has already been checked for, so nothing here is checked.
+
+	template< typename T >
+	void
+	encode( BufferWriter &writer, const T &value )
+	{
+		if constexpr( is_bulk_v< T > ) writer.putBytes( reinterpret_cast< const std::byte * >( &value ), sizeof( T ) );
+		else if constexpr( std::is_same_v< T, bool > ) writer.put< std::uint8_t >( value );
+		else if constexpr( is_enum_v< T > ) writer.putVarint( value.get_index() );
+		else if constexpr( is_optional< T >::value )
+		{
+			writer.put< std::uint8_t >( value.has_value() );
+			if( value ) encode( writer, *value );
+		}
+		else if constexpr( TupleLike< T > )
+		{
+			std::apply( [&]( const auto &... elements ) { ( ..., encode( writer, elements ) ); }, value );
+		}
+		else if constexpr( std::is_array_v< T > or is_std_array< T >::value )
+		{
+			for( const auto &element: value ) encode( writer, element );
+		}
+		else if constexpr( Sequence< T > )
+		{
+			using Element= std::remove_cvref_t< decltype( *begin( value ) ) >;
+			writer.putVarint( value.size() );
+			if constexpr( is_bulk_v< Element > and requires{ value.data(); } )
+			{
+				writer.putBytes( reinterpret_cast< const std::byte * >( value.data() ), value.size() * sizeof( Element ) );
+			}
+			else for( const auto &element: value ) encode( writer, element );
+		}
+		else if constexpr( ReflectedAggregate< T > ) encode( writer, Reflection::tuplizeAggregate( value ) );
+		else static_assert( sizeof( T ) == 0, "This type cannot be serialized." );
+	}
+
+	// The decoding pass.  Every read is checked, as the input is not trusted.
+
+	/*
+	 * The size in bytes of `count` bulk `Element`s, checked against what `reader` has left.  The count comes off
+	 * the wire, so it is compared before multiplying: a hostile count must not wrap around to something small.
+	 */
+	template< typename Element >
+	std::size_t
+	requireElements( const BufferReader &reader, const std::size_t count )
+	{
+		if( count > reader.remaining() / sizeof( Element ) )
+		{
+			const std::size_t requested= count > std::numeric_limits< std::size_t >::max() / sizeof( Element )
+					? std::numeric_limits< std::size_t >::max() : count * sizeof( Element );
+			throw CursorOverrunError( nullptr, requested, reader.remaining() );
+		}
+		return count * sizeof( Element );
+	}
+
+	template< typename T >
+	void
+	decode( BufferReader &reader, T &value )
+	{
+		if constexpr( is_bulk_v< T > ) reader.readBytes( reinterpret_cast< std::byte * >( &value ), sizeof( T ) );
+		else if constexpr( std::is_same_v< T, bool > ) value= reader.read< std::uint8_t >();
+		else if constexpr( is_enum_v< T > )
+		{
+			const std::uint64_t index= reader.readVarint();
+			try
+			{
+				value.set_index( index );
+			}
+			catch( const std::runtime_error & )
+			{
+				throw SerializationError{ "Enumeration index " + std::to_string( index ) + " is out of range." };
+			}
+		}
+		else if constexpr( is_optional< T >::value )
+		{
+			if( reader.read< std::uint8_t >() ) decode( reader, value.emplace() );
+			else value.reset();
+		}
+		else if constexpr( TupleLike< T > )
+		{
+			std::apply( [&]( auto &... elements ) { ( ..., decode( reader, elements ) ); }, value );
+		}
+		else if constexpr( std::is_array_v< T > or is_std_array< T >::value )
+		{
+			for( auto &element: value ) decode( reader, element );
+		}
+		else if constexpr( std::is_same_v< T, std::string_view > or is_span< T >::value )
+		{
+			// These view the encoded data in place.
+			using Element= std::remove_cvref_t< typename T::value_type >;
+			static_assert( is_bulk_v< Element >, "Only views of bulk elements can be decoded in place." );
+			const std::size_t count= reader.readVarint();
+			requireElements< Element >( reader, count );
+			const auto span= reader.readSpan< Element >( count );
+			if( not span ) throw SerializationError{ "Encoded data for a view is split across segments or misaligned." };
+			value= T( span->data(), span->size() );
+		}
+		else if constexpr( Sequence< T > )
+		{
+			using Element= std::remove_cvref_t< decltype( *begin( value ) ) >;
+			const std::size_t count= reader.readVarint();
+			value.clear();
+			if constexpr( is_bulk_v< Element > and Contiguous< T > )
+			{
+				const std::size_t amount= requireElements< Element >( reader, count );
+				value.resize( count );
+				reader.getBytes( reinterpret_cast< std::byte * >( value.data() ), amount );
+			}
+			else
+			{
+				// Each element takes at least one byte, so a count larger than the input is certainly corrupt.
+				if( not reader.require( count ) ) throw CursorOverrunError( nullptr, count, reader.remaining() );
+				for( std::size_t i= 0; i < count; ++i )
+				{
+					if constexpr( Associative< T > )
+					{
+						// Keys of maps are `const`, so decode into a mutable copy of the element.
+						if constexpr( requires { typename T::mapped_type; } )
+						{
+							std::pair< typename T::key_type, typename T::mapped_type > entry;
+							decode( reader, entry );
+							value.insert( end( value ), std::move( entry ) );
+						}
+						else
+						{
+							typename T::value_type entry;
+							decode( reader, entry );
+							value.insert( end( value ), std::move( entry ) );
+						}
+					}
+					else decode( reader, value.emplace_back() );
+				}
+			}
+		}
+		else if constexpr( ReflectedAggregate< T > )
+		{
+			auto members= Reflection::tuplizeAggregate( value );
+			decode( reader, members );
+		}
+		else static_assert( sizeof( T ) == 0, "This type cannot be deserialized." );
+	}
+
+	/*!
+	 * The exact number of bytes `serialize` writes for `value`.
+	 */
+	template< typename T >
+	std::size_t
+	exports::serializedSize( const T &value )
+	{
+		return encodedSize( value );
+	}
+
+	/*!
+	 * Encode `value` at `writer`'s position.
+	 *
+	 * The space needed is checked once up front, and the encoding itself runs unchecked.
+	 *
+	 * @throw CursorOverrunError if `writer` has too little space left, in which case nothing is written.
+	 */
+	template< typename T >
+	void
+	exports::serialize( BufferWriter &writer, const T &value )
+	{
+		const std::size_t size= encodedSize( value );
+		if( not writer.require( size ) ) throw CursorOverrunError( nullptr, size, writer.remaining() );
+		encode( writer, value );
+	}
+
+	/*!
+	 * Decode a `T` at `reader`'s position.
+	 *
+	 * `std::string_view` and `std::span< const T >` members are decoded in place: they view the encoded data,
+	 * which must outlive them.
+	 *
+	 * @throw CursorOverrunError if the input ends early.
+	 * @throw SerializationError if the input is otherwise not a valid encoding of a `T`.
+	 */
+	template< typename T >
+	T
+	exports::deserialize( BufferReader &reader )
+	{
+		T rv{};
+		decode( reader, rv );
+		return rv;
+	}
+
+	namespace exports
+	{
+		/*!
+		 * Encode `value` into a new, exactly sized storage object, such as a `Blob`.
+		 *
+		 * The size pass runs first, so the storage is allocated once, uninitialized.  To add the result to a
+		 * `DataChain`, append the `Blob`.
+		 *
+		 * @tparam Storage A type constructible from a size and an `AllocationPolicy`, which exposes its bytes.
+		 */
+		template< typename Storage, typename T >
+		Storage
+		serializeAs( const T &value )
+		{
+			Storage rv( encodedSize( value ), AllocationPolicy::Uninitialized );
+			BufferWriter writer{ rv };
+			encode( writer, value );
+			return rv;
+		}
+
+		/*!
+		 * Decode a `T` from the whole of a `Buffer`, `Blob` or `DataChain`.
+		 *
+		 * @throw SerializationError if bytes are left over.
+		 */
+		template< typename T, typename Bytes >
+		T
+		deserialize( const Bytes &bytes )
+		{
+			BufferReader reader{ bytes };
+			T rv= deserialize< T >( reader );
+			if( not reader.exhausted() ) throw SerializationError{ std::to_string( reader.remaining() ) + " bytes left over after decoding." };
+			return rv;
+		}
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline serialization
+{
+	using namespace detail::serialization::exports;
+}
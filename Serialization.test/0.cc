@@ -0,0 +1,166 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Serialization.h"
+
+#include <map>
+#include <set>
+#include <deque>
+#include <vector>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	using namespace Alepha::literals::enum_literals;
+
+	// A stand-in for `Blob`, with the same allocating constructor.
+	struct Storage
+	{
+		std::vector< std::byte > data;
+
+		Storage( const std::size_t size, Alepha::AllocationPolicy ) : data( size ) {}
+
+		std::byte *byte_data() { return data.data(); }
+		const std::byte *byte_data() const { return data.data(); }
+		std::size_t size() const { return data.size(); }
+	};
+
+	struct Point
+	{
+		std::int32_t x;
+		std::int32_t y;
+	};
+
+	struct Padded
+	{
+		char tag;
+		std::int64_t value;
+	};
+
+	using Color= Alepha::Enum< "red"_value, "green"_value, "blue"_value >;
+
+	struct Message
+	{
+		// `std::optional` members defeat member counting, so the count is given.
+		static constexpr std::size_t salient_members= 9;
+
+		std::uint16_t kind;
+		bool urgent;
+		std::string name;
+		std::vector< Point > path;
+		std::map< std::string, std::int64_t > counters;
+		std::optional< double > weight;
+		Color color;
+		std::array< Padded, 2 > pads;
+		std::pair< std::set< int >, std::deque< std::string > > extra;
+	};
+
+	struct View
+	{
+		std::uint32_t id;
+		std::string_view name;
+		std::span< const std::byte > payload;
+	};
+
+	static_assert( Alepha::Cavorite::detail::serialization::is_bulk_v< Point > );
+	static_assert( Alepha::Cavorite::detail::serialization::is_bulk_v< std::array< Point, 3 > > );
+	static_assert( not Alepha::Cavorite::detail::serialization::is_bulk_v< Padded > );
+	static_assert( not Alepha::Cavorite::detail::serialization::is_bulk_v< Message > );
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"round_trip"_test <=[]( TestState test )
+	{
+		Message message{ 7, true, "hello", { { 1, 2 }, { -3, 4 } }, { { "a", 1 }, { "bb", -2 } }, 0.5, "blue"_value,
+				{ Padded{ 'x', 9 }, Padded{ 'y', -9 } }, { { 3, 1, 2 }, { "p", "q" } } };
+
+		const auto encoded= Alepha::serializeAs< Storage >( message );
+		test.expect( encoded.size() == Alepha::serializedSize( message ) );
+
+		const auto decoded= Alepha::deserialize< Message >( encoded );
+		test.expect( decoded.kind == 7 and decoded.urgent );
+		test.expect( decoded.name == "hello" );
+		test.expect( decoded.path.size() == 2 and decoded.path[ 1 ].x == -3 and decoded.path[ 1 ].y == 4 );
+		test.expect( decoded.counters == message.counters );
+		test.expect( decoded.weight == 0.5 );
+		test.expect( decoded.color == message.color );
+		test.expect( decoded.pads[ 1 ].tag == 'y' and decoded.pads[ 1 ].value == -9 );
+		test.expect( decoded.extra == message.extra );
+	};
+
+	"compact_sizes"_test <=[]( TestState test )
+	{
+		test.expect( Alepha::serializedSize( Point{ 1, 2 } ) == 8 );
+		test.expect( Alepha::serializedSize( Padded{ 'a', 1 } ) == 9 );
+		test.expect( Alepha::serializedSize( std::vector< Point >( 100 ) ) == 1 + 800 );
+		test.expect( Alepha::serializedSize( std::vector< std::uint8_t >( 200 ) ) == 2 + 200 );
+		test.expect( Alepha::serializedSize( std::string( 5, 'z' ) ) == 6 );
+		test.expect( Alepha::serializedSize( std::optional< int >{} ) == 1 );
+	};
+
+	"zero_copy_views"_test <=[]( TestState test )
+	{
+		const std::string name= "widget";
+		const std::byte payload[]= { std::byte{ 1 }, std::byte{ 2 }, std::byte{ 3 } };
+		const View original{ 42, name, payload };
+
+		const auto encoded= Alepha::serializeAs< Storage >( original );
+		const auto decoded= Alepha::deserialize< View >( encoded );
+		test.expect( decoded.id == 42 and decoded.name == "widget" and decoded.payload.size() == 3 );
+
+		// The views point into the encoded bytes rather than at copies.
+		const auto *const first= encoded.byte_data();
+		const auto *const last= first + encoded.size();
+		test.expect( reinterpret_cast< const std::byte * >( decoded.name.data() ) > first );
+		test.expect( decoded.payload.data() + decoded.payload.size() == last );
+	};
+
+	"corrupt_input"_test <=[]( TestState test )
+	{
+		const auto encoded= Alepha::serializeAs< Storage >( std::vector< std::string >{ "one", "two" } );
+
+		bool overran= false;
+		try { Alepha::BufferReader reader{ encoded.byte_data(), encoded.size() - 1 }; Alepha::deserialize< std::vector< std::string > >( reader ); }
+		catch( const Alepha::CursorOverrunError & ) { overran= true; }
+		test.expect( overran );
+
+		bool leftover= false;
+		try { Alepha::deserialize< std::string >( encoded ); }
+		catch( const Alepha::SerializationError & ) { leftover= true; }
+		test.expect( leftover );
+
+		const std::byte badEnum[]= { std::byte{ 9 } };
+		bool badIndex= false;
+		try { Alepha::BufferReader reader{ badEnum, 1 }; Alepha::deserialize< Color >( reader ); }
+		catch( const Alepha::SerializationError & ) { badIndex= true; }
+		test.expect( badIndex );
+	};
+
+	"hostile_counts"_test <=[]( TestState test )
+	{
+		// A count of 2^61 eight byte elements is 2^64 bytes, which wraps to 0 when multiplied out.
+		const std::byte hostile[]= { std::byte{ 0x80 }, std::byte{ 0x80 }, std::byte{ 0x80 }, std::byte{ 0x80 },
+				std::byte{ 0x80 }, std::byte{ 0x80 }, std::byte{ 0x80 }, std::byte{ 0x80 }, std::byte{ 0x20 } };
+
+		bool viewOverran= false;
+		try { Alepha::BufferReader reader{ hostile, sizeof( hostile ) }; Alepha::deserialize< std::span< const std::uint64_t > >( reader ); }
+		catch( const Alepha::CursorOverrunError & ) { viewOverran= true; }
+		test.expect( viewOverran );
+
+		bool vectorOverran= false;
+		try { Alepha::BufferReader reader{ hostile, sizeof( hostile ) }; Alepha::deserialize< std::vector< std::uint64_t > >( reader ); }
+		catch( const Alepha::CursorOverrunError & ) { vectorOverran= true; }
+		test.expect( vectorOverran );
+	};
+};
@@ -0,0 +1,187 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstring>
+#include <cstddef>
+
+#include <atomic>
+#include <utility>
+
+#include "Buffer.h"
+#include "ByteAllocator.h"
+#include "BlobStorage.h"
+#include "AllocationPolicy.h"
+
+namespace Alepha::inline Cavorite  ::detail::  shared_blob
+{
+	inline namespace exports
+	{
+		class SharedBlob;
+		struct SharingStatistics;
+
+		SharingStatistics sharingStatistics() noexcept;
+		void resetSharingStatistics() noexcept;
+	}
+
+	/*!
+	 * Process-wide counts of what `SharedBlob` copies have cost.
+	 */
+	struct exports::SharingStatistics
+	{
+		// Copies which only took another reference on the storage.
+		std::size_t shares= 0;
+
+		// Copies of the data, made when a sharer asked to write.
+		std::size_t copies= 0;
+
+		// The bytes moved by those copies.
+		std::size_t bytesCopied= 0;
+	};
+
+	struct Counters
+	{
+		std::atomic< std::size_t > shares= 0;
+		std::atomic< std::size_t > copies= 0;
+		std::atomic< std::size_t > bytesCopied= 0;
+	};
+
+	inline Counters counters;
+
+	/*!
+	 * A `Blob`-like owner of bytes, whose copies share the data until one of them writes to it.
+	 *
+	 * Copying a `Blob` copies its data.  Copying a `SharedBlob` only takes another reference on the same storage,
+	 * which suits read-mostly payloads handed to several consumers.  Reading is always in place.  The first time a
+	 * sharer asks for writable access while the storage has other references, it gets its own copy of the data
+	 * first -- and from then on it has its own storage and never needs to copy again.
+	 *
+	 * @note Copying a `SharedBlob` while holding a pointer from its `mutable_data` lets writes through that pointer
+	 * show in the copy.  Ask for `mutable_data` again after copying.
+	 */
+	class exports::SharedBlob
+	{
+		private:
+			StorageReference storage;
+			std::byte *data= nullptr;
+			std::size_t length= 0;
+
+		public:
+			SharedBlob() noexcept= default;
+
+			/*!
+			 * Allocate `amount` bytes of unshared storage.
+			 *
+			 * @param amount The number of bytes to allocate.
+			 * @param policy How the storage is obtained and initialized -- see `AllocationPolicy`.
+			 * @param allocator The allocator which provides the storage.  Copies made for writing come from it too.
+			 */
+			explicit
+			SharedBlob( const std::size_t amount, const AllocationPolicy policy= AllocationPolicy::Zeroed,
+					ByteAllocator &allocator= getDefaultAllocator() )
+				: length( amount )
+			{
+				if( not amount ) return;
+				auto allocation= allocateStorage( amount, policy, allocator );
+				storage= std::move( allocation.storage );
+				data= allocation.data;
+			}
+
+			// Copying shares.
+			SharedBlob( const SharedBlob &copy ) noexcept
+				: storage( copy.storage ), data( copy.data ), length( copy.length )
+			{
+				if( storage ) counters.shares.fetch_add( 1, std::memory_order_relaxed );
+			}
+
+			SharedBlob( SharedBlob &&orig ) noexcept
+				: storage( std::move( orig.storage ) ),
+				data( std::exchange( orig.data, nullptr ) ),
+				length( std::exchange( orig.length, 0 ) )
+			{}
+
+			SharedBlob &
+			operator= ( SharedBlob copy ) noexcept
+			{
+				swap( *this, copy );
+				return *this;
+			}
+
+			friend void
+			swap( SharedBlob &lhs, SharedBlob &rhs ) noexcept
+			{
+				using std::swap;
+				swap( lhs.storage, rhs.storage );
+				swap( lhs.data, rhs.data );
+				swap( lhs.length, rhs.length );
+			}
+
+			const std::byte *byte_data() const noexcept { return data; }
+			std::size_t size() const noexcept { return length; }
+			bool empty() const noexcept { return length == 0; }
+
+			/*!
+			 * Whether any other `SharedBlob` refers to this one's storage.
+			 *
+			 * As with `BlobStorage::useCount`, this is only a snapshot if other threads hold copies.  Once it is
+			 * `false` it stays so until this object is copied again.
+			 */
+			bool shared() const noexcept { return storage and storage->useCount() > 1; }
+
+			/*!
+			 * Take a private copy of the data, if it is shared.
+			 */
+			void
+			unshare()
+			{
+				if( not shared() ) return;
+
+				ByteAllocator &allocator= storage->allocator() ? *storage->allocator() : getDefaultAllocator();
+				auto allocation= allocateStorage( length, AllocationPolicy::Uninitialized, allocator );
+				std::memcpy( allocation.data, data, length );
+				storage= std::move( allocation.storage );
+				data= allocation.data;
+
+				counters.copies.fetch_add( 1, std::memory_order_relaxed );
+				counters.bytesCopied.fetch_add( length, std::memory_order_relaxed );
+			}
+
+			/*!
+			 * Writable access to the data, copying it first if it is shared.
+			 */
+			std::byte *
+			mutable_data()
+			{
+				unshare();
+				return data;
+			}
+
+			// Buffer Model adaptors.  As with `mutable_data`, writable access copies the data first if it is shared.
+			operator Buffer< Mutable > () { return { mutable_data(), length }; }
+			operator Buffer< Const > () const noexcept { return { data, length }; }
+	};
+
+	inline SharingStatistics
+	exports::sharingStatistics() noexcept
+	{
+		return
+		{
+			counters.shares.load( std::memory_order_relaxed ),
+			counters.copies.load( std::memory_order_relaxed ),
+			counters.bytesCopied.load( std::memory_order_relaxed )
+		};
+	}
+
+	inline void
+	exports::resetSharingStatistics() noexcept
+	{
+		counters.shares= 0;
+		counters.copies= 0;
+		counters.bytesCopied= 0;
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline shared_blob
+{
+	using namespace detail::shared_blob::exports;
+}
@@ -0,0 +1,95 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../SharedBlob.h"
+
+#include <vector>
+#include <algorithm>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"copies_share"_test <=[]( TestState test )
+	{
+		Alepha::resetSharingStatistics();
+
+		Alepha::SharedBlob original{ 4096 };
+		std::fill_n( original.mutable_data(), original.size(), std::byte{ 7 } );
+		test.expect( Alepha::sharingStatistics().copies == 0 );
+
+		std::vector< Alepha::SharedBlob > readers( 5, original );
+		for( const auto &reader: readers ) test.expect( reader.byte_data() == original.byte_data() );
+		test.expect( original.shared() );
+
+		const auto statistics= Alepha::sharingStatistics();
+		test.expect( statistics.shares == 5 and statistics.copies == 0 and statistics.bytesCopied == 0 );
+	};
+
+	"copy_on_write"_test <=[]( TestState test )
+	{
+		Alepha::resetSharingStatistics();
+
+		Alepha::SharedBlob original{ 100 };
+		Alepha::SharedBlob copy= original;
+
+		// Writing to a shared copy gives it its own data, leaving the original alone.
+		copy.mutable_data()[ 0 ]= std::byte{ 1 };
+		test.expect( copy.byte_data() != original.byte_data() );
+		test.expect( original.byte_data()[ 0 ] == std::byte{ 0 } and copy.byte_data()[ 0 ] == std::byte{ 1 } );
+		test.expect( not copy.shared() and not original.shared() );
+
+		// Neither is shared any more, so further writes copy nothing.
+		const auto *const before= original.byte_data();
+		original.mutable_data()[ 1 ]= std::byte{ 2 };
+		copy.mutable_data()[ 1 ]= std::byte{ 3 };
+		test.expect( original.byte_data() == before );
+
+		const auto statistics= Alepha::sharingStatistics();
+		test.expect( statistics.shares == 1 and statistics.copies == 1 and statistics.bytesCopied == 100 );
+	};
+
+	"last_sharer_writes_in_place"_test <=[]( TestState test )
+	{
+		Alepha::resetSharingStatistics();
+
+		Alepha::SharedBlob original{ 64 };
+		const auto *const data= original.byte_data();
+		{
+			Alepha::SharedBlob copy= original;
+			test.expect( original.shared() );
+		}
+		test.expect( not original.shared() );
+		test.expect( original.mutable_data() == data );
+
+		Alepha::SharedBlob moved= std::move( original );
+		test.expect( moved.byte_data() == data and original.empty() );
+		test.expect( Alepha::sharingStatistics().copies == 0 );
+	};
+
+	"buffer_views"_test <=[]( TestState test )
+	{
+		Alepha::resetSharingStatistics();
+
+		Alepha::SharedBlob original{ 32 };
+		const Alepha::SharedBlob copy= original;
+
+		const Alepha::Buffer< Alepha::Const > reading= copy;
+		test.expect( reading.byte_data() == original.byte_data() and reading.size() == 32 );
+		test.expect( Alepha::sharingStatistics().copies == 0 );
+
+		const Alepha::Buffer< Alepha::Mutable > writing= original;
+		test.expect( writing.byte_data() != copy.byte_data() and writing.byte_data() == original.byte_data() );
+		test.expect( writing.size() == 32 and not original.shared() );
+		test.expect( Alepha::sharingStatistics().copies == 1 );
+	};
+};
@@ -0,0 +1,203 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstring>
+#include <cstddef>
+
+#include <new>
+#include <optional>
+#include <concepts>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Buffer.h"
+
+#include "Proof/Attestation.h"
+
+namespace Alepha::inline Cavorite  ::detail::  size_proof
+{
+	template< typename T >
+	concept ByteRange= requires( const T &t )
+	{
+		{ t.byte_data() } -> std::convertible_to< const std::byte * >;
+		{ t.size() } -> std::convertible_to< std::size_t >;
+	} and std::constructible_from< T, decltype( std::declval< const T & >().byte_data() ), std::size_t >;
+
+	struct SizeChecker;
+
+	inline namespace exports
+	{
+		class SizeProofError;
+
+		template< std::size_t minimum >
+		struct at_least_tag { using averant= SizeChecker; };
+
+		/*!
+		 * The fact that a range of bytes has at least `minimum` bytes in it.
+		 */
+		template< std::size_t minimum >
+		using AtLeast= Proof::Attestation< at_least_tag< minimum > >;
+
+		/*!
+		 * A `Buffer` (or similar byte range), together with proof that it has at least `minimum` bytes.
+		 */
+		template< std::size_t minimum, ByteRange Bytes >
+		using SizedWitness= typename AtLeast< minimum >::template Witness< Bytes >;
+	}
+
+	// Witness types are nested in their attestations, so cannot be deduced from.  What they prove is found through
+	// the `fact` they carry instead.
+	template< typename Attestation >
+	struct proven_minimum {};
+
+	template< std::size_t minimum >
+	struct proven_minimum< AtLeast< minimum > > : std::integral_constant< std::size_t, minimum > {};
+
+	template< typename Witness >
+	constexpr std::size_t proven_minimum_v= proven_minimum< decltype( fact( std::declval< const Witness & >() ) ) >::value;
+
+	template< typename Witness >
+	using proven_bytes_t= std::remove_cvref_t< decltype( testify( std::declval< const Witness & >() ) ) >;
+
+	template< typename Witness >
+	concept SizeWitness= requires { proven_minimum_v< Witness >; };
+
+	/*!
+	 * Thrown when a range of bytes is too small for what was to be proven of it.
+	 */
+	class exports::SizeProofError
+		: public virtual OutOfRangeError
+	{
+		public:
+			explicit
+			SizeProofError( const void *const location, const std::size_t requested, const std::size_t available )
+				: std::out_of_range( "Needed " + stringify( requested ) + " bytes at location " + stringify( location )
+						+ ", but only " + stringify( available ) + " are available." ),
+				OutOfRangeError( location, requested, available )
+			{}
+	};
+
+	// The only source of `AtLeast` attestations.
+	struct SizeChecker
+	{
+		template< std::size_t minimum, ByteRange Bytes >
+		static SizedWitness< minimum, Bytes >
+		attest( Bytes bytes ) noexcept
+		{
+			return Proof::attest( AtLeast< minimum >::permission ).averCopy( std::move( bytes ) );
+		}
+
+		template< std::size_t minimum, ByteRange Bytes >
+		static std::optional< SizedWitness< minimum, Bytes > >
+		check( Bytes bytes ) noexcept
+		{
+			if( bytes.size() < minimum ) return std::nullopt;
+			return attest< minimum >( std::move( bytes ) );
+		}
+
+		template< std::size_t amount, SizeWitness Witness >
+		static auto
+		advance( const Witness &witness ) noexcept
+		{
+			const auto &bytes= testify( witness );
+			return attest< proven_minimum_v< Witness > - amount >( proven_bytes_t< Witness >( bytes.byte_data() + amount, bytes.size() - amount ) );
+		}
+
+		template< std::size_t lesser, SizeWitness Witness >
+		static auto
+		weaken( const Witness &witness ) noexcept
+		{
+			return attest< lesser >( testify( witness ) );
+		}
+	};
+
+	namespace exports
+	{
+		/*!
+		 * Check, once, that `bytes` has at least `minimum` bytes.
+		 *
+		 * The result unlocks unchecked access to those bytes through `uncheckedAs`, `uncheckedRead` and `uncheckedAdvance`, so a
+		 * decoder which checks a frame's length up front need not check each field again.
+		 *
+		 * @throw SizeProofError When `bytes` is too small.
+		 */
+		template< std::size_t minimum, ByteRange Bytes >
+		SizedWitness< minimum, Bytes >
+		proveSize( Bytes bytes )
+		{
+			const void *const location= bytes.byte_data();
+			const std::size_t available= bytes.size();
+			if( auto rv= SizeChecker::check< minimum >( std::move( bytes ) ) ) return std::move( *rv );
+			throw SizeProofError{ location, minimum, available };
+		}
+
+		/*!
+		 * As `proveSize`, but gives nothing rather than throwing when `bytes` is too small.
+		 */
+		template< std::size_t minimum, ByteRange Bytes >
+		std::optional< SizedWitness< minimum, Bytes > >
+		tryProveSize( Bytes bytes ) noexcept
+		{
+			return SizeChecker::check< minimum >( std::move( bytes ) );
+		}
+
+		/*!
+		 * The `T` at `offset` in the proven range, in place and without a size check.
+		 *
+		 * Reading or writing a `T` is bounds-checked at compile time instead.  As with `Buffer::as`, the bytes
+		 * must be suitably aligned for `T`; `uncheckedRead` has no such requirement.
+		 */
+		template< typename T, std::size_t offset= 0, SizeWitness Witness >
+		requires( offset + sizeof( T ) <= proven_minimum_v< Witness > and std::is_trivially_copyable_v< T > )
+		decltype( auto )
+		uncheckedAs( const Witness &witness ) noexcept
+		{
+			auto *const location= testify( witness ).byte_data() + offset;
+			using Target= std::conditional_t< std::is_const_v< std::remove_pointer_t< decltype( location ) > >, const T, T >;
+			return *std::launder( reinterpret_cast< Target * >( location ) );
+		}
+
+		/*!
+		 * A copy of the `T` at `offset` in the proven range, without a size check.  Any alignment will do.
+		 */
+		template< typename T, std::size_t offset= 0, SizeWitness Witness >
+		requires( offset + sizeof( T ) <= proven_minimum_v< Witness > and std::is_trivially_copyable_v< T > )
+		T
+		uncheckedRead( const Witness &witness ) noexcept
+		{
+			T rv;
+			std::memcpy( &rv, testify( witness ).byte_data() + offset, sizeof( T ) );
+			return rv;
+		}
+
+		/*!
+		 * The range after its first `amount` bytes, still proven to hold the rest of the `minimum`.
+		 *
+		 * This is `buffer + amount`, without its size check.
+		 */
+		template< std::size_t amount, SizeWitness Witness >
+		requires( amount <= proven_minimum_v< Witness > )
+		auto
+		uncheckedAdvance( const Witness &witness ) noexcept
+		{
+			return SizeChecker::advance< amount >( witness );
+		}
+
+		/*!
+		 * A proof of a smaller minimum, for passing to code which asks for less.
+		 */
+		template< std::size_t lesser, SizeWitness Witness >
+		requires( lesser <= proven_minimum_v< Witness > )
+		auto
+		weaken( const Witness &witness ) noexcept
+		{
+			return SizeChecker::weaken< lesser >( witness );
+		}
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline size_proof
+{
+	using namespace detail::size_proof::exports;
+}
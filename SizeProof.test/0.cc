@@ -0,0 +1,107 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../SizeProof.h"
+
+#include <array>
+#include <cstdint>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	template< typename Witness, typename T, std::size_t offset >
+	concept CanRead= requires( const Witness &w ) { Alepha::uncheckedRead< T, offset >( w ); };
+
+	template< typename Witness, std::size_t amount >
+	concept CanAdvance= requires( const Witness &w ) { Alepha::uncheckedAdvance< amount >( w ); };
+
+	// A frame header, decoded with one size check.
+	struct Header
+	{
+		std::uint16_t kind;
+		std::uint32_t length;
+		std::uint8_t flags;
+	};
+
+	Header
+	decodeHeader( const Alepha::Buffer< Alepha::Const > frame )
+	{
+		const auto proven= Alepha::proveSize< 7 >( frame );
+		Header rv;
+		rv.kind= Alepha::uncheckedRead< std::uint16_t >( proven );
+		rv.length= Alepha::uncheckedRead< std::uint32_t, 2 >( proven );
+		rv.flags= Alepha::uncheckedRead< std::uint8_t >( Alepha::uncheckedAdvance< 6 >( proven ) );
+		return rv;
+	}
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"prove_and_read"_test <=[]( TestState test )
+	{
+		const std::array< std::uint8_t, 8 > frame{ 0x01, 0x00, 0x10, 0x00, 0x00, 0x00, 0x80, 0xFF };
+		const Header header= decodeHeader( { reinterpret_cast< const std::byte * >( frame.data() ), frame.size() } );
+		test.expect( header.kind == 1 and header.length == 16 and header.flags == 0x80 );
+	};
+
+	"too_small"_test <=[]( TestState test )
+	{
+		const std::array< std::byte, 6 > frame{};
+		const Alepha::Buffer< Alepha::Const > bytes{ frame.data(), frame.size() };
+
+		test.expect( not Alepha::tryProveSize< 7 >( bytes ) );
+		test.expect( Alepha::tryProveSize< 6 >( bytes ).has_value() );
+
+		bool threw= false;
+		try { decodeHeader( bytes ); }
+		catch( const Alepha::SizeProofError &error )
+		{
+			threw= error.getAddress() == frame.data() and error.getRequestedSize() == 7 and error.getAvailableSize() == 6;
+		}
+		test.expect( threw );
+	};
+
+	"compile_time_bounds"_test <=[]( TestState test )
+	{
+		using Proven= Alepha::SizedWitness< 8, Alepha::Buffer< Alepha::Const > >;
+		static_assert( CanRead< Proven, std::uint64_t, 0 > );
+		static_assert( CanRead< Proven, std::uint32_t, 4 > );
+		static_assert( not CanRead< Proven, std::uint32_t, 5 > );
+		static_assert( CanAdvance< Proven, 8 > and not CanAdvance< Proven, 9 > );
+
+		using Rest= decltype( Alepha::uncheckedAdvance< 3 >( std::declval< const Proven & >() ) );
+		static_assert( std::is_same_v< Rest, Alepha::SizedWitness< 5, Alepha::Buffer< Alepha::Const > > > );
+		static_assert( not CanRead< Rest, std::uint64_t, 0 > );
+		test.expect( true );
+	};
+
+	"in_place_access"_test <=[]( TestState test )
+	{
+		alignas( 8 ) std::array< std::byte, 16 > storage{};
+		const auto proven= Alepha::proveSize< 16 >( Alepha::Buffer< Alepha::Mutable >{ storage.data(), storage.size() } );
+
+		Alepha::uncheckedAs< std::uint64_t, 8 >( proven )= 42;
+		test.expect( Alepha::uncheckedRead< std::uint64_t, 8 >( proven ) == 42 );
+
+		const auto rest= Alepha::uncheckedAdvance< 8 >( proven );
+		test.expect( testify( rest ).byte_data() == storage.data() + 8 and testify( rest ).size() == 8 );
+		test.expect( Alepha::uncheckedAs< std::uint64_t >( rest ) == 42 );
+
+		const auto less= Alepha::weaken< 4 >( proven );
+		static_assert( std::is_same_v< decltype( less ), const Alepha::SizedWitness< 4, Alepha::Buffer< Alepha::Mutable > > > );
+		test.expect( testify( less ).size() == 16 );
+
+		const auto readOnly= Alepha::proveSize< 8 >( Alepha::Buffer< Alepha::Const >{ storage.data(), storage.size() } );
+		static_assert( std::is_same_v< decltype( Alepha::uncheckedAs< std::uint64_t >( readOnly ) ), const std::uint64_t & > );
+	};
+};
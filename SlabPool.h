@@ -0,0 +1,298 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstddef>
+
+#include <array>
+#include <bit>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+
+#include "ByteAllocator.h"
+#include "error.h"
+
+namespace Alepha::inline Cavorite  ::detail::  slab_pool
+{
+	inline namespace exports
+	{
+		class SlabPool;
+	}
+
+	namespace C
+	{
+		const bool debug= false;
+		const bool debugSlabs= false or C::debug;
+		const bool debugThreadCaches= false or C::debug;
+
+		// Blocks are handed out in power-of-two size classes from `minimumBlockSize` up to `maximumBlockSize`.
+		// Anything larger goes straight to the fallback allocator.
+		const std::size_t minimumBlockSize= 16;
+		const std::size_t maximumBlockSize= 64 * 1024;
+
+		// The minimum amount of memory requested from the fallback allocator whenever a size class runs dry.
+		const std::size_t slabSize= 256 * 1024;
+
+		// Roughly how many bytes of each size class a thread keeps for itself before returning blocks to the pool.
+		const std::size_t threadCacheBytes= 256 * 1024;
+	}
+
+	/*!
+	 * A size-classed slab allocator with per-thread caches.
+	 *
+	 * Small and medium allocations are rounded up to a power-of-two size class.  Each class is backed by slabs
+	 * obtained from a fallback allocator, which are carved into blocks and threaded onto intrusive free lists.
+	 * Every thread keeps its own free list per class, so the common allocate and deallocate paths take no locks
+	 * at all.  When a thread's list runs dry it takes a batch of blocks from the shared depot for that class, and
+	 * when a thread accumulates too many free blocks it gives a batch back.  Only the depot transfers lock.
+	 *
+	 * Blocks are never given back to the fallback allocator until the pool itself is destroyed.  A workload's
+	 * peak footprint is retained, which is the intent: steady-state traffic never reaches `malloc`.
+	 *
+	 * @note A `SlabPool` must outlive every thread which allocates from it, as those threads return their cached
+	 * blocks to the pool when they exit.  The `process` pool is never destroyed, for this reason.
+	 */
+	class exports::SlabPool
+		: public ByteAllocator
+	{
+		private:
+			struct FreeBlock { FreeBlock *next; };
+
+			static constexpr std::size_t classCount= std::bit_width( C::maximumBlockSize / C::minimumBlockSize );
+
+			static constexpr std::size_t
+			sizeClass( const std::size_t amount ) noexcept
+			{
+				if( amount <= C::minimumBlockSize ) return 0;
+				return std::bit_width( ( amount - 1 ) / C::minimumBlockSize );
+			}
+
+			static constexpr std::size_t classBlockSize( const std::size_t cls ) noexcept { return C::minimumBlockSize << cls; }
+
+			// How many blocks move between a thread and the depot at once.
+			static constexpr std::size_t
+			batchSize( const std::size_t cls ) noexcept
+			{
+				return std::clamp< std::size_t >( C::threadCacheBytes / 2 / classBlockSize( cls ), 8, 256 );
+			}
+
+			struct FreeList
+			{
+				FreeBlock *head= nullptr;
+				std::size_t count= 0;
+
+				void
+				push( FreeBlock *const block ) noexcept
+				{
+					block->next= head;
+					head= block;
+					++count;
+				}
+
+				FreeBlock *
+				pop() noexcept
+				{
+					FreeBlock *const rv= head;
+					head= rv->next;
+					--count;
+					return rv;
+				}
+			};
+
+			struct Depot
+			{
+				std::mutex access;
+				FreeList blocks;
+			};
+
+			struct ThreadCache
+			{
+				SlabPool *pool;
+				std::array< FreeList, classCount > lists;
+
+				explicit ThreadCache( SlabPool *const pool ) noexcept : pool( pool ) {}
+
+				~ThreadCache()
+				{
+					if( C::debugThreadCaches ) error() << "Returning thread cache to pool " << pool << std::endl;
+					for( std::size_t cls= 0; cls < classCount; ++cls ) pool->release( cls, lists[ cls ], lists[ cls ].count );
+					if( lastCache == this ) lastCache= nullptr;
+				}
+			};
+
+			// The most recently used cache is kept in a trivially initialized slot, so the common path never
+			// pays for the dynamic thread-local initialization of the full cache list.
+			static inline thread_local constinit ThreadCache *lastCache= nullptr;
+			static thread_local std::vector< std::unique_ptr< ThreadCache > > threadCaches;
+
+			ByteAllocator &fallback;
+			std::array< Depot, classCount > depots;
+
+			std::mutex slabAccess;
+			std::vector< std::pair< std::byte *, std::size_t > > slabs;
+			std::atomic< std::size_t > slabBytes= 0;
+
+			// This thread's cache for this pool, if it has one yet.
+			ThreadCache *
+			existingCache() noexcept
+			{
+				if( lastCache and lastCache->pool == this ) [[likely]] return lastCache;
+
+				const auto found= std::find_if( begin( threadCaches ), end( threadCaches ),
+						[this]( const auto &cache ) { return cache->pool == this; } );
+				if( found != end( threadCaches ) ) return lastCache= found->get();
+				return nullptr;
+			}
+
+			ThreadCache &
+			cache()
+			{
+				if( const auto existing= existingCache() ) [[likely]] return *existing;
+
+				threadCaches.push_back( std::make_unique< ThreadCache >( this ) );
+				return *( lastCache= threadCaches.back().get() );
+			}
+
+			// Move `amount` blocks from `list` into the depot for `cls`.
+			void
+			release( const std::size_t cls, FreeList &list, std::size_t amount ) noexcept
+			{
+				if( amount == 0 ) return;
+				auto &depot= depots[ cls ];
+				std::lock_guard lock( depot.access );
+				while( amount-- ) depot.blocks.push( list.pop() );
+			}
+
+			// Move a batch of blocks into `list`, carving a new slab if the depot is dry.
+			void
+			refill( const std::size_t cls, FreeList &list )
+			{
+				auto &depot= depots[ cls ];
+				std::lock_guard lock( depot.access );
+				if( depot.blocks.count == 0 ) carveSlab( cls, depot.blocks );
+
+				for( std::size_t i= 0; i < batchSize( cls ) and depot.blocks.count; ++i ) list.push( depot.blocks.pop() );
+			}
+
+			void
+			carveSlab( const std::size_t cls, FreeList &list )
+			{
+				const std::size_t blockSize= classBlockSize( cls );
+				const std::size_t amount= std::max( C::slabSize, blockSize * batchSize( cls ) );
+
+				std::byte *const slab= fallback.allocate( amount );
+				try
+				{
+					std::lock_guard lock( slabAccess );
+					slabs.emplace_back( slab, amount );
+				}
+				catch( ... )
+				{
+					fallback.deallocate( slab, amount );
+					throw;
+				}
+				slabBytes+= amount;
+				if( C::debugSlabs ) error() << "Carving a slab of " << amount << " bytes into " << blockSize << " byte blocks." << std::endl;
+
+				// Push in reverse, so that the blocks come back out in address order.
+				for( std::size_t offset= amount / blockSize * blockSize; offset; offset-= blockSize )
+				{
+					list.push( reinterpret_cast< FreeBlock * >( slab + offset - blockSize ) );
+				}
+			}
+
+		public:
+			~SlabPool() override
+			{
+				// Only the destroying thread's cache can be reclaimed here -- see the class notes.
+				std::erase_if( threadCaches, [this]( const auto &cache )
+				{
+					if( cache->pool != this ) return false;
+					for( auto &list: cache->lists ) list= {};
+					return true;
+				});
+				lastCache= nullptr;
+
+				for( const auto &[ slab, amount ]: slabs ) fallback.deallocate( slab, amount );
+			}
+
+			explicit
+			SlabPool( ByteAllocator &fallback= NewArrayAllocator::instance() ) noexcept
+				: fallback( fallback )
+			{}
+
+			SlabPool( const SlabPool & )= delete;
+			SlabPool &operator= ( const SlabPool & )= delete;
+
+			/*!
+			 * The pool shared by the whole process.
+			 *
+			 * This pool is deliberately never destroyed, so that threads which outlive `main` can still return their
+			 * caches to it.  It is the natural argument to `setDefaultAllocator`.
+			 */
+			static SlabPool &
+			process()
+			{
+				static SlabPool &rv= *new SlabPool;
+				return rv;
+			}
+
+			[[nodiscard]] std::byte *
+			allocate( const std::size_t amount ) override
+			{
+				if( amount > C::maximumBlockSize ) return fallback.allocate( amount );
+
+				const std::size_t cls= sizeClass( amount );
+				auto &list= cache().lists[ cls ];
+				if( list.count == 0 ) [[unlikely]] refill( cls, list );
+				return reinterpret_cast< std::byte * >( list.pop() );
+			}
+
+			void
+			deallocate( std::byte *const block, const std::size_t amount ) noexcept override
+			{
+				if( amount > C::maximumBlockSize ) return fallback.deallocate( block, amount );
+
+				const std::size_t cls= sizeClass( amount );
+				const auto cache= existingCache();
+
+				// A thread which never allocated from this pool has no cache, and making one could throw -- its frees
+				// go straight to the depot instead.
+				if( not cache ) [[unlikely]]
+				{
+					auto &depot= depots[ cls ];
+					std::lock_guard lock( depot.access );
+					return depot.blocks.push( reinterpret_cast< FreeBlock * >( block ) );
+				}
+
+				auto &list= cache->lists[ cls ];
+				list.push( reinterpret_cast< FreeBlock * >( block ) );
+				if( list.count > 2 * batchSize( cls ) ) [[unlikely]] release( cls, list, batchSize( cls ) );
+			}
+
+			/*!
+			 * The total number of bytes obtained from the fallback allocator for slabs.
+			 */
+			std::size_t reservedBytes() const noexcept { return slabBytes; }
+
+			/*!
+			 * The size of block which actually backs a request for `amount` bytes.
+			 */
+			static constexpr std::size_t
+			blockSize( const std::size_t amount ) noexcept
+			{
+				if( amount > C::maximumBlockSize ) return amount;
+				return classBlockSize( sizeClass( amount ) );
+			}
+	};
+
+	inline thread_local std::vector< std::unique_ptr< SlabPool::ThreadCache > > SlabPool::threadCaches;
+}
+
+namespace Alepha::Cavorite::inline exports::inline slab_pool
+{
+	using namespace detail::slab_pool::exports;
+}
@@ -0,0 +1,102 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../SlabPool.h"
+
+#include <cstring>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	using Alepha::SlabPool;
+
+	"slab_pool.size_classes"_test <=[]( TestState test )
+	{
+		test.expect( SlabPool::blockSize( 1 ) == 16 );
+		test.expect( SlabPool::blockSize( 16 ) == 16 );
+		test.expect( SlabPool::blockSize( 17 ) == 32 );
+		test.expect( SlabPool::blockSize( 1000 ) == 1024 );
+		test.expect( SlabPool::blockSize( 64 * 1024 ) == 64 * 1024 );
+		test.expect( SlabPool::blockSize( 64 * 1024 + 1 ) == 64 * 1024 + 1 );
+	};
+
+	"slab_pool.reuse"_test <=[]( TestState test )
+	{
+		SlabPool pool;
+		std::byte *const first= pool.allocate( 100 );
+		pool.deallocate( first, 100 );
+		std::byte *const second= pool.allocate( 120 );
+		test.expect( first == second );
+		pool.deallocate( second, 120 );
+
+		const auto reserved= pool.reservedBytes();
+		for( int i= 0; i < 10'000; ++i ) pool.deallocate( pool.allocate( 100 ), 100 );
+		test.expect( pool.reservedBytes() == reserved );
+	};
+
+	"slab_pool.distinct_blocks"_test <=[]( TestState test )
+	{
+		SlabPool pool;
+		std::vector< std::byte * > blocks;
+		for( int i= 0; i < 5'000; ++i )
+		{
+			blocks.push_back( pool.allocate( 48 ) );
+			std::memset( blocks.back(), i, 48 );
+		}
+
+		test.expect( std::set( begin( blocks ), end( blocks ) ).size() == blocks.size() );
+		for( std::size_t i= 0; i < blocks.size(); ++i )
+		{
+			test.expect( blocks[ i ][ 47 ] == std::byte( i ) );
+			test.expect( reinterpret_cast< std::uintptr_t >( blocks[ i ] ) % alignof( std::max_align_t ) == 0 );
+		}
+		for( auto *const block: blocks ) pool.deallocate( block, 48 );
+	};
+
+	"slab_pool.large_fallback"_test <=[]( TestState test )
+	{
+		SlabPool pool;
+		std::byte *const big= pool.allocate( 1024 * 1024 );
+		std::memset( big, 0xAA, 1024 * 1024 );
+		pool.deallocate( big, 1024 * 1024 );
+		test.expect( pool.reservedBytes() == 0 );
+	};
+
+	"slab_pool.cross_thread"_test <=[]( TestState test )
+	{
+		SlabPool pool;
+		std::vector< std::byte * > blocks( 20'000 );
+		std::thread producer{ [&]
+		{
+			for( auto &block: blocks ) block= pool.allocate( 256 );
+		}};
+		producer.join();
+
+		std::thread consumer{ [&]
+		{
+			for( auto *const block: blocks ) pool.deallocate( block, 256 );
+		}};
+		consumer.join();
+
+		// The consumer never allocated, so it has no cache: everything it handed back went to the depot, and
+		// must be reusable from here without new slabs.
+		const auto reserved= pool.reservedBytes();
+		for( auto &block: blocks ) block= pool.allocate( 256 );
+		test.expect( pool.reservedBytes() == reserved );
+		for( auto *const block: blocks ) pool.deallocate( block, 256 );
+	};
+};
@@ -0,0 +1,51 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../SlabPool.h"
+
+#include <chrono>
+#include <vector>
+#include <iostream>
+
+/*
+ * Compares the `SlabPool` against the classic `new[]` path that `Blob` objects used before pooling, over a
+ * churn of small and medium blocks.
+ */
+
+namespace
+{
+	template< typename Allocator >
+	double
+	churn( Allocator &allocator, const std::size_t rounds )
+	{
+		const std::size_t sizes[]= { 24, 64, 200, 512, 1500, 4096, 9000 };
+		std::vector< std::pair< std::byte *, std::size_t > > live;
+		live.reserve( 64 );
+
+		const auto start= std::chrono::steady_clock::now();
+		for( std::size_t round= 0; round < rounds; ++round )
+		{
+			for( std::size_t i= 0; i < 64; ++i )
+			{
+				const std::size_t amount= sizes[ ( round + i ) % std::size( sizes ) ];
+				live.emplace_back( allocator.allocate( amount ), amount );
+				*live.back().first= std::byte( i );
+			}
+			for( const auto &[ block, amount ]: live ) allocator.deallocate( block, amount );
+			live.clear();
+		}
+		const std::chrono::duration< double, std::nano > elapsed= std::chrono::steady_clock::now() - start;
+		return elapsed.count() / ( rounds * 64 );
+	}
+}
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	const std::size_t rounds= argcnt > 1 ? std::stoul( argvec[ 1 ] ) : 20'000;
+
+	Alepha::SlabPool pool;
+	churn( pool, rounds / 10 ); // Warm the slabs.
+
+	std::cout << "new[]:    " << churn( Alepha::NewArrayAllocator::instance(), rounds ) << " ns per allocate/deallocate" << std::endl;
+	std::cout << "SlabPool: " << churn( pool, rounds ) << " ns per allocate/deallocate" << std::endl;
+}
@@ -0,0 +1,140 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstring>
+#include <cstddef>
+
+#include <array>
+#include <utility>
+
+#include "ByteAllocator.h"
+#include "BlobStorage.h"
+#include "AllocationPolicy.h"
+
+namespace Alepha::inline Cavorite  ::detail::  small_storage
+{
+	inline namespace exports
+	{
+		class SmallStorage;
+	}
+
+	namespace C
+	{
+		// Payloads up to this size live inside the `Blob` object itself.  Most protocol headers fit.
+		const std::size_t inlineCapacity= 48;
+	}
+
+	/*!
+	 * What a `Blob` keeps its bytes in: either right inside itself, or through a counted reference on shared
+	 * storage.
+	 *
+	 * Small zeroed or uninitialized allocations are inline, and cost no allocation and no reference counting.
+	 * Anything larger, or with another `AllocationPolicy`, goes to `allocateStorage` as before.  Inline bytes
+	 * cannot be shared.  A piece carved from them fits inline too, so carving copies it instead.  The allocator
+	 * passed for inline bytes is remembered, so that anything later allocated on their behalf comes from it.
+	 *
+	 * Moving or swapping a `SmallStorage` moves any inline bytes to a new address.  The owner must rebase its
+	 * pointers into them, as `Blob` does.
+	 */
+	class exports::SmallStorage
+	{
+		private:
+			StorageReference shared;
+			ByteAllocator *inlineAllocator= nullptr;
+			bool inlined= false;
+
+			// This is zeroed up front, as moves copy all of it, even the bytes an `Uninitialized` allocation left.
+			alignas( std::max_align_t ) std::array< std::byte, C::inlineCapacity > local{};
+
+		public:
+			SmallStorage() noexcept= default;
+
+			explicit SmallStorage( StorageReference reference ) noexcept : shared( std::move( reference ) ) {}
+
+			SmallStorage( SmallStorage &&orig ) noexcept
+				: shared( std::move( orig.shared ) ),
+				inlineAllocator( std::exchange( orig.inlineAllocator, nullptr ) ),
+				inlined( std::exchange( orig.inlined, false ) )
+			{
+				if( inlined ) local= orig.local;
+			}
+
+			SmallStorage &
+			operator= ( SmallStorage orig ) noexcept
+			{
+				swap( *this, orig );
+				return *this;
+			}
+
+			friend void
+			swap( SmallStorage &lhs, SmallStorage &rhs ) noexcept
+			{
+				using std::swap;
+				swap( lhs.shared, rhs.shared );
+				swap( lhs.inlineAllocator, rhs.inlineAllocator );
+				swap( lhs.inlined, rhs.inlined );
+				if( lhs.inlined or rhs.inlined ) swap( lhs.local, rhs.local );
+			}
+
+			static constexpr bool
+			fitsInline( const std::size_t amount, const AllocationPolicy policy ) noexcept
+			{
+				return amount <= C::inlineCapacity
+						and ( policy == AllocationPolicy::Zeroed or policy == AllocationPolicy::Uninitialized );
+			}
+
+			/*!
+			 * Replace the current bytes with `amount` new ones.
+			 *
+			 * @return Where the new bytes are.
+			 */
+			std::byte *
+			allocate( const std::size_t amount, const AllocationPolicy policy, ByteAllocator &allocator )
+			{
+				if( fitsInline( amount, policy ) )
+				{
+					shared.reset();
+					inlineAllocator= &allocator;
+					inlined= true;
+					if( policy == AllocationPolicy::Zeroed ) std::memset( local.data(), 0, amount );
+					return local.data();
+				}
+
+				auto allocation= allocateStorage( amount, policy, allocator );
+				shared= std::move( allocation.storage );
+				inlineAllocator= nullptr;
+				inlined= false;
+				return allocation.data;
+			}
+
+			void
+			reset() noexcept
+			{
+				shared.reset();
+				inlineAllocator= nullptr;
+				inlined= false;
+			}
+
+			bool isInline() const noexcept { return inlined; }
+			std::byte *inlineData() noexcept { return local.data(); }
+
+			// The counted reference, which is empty for inline bytes.
+			const StorageReference &reference() const noexcept { return shared; }
+
+			// The allocator these bytes came from, or were allocated on behalf of, if any.
+			ByteAllocator *
+			allocator() const noexcept
+			{
+				if( inlined ) return inlineAllocator;
+				return shared ? shared->allocator() : nullptr;
+			}
+
+			explicit operator bool () const noexcept { return inlined or shared; }
+	};
+}
+
+namespace Alepha::Cavorite::inline exports::inline small_storage
+{
+	using namespace detail::small_storage::exports;
+}
@@ -0,0 +1,104 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../SmallStorage.h"
+#include "../Blob.h"
+
+#include <algorithm>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+#include <Alepha/Testing/CountingAllocator.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	using Alepha::AllocationPolicy;
+	using Alepha::CountingAllocator;
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"small_is_inline"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		Alepha::SmallStorage storage;
+
+		std::byte *const data= storage.allocate( 48, AllocationPolicy::Zeroed, allocator );
+		test.expect( storage.isInline() and data == storage.inlineData() );
+		test.expect( std::all_of( data, data + 48, []( auto b ) { return b == std::byte{}; } ) );
+		test.expect( not storage.reference() and storage );
+		test.expect( allocator.allocations == 0 );
+
+		test.expect( Alepha::SmallStorage::fitsInline( 8, AllocationPolicy::Uninitialized ) );
+		test.expect( not Alepha::SmallStorage::fitsInline( 49, AllocationPolicy::Zeroed ) );
+		test.expect( not Alepha::SmallStorage::fitsInline( 8, AllocationPolicy::DirectIO ) );
+	};
+
+	"large_is_shared"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		Alepha::SmallStorage storage;
+		storage.allocate( 49, AllocationPolicy::Uninitialized, allocator );
+		test.expect( not storage.isInline() and storage.reference() );
+		test.expect( storage.allocator() == &allocator and allocator.allocations == 1 );
+	};
+
+	"moves_carry_inline_bytes"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		Alepha::SmallStorage first;
+		std::fill_n( first.allocate( 16, AllocationPolicy::Uninitialized, allocator ), 16, std::byte{ 'a' } );
+
+		Alepha::SmallStorage second= std::move( first );
+		test.expect( second.isInline() and not first );
+		test.expect( second.inlineData()[ 15 ] == std::byte{ 'a' } );
+
+		Alepha::SmallStorage third;
+		third.allocate( 1000, AllocationPolicy::Uninitialized, allocator );
+		const auto *const reference= third.reference().get();
+		swap( second, third );
+		test.expect( third.isInline() and third.inlineData()[ 0 ] == std::byte{ 'a' } );
+		test.expect( not second.isInline() and second.reference().get() == reference );
+	};
+
+	"inline_remembers_allocator"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		Alepha::SmallStorage storage;
+		storage.allocate( 16, AllocationPolicy::Uninitialized, allocator );
+		test.expect( storage.isInline() and storage.allocator() == &allocator );
+
+		Alepha::SmallStorage moved= std::move( storage );
+		test.expect( moved.allocator() == &allocator and not storage.allocator() );
+
+		moved.reset();
+		test.expect( not moved.allocator() );
+	};
+
+	"carving_inline_blob_copies"_test <=[]( TestState test )
+	{
+		CountingAllocator allocator;
+		Alepha::Blob blob{ 10, AllocationPolicy::Uninitialized, allocator };
+		for( int i= 0; i < 10; ++i ) blob.byte_data()[ i ]= std::byte( i );
+
+		Alepha::Blob head= blob.carveHead( 3 );
+		Alepha::Blob tail= blob.carveTail( 2 );
+		test.expect( allocator.allocations == 0 );
+		test.expect( head.size() == 3 and blob.size() == 5 and tail.size() == 2 );
+		test.expect( head.byte_data()[ 2 ] == std::byte( 2 ) );
+		test.expect( blob.byte_data()[ 0 ] == std::byte( 3 ) and blob.byte_data()[ 4 ] == std::byte( 7 ) );
+		test.expect( tail.byte_data()[ 0 ] == std::byte( 8 ) and tail.byte_data()[ 1 ] == std::byte( 9 ) );
+
+		// Growing a carved piece still comes from the original allocator.
+		head.combine( Alepha::Buffer< Alepha::Const >{ blob }, 100 );
+		test.expect( allocator.allocations == 1 and head.size() == 8 );
+	};
+};
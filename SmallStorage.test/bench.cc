@@ -0,0 +1,76 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Blob.h"
+
+#include <chrono>
+#include <string>
+#include <iostream>
+
+/*
+ * The cost of creating, carving and destroying small `Blob` objects, held inline versus on the heap.
+ *
+ * "Heap" is what every `Blob` used to do: a counted storage block from the allocator, which carving shares.
+ * "Inline" is an ordinary `Blob` now, which allocates nothing at or below `C::inlineCapacity` bytes, and copies
+ * when carved.  At 64 bytes it is past that, so those rows show what larger payloads pay now.
+ */
+
+namespace
+{
+	template< typename Function >
+	double
+	nanoseconds( const std::size_t rounds, Function function )
+	{
+		const auto start= std::chrono::steady_clock::now();
+		for( std::size_t round= 0; round < rounds; ++round ) function();
+		const std::chrono::duration< double, std::nano > elapsed= std::chrono::steady_clock::now() - start;
+		return elapsed.count() / rounds;
+	}
+
+	volatile std::byte sink;
+
+	Alepha::Blob
+	heapBlob( const std::size_t size )
+	{
+		auto allocation= Alepha::allocateHeapStorage( size, Alepha::getDefaultAllocator() );
+		*allocation.data= std::byte{};
+		return Alepha::Blob::adopt( { std::move( allocation.storage ), allocation.data, size } );
+	}
+}
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	using Alepha::AllocationPolicy;
+	const std::size_t rounds= argcnt > 1 ? std::stoul( argvec[ 1 ] ) : 200'000;
+
+	for( const std::size_t size: { 8, 16, 32, 64 } )
+	{
+		std::cout << size << " bytes:" << std::endl;
+
+		std::cout << "  Create and destroy, inline: " << nanoseconds( rounds, [&]
+		{
+			Alepha::Blob blob{ size, AllocationPolicy::Zeroed };
+			sink= *blob.byte_data();
+		} ) << " ns" << std::endl;
+
+		std::cout << "  Create and destroy, heap: " << nanoseconds( rounds, [&]
+		{
+			Alepha::Blob blob= heapBlob( size );
+			sink= *blob.byte_data();
+		} ) << " ns" << std::endl;
+
+		std::cout << "  Create, carve and destroy, inline: " << nanoseconds( rounds, [&]
+		{
+			Alepha::Blob blob{ size, AllocationPolicy::Zeroed };
+			Alepha::Blob head= blob.carveHead( size / 2 );
+			sink= *head.byte_data();
+		} ) << " ns" << std::endl;
+
+		std::cout << "  Create, carve and destroy, heap: " << nanoseconds( rounds, [&]
+		{
+			Alepha::Blob blob= heapBlob( size );
+			Alepha::Blob head= blob.carveHead( size / 2 );
+			sink= *head.byte_data();
+		} ) << " ns" << std::endl;
+	}
+}
@@ -0,0 +1,52 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstddef>
+
+#include <atomic>
+
+#include <Alepha/ByteAllocator.h>
+
+namespace Alepha::inline Cavorite  ::detail::  counting_allocator
+{
+	inline namespace exports
+	{
+		class CountingAllocator;
+	}
+
+	/*!
+	 * A `new[]` allocator which counts what reaches it, for tests of code which takes a `ByteAllocator`.
+	 *
+	 * `allocations` counts every block ever handed out, and `live` those not yet returned.  Both may be read while
+	 * other threads allocate and deallocate.
+	 */
+	class exports::CountingAllocator
+		: public NewArrayAllocator
+	{
+		public:
+			std::atomic< std::size_t > allocations= 0;
+			std::atomic< std::size_t > live= 0;
+
+			[[nodiscard]] std::byte *
+			allocate( const std::size_t amount ) override
+			{
+				std::byte *const rv= NewArrayAllocator::allocate( amount );
+				++allocations;
+				++live;
+				return rv;
+			}
+
+			void
+			deallocate( std::byte *const block, const std::size_t amount ) noexcept override
+			{
+				--live;
+				NewArrayAllocator::deallocate( block, amount );
+			}
+	};
+}
+
+namespace Alepha::Cavorite::inline exports::inline counting_allocator
+{
+	using namespace detail::counting_allocator::exports;
+}
@@ -4,9 +4,24 @@ static_assert( __cplusplus > 2020'00 );
 
 #include <Alepha/Alepha.h>
 
-#include <Alepha/boost_path/thread.hpp>
-#include <Alepha/boost_path/thread/mutex.hpp>
-#include <Alepha/boost_path/thread/condition_variable.hpp>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include <ctime>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <concepts>
+#include <exception>
+#include <type_traits>
+
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include <Alepha/Exception.h>
 
@@ -20,86 +35,268 @@ namespace Alepha::Hydrogen
 			using CrossThreadNotificationRethrowError= synthetic_exception< struct cross_thread_notification_failure, Error >;
 		}
 
+		// Sleep while `word` holds `expected`, until woken or (when given) for at most `timeout`.
+		inline void
+		futexWait( std::atomic< std::uint32_t > &word, const std::uint32_t expected, const timespec *const timeout= nullptr ) noexcept
+		{
+			static_assert( sizeof( std::atomic< std::uint32_t > ) == sizeof( std::uint32_t ) );
+			::syscall( SYS_futex, reinterpret_cast< std::uint32_t * >( &word ), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0 );
+		}
+
+		inline void
+		futexWake( std::atomic< std::uint32_t > &word, const int count ) noexcept
+		{
+			::syscall( SYS_futex, reinterpret_cast< std::uint32_t * >( &word ), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0 );
+		}
+
+		/*!
+		 * The interruption state of one thread.
+		 *
+		 * Interrupting sets an atomic flag, so checking for an interruption is one atomic load, and no exception is
+		 * thrown until one is delivered.  A thread which blocks interruptibly registers the futex word it sleeps on,
+		 * so that the interrupting thread can wake it there.
+		 */
 		class NotificationInfo
 		{
 			private:
-				std::mutex access;
-				std::exception_ptr notification;
+				// The pending notification, published and consumed by exchange.  Whoever exchanges one out owns it.
+				std::atomic< std::exception_ptr * > notification= nullptr;
+
+				std::atomic< bool > interrupted= false;
+
+				// The address of the futex word this thread is blocked on, if any.  While an interrupting thread is
+				// waking it, this is `claimed` instead, and the blocked thread must not leave until it is released.
+				static constexpr std::uintptr_t claimed= 1;
+				std::atomic< std::uintptr_t > blockedOn= 0;
+
+				// What this thread sleeps on when it is only waiting for time to pass.
+				std::atomic< std::uint32_t > alarm= 0;
+
+				[[noreturn]] void
+				deliver()
+				{
+					const std::unique_ptr< std::exception_ptr > pending{ notification.exchange( nullptr, std::memory_order_acq_rel ) };
+					if( not pending ) throw boost::thread_interrupted{};
+					try
+					{
+						std::rethrow_exception( std::move( *pending ) );
+					}
+					catch( const std::bad_alloc & )
+					{
+						throw build_exception< CrossThreadNotificationRethrowError >( "`std::bad_alloc` encountered in trying to "
+								"raise a cross-thread notification" );
+					}
+				}
 
 			public:
+				~NotificationInfo() { delete notification.load( std::memory_order_acquire ); }
+
+				NotificationInfo()= default;
+				NotificationInfo( const NotificationInfo & )= delete;
+				NotificationInfo &operator= ( const NotificationInfo & )= delete;
+
 				//template( Concepts::DerivedFrom< Notification > Exc )
 				void
 				setNotification( std::exception_ptr &&exception )
 				{
-					std::lock_guard lock( access );
-					notification= std::move( exception );
+					delete notification.exchange( new std::exception_ptr( std::move( exception ) ), std::memory_order_acq_rel );
 				}
 
-				template< typename Callable >
+				/*!
+				 * Whether a `Notification` is waiting to be delivered to this thread.
+				 *
+				 * This is a single atomic load, which neither blocks nor raises anything.
+				 */
+				bool pendingNotification() const noexcept { return notification.load( std::memory_order_acquire ); }
+
+				/*!
+				 * Mark this thread interrupted, and wake it if it is blocked.
+				 *
+				 * The futex it is blocked on is bumped and woken, so other threads blocked on the same word see a
+				 * spurious wakeup.
+				 */
 				void
-				check_interrupt( Callable &&callable )
-				try
-				{
-					callable();
-				}
-				catch( const boost_ns::thread_interrupted & )
+				interrupt() noexcept
 				{
-					std::lock_guard lock( access );
-					if( not notification ) throw;
-					try
+					interrupted.store( true, std::memory_order_seq_cst );
+
+					std::uintptr_t word= blockedOn.load( std::memory_order_seq_cst );
+					while( word > claimed )
 					{
-						std::rethrow_exception( std::move( notification ) );
+						if( not blockedOn.compare_exchange_weak( word, claimed, std::memory_order_acq_rel ) ) continue;
+						auto &futex= *reinterpret_cast< std::atomic< std::uint32_t > * >( word );
+						futex.fetch_add( 1, std::memory_order_release );
+						futexWake( futex, INT_MAX );
+						blockedOn.store( 0, std::memory_order_release );
+						break;
 					}
-					catch( const std::bad_alloc & )
+				}
+
+				bool interruptionRequested() const noexcept { return interrupted.load( std::memory_order_acquire ); }
+
+				/*!
+				 * Raise the pending interruption, if there is one: its `Notification`, or `boost::thread_interrupted`
+				 * if it had none.  Each interruption is raised once.
+				 */
+				void
+				checkInterrupt()
+				{
+					if( not interrupted.load( std::memory_order_relaxed ) ) [[likely]] return;
+					if( interrupted.exchange( false, std::memory_order_acq_rel ) ) deliver();
+				}
+
+				/*!
+				 * Sleep while `word` holds `expected`, unless this thread is interrupted.
+				 *
+				 * This returns on any wakeup, including spurious ones, and raises nothing -- the caller checks for an
+				 * interruption when it is ready to.
+				 */
+				void
+				block( std::atomic< std::uint32_t > &word, const std::uint32_t expected, const timespec *const timeout= nullptr ) noexcept
+				{
+					const std::uintptr_t address= reinterpret_cast< std::uintptr_t >( &word );
+					blockedOn.store( address, std::memory_order_seq_cst );
+					if( not interrupted.load( std::memory_order_seq_cst ) ) futexWait( word, expected, timeout );
+
+					// An interrupting thread which has claimed our registration is still using `word`, which may not
+					// outlive our return.
+					std::uintptr_t registered= address;
+					if( not blockedOn.compare_exchange_strong( registered, 0, std::memory_order_acq_rel ) )
 					{
-						throw build_exception< CrossThreadNotificationRethrowError >( "`std::bad_alloc` encountered in trying to "
-								"raise a cross-thread notification" );
+						while( blockedOn.load( std::memory_order_acquire ) != 0 ) ::sched_yield();
 					}
 				}
+
+				// Sleep for at most `timeout`, unless this thread is interrupted.
+				void
+				sleep( const timespec &timeout ) noexcept
+				{
+					block( alarm, alarm.load( std::memory_order_acquire ), &timeout );
+				}
 		};
-			
-		inline thread_local NotificationInfo notification;
+
+		// An `Alepha::Thread` owns its `NotificationInfo`, so that it can be interrupted before this thread has started
+		// and after it has finished.  The thread installs it here as it starts.  Other threads use their own.
+		inline thread_local std::shared_ptr< NotificationInfo > installedNotification;
+		inline thread_local NotificationInfo localNotification;
+
+		// The interruption state of the calling thread.
+		inline NotificationInfo &
+		notification() noexcept
+		{
+			if( NotificationInfo *const installed= installedNotification.get() ) return *installed;
+			return localNotification;
+		}
 
 		namespace exports
 		{
+			/*!
+			 * A condition variable, whose waits an `Alepha::Thread` can be interrupted out of.
+			 *
+			 * It is built directly on a Linux futex.  A notification bumps a sequence word and, only if anyone is
+			 * waiting, wakes them with a single `FUTEX_WAKE`.  An interruption is seen as one atomic load before and
+			 * after each wait; it is delivered by throwing the thread's `Notification`, exactly once.
+			 */
 			class ConditionVariable
-				: private boost_ns::condition_variable
 			{
+				private:
+					std::atomic< std::uint32_t > sequence= 0;
+					std::atomic< std::uint32_t > waiters= 0;
+
+					void
+					signal( const int count ) noexcept
+					{
+						sequence.fetch_add( 1, std::memory_order_seq_cst );
+						if( waiters.load( std::memory_order_seq_cst ) ) futexWake( sequence, count );
+					}
+
 				public:
-					using condition_variable::notify_all;
-					using condition_variable::notify_one;
+					ConditionVariable()= default;
+					ConditionVariable( const ConditionVariable & )= delete;
+					ConditionVariable &operator= ( const ConditionVariable & )= delete;
+
+					void notify_one() noexcept { signal( 1 ); }
+					void notify_all() noexcept { signal( INT_MAX ); }
 
 					template< typename Lock >
 					void
 					wait( Lock &&lock )
 					{
-						notification.check_interrupt( [&]{ condition_variable::wait( std::forward< Lock >( lock ) ); } );
+						notification().checkInterrupt();
+
+						waiters.fetch_add( 1, std::memory_order_seq_cst );
+						const std::uint32_t expected= sequence.load( std::memory_order_seq_cst );
+						lock.unlock();
+						notification().block( sequence, expected );
+						waiters.fetch_sub( 1, std::memory_order_relaxed );
+						lock.lock();
+
+						notification().checkInterrupt();
 					}
 
 					template< typename Lock, typename Predicate >
 					void
 					wait( Lock &&lock, Predicate &&predicate )
 					{
-						notification.check_interrupt( [&]{ condition_variable::wait( std::forward< Lock >( lock ),
-								std::forward< Predicate >( predicate ) ); } );
+						while( not predicate() ) wait( lock );
 					}
 			};
 
 			namespace this_thread
 			{
+				/*!
+				 * Raise any interruption of this thread which is pending, as its `Notification` when it was
+				 * interrupted with one.
+				 *
+				 * For long computations, which never wait, to check whether they have been cancelled.
+				 */
+				inline void
+				interruption_point()
+				{
+					notification().checkInterrupt();
+				}
+
+				// Whether this thread has an interruption pending.  This never raises it.
+				inline bool
+				interruption_requested() noexcept
+				{
+					return notification().interruptionRequested();
+				}
+
+				/*!
+				 * Whether this thread has been interrupted with a `Notification` which it has not yet raised.
+				 *
+				 * For loops which poll for cancellation often, and would rather stop in their own way than have the
+				 * notification thrown at them.  A later interruption point still raises it.
+				 */
+				inline bool
+				pending_notification() noexcept
+				{
+					return notification().pendingNotification();
+				}
+
 				template< typename Clock, typename Duration >
 				void
-				sleep_until( const boost_ns::chrono::time_point< Clock, Duration > &abs_time )
+				sleep_until( const boost::chrono::time_point< Clock, Duration > &abs_time )
 				{
-					notification.check_interrupt( [&]{ boost_ns::this_thread::sleep_until( abs_time ); } );
+					while( true )
+					{
+						notification().checkInterrupt();
+
+						const auto now= Clock::now();
+						if( now >= abs_time ) return;
+						const auto remaining= boost::chrono::duration_cast< boost::chrono::nanoseconds >( abs_time - now ).count();
+						const timespec timeout{ time_t( remaining / 1'000'000'000 ), long( remaining % 1'000'000'000 ) };
+						notification().sleep( timeout );
+					}
 				}
-					
+
 #if 0
 				template< typename Rep, typename Period >
 				void
-				sleep_for( const boost_ns::chrono::duration< Rep, Period > &rel_time )
+				sleep_for( const boost::chrono::duration< Rep, Period > &rel_time )
 				{
-					notification.check_interrupt( [&]( boost_ns::this_thread::sleep_until( rel_time ); } );
+					notification.check_interrupt( [&]( boost::this_thread::sleep_until( rel_time ); } );
 				}
 #endif
 			}
@@ -107,13 +304,13 @@ namespace Alepha::Hydrogen
 
 		struct ThreadNotification
 		{
-			NotificationInfo *myNotification= nullptr;
+			std::shared_ptr< NotificationInfo > myNotification= std::make_shared< NotificationInfo >();
 		};
-	
+
 		namespace exports
 		{
 			class Thread
-				: ThreadNotification, boost_ns::thread
+				: ThreadNotification, boost::thread
 			{
 				public:
 					template< typename Callable >
@@ -121,9 +318,10 @@ namespace Alepha::Hydrogen
 					Thread( Callable &&callable )
 						: thread
 						(
-							[this, callable= std::forward< Callable >( callable )]
+							// The thread keeps its own reference, as it may outlive this object once detached.
+							[info= myNotification, callable= std::forward< Callable >( callable )]
 							{
-								myNotification= &notification;
+								installedNotification= info;
 								try { callable(); }
 								catch( const Notification & )
 								{
@@ -135,28 +333,31 @@ namespace Alepha::Hydrogen
 
 					using thread::join;
 					using thread::detach;
-					
-					using thread::interrupt;
 
-					//template( Concepts::DerivedFrom< Notification > Exc )
+					/*!
+					 * Interrupt the thread, which raises `boost::thread_interrupted` at its next interruptible wait or
+					 * `this_thread::interruption_point`.
+					 */
+					void interrupt() noexcept { myNotification->interrupt(); }
+
+					/*!
+					 * Interrupt the thread with a `Notification`, which it raises at its next interruptible wait or
+					 * `this_thread::interruption_point`.
+					 */
 					template< typename Exc >
+					requires std::derived_from< std::decay_t< Exc >, Notification >
 					void
 					interrupt( Exc &&exception )
-					try
-					{
-						throw std::forward< Exc >( exception );
-					}
-					catch( const Notification & )
 					{
-						myNotification->setNotification( std::current_exception() );
+						myNotification->setNotification( std::make_exception_ptr( std::forward< Exc >( exception ) ) );
 						interrupt();
 					}
 			};
 
-			using Mutex= boost_ns::mutex;
-			using boost_ns::mutex;
-			using boost_ns::unique_lock;
-			using boost_ns::lock_guard;
+			using Mutex= boost::mutex;
+			using boost::mutex;
+			using boost::unique_lock;
+			using boost::lock_guard;
 		}
 	}
 
@@ -0,0 +1,238 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Thread.h"
+
+#include <atomic>
+#include <string>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	using StopNotification= Alepha::create_exception< struct stop_notification, Alepha::Notification >;
+
+	void
+	awaitFlag( const std::atomic< bool > &flag )
+	{
+		while( not flag ) boost::this_thread::yield();
+	}
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"notify_wakes"_test <=[]( TestState test )
+	{
+		Alepha::Mutex access;
+		Alepha::ConditionVariable ready;
+		int stage= 0;
+
+		Alepha::Thread child{ [&]
+		{
+			Alepha::unique_lock lock( access );
+			stage= 1;
+			ready.notify_all();
+			ready.wait( lock, [&]{ return stage == 2; } );
+			stage= 3;
+			ready.notify_all();
+		} };
+
+		Alepha::unique_lock lock( access );
+		ready.wait( lock, [&]{ return stage == 1; } );
+		stage= 2;
+		ready.notify_one();
+		ready.wait( lock, [&]{ return stage == 3; } );
+		lock.unlock();
+		child.join();
+		test.expect( stage == 3 );
+	};
+
+	"interrupted_wait_delivers_once"_test <=[]( TestState test )
+	{
+		Alepha::Mutex access;
+		Alepha::ConditionVariable never;
+		std::atomic< bool > waiting= false;
+		int caught= 0;
+		bool quiet= false;
+
+		Alepha::Thread child{ [&]
+		{
+			try
+			{
+				Alepha::unique_lock lock( access );
+				waiting= true;
+				never.wait( lock );
+			}
+			catch( const StopNotification & ) { ++caught; }
+
+			try
+			{
+				Alepha::this_thread::interruption_point();
+				quiet= not Alepha::this_thread::interruption_requested();
+			}
+			catch( ... ) { ++caught; }
+		} };
+
+		awaitFlag( waiting );
+		child.interrupt( Alepha::build_exception< StopNotification >( "stop" ) );
+		child.join();
+		test.expect( caught == 1 and quiet );
+	};
+
+	"interrupted_before_waiting"_test <=[]( TestState test )
+	{
+		Alepha::Mutex access;
+		Alepha::ConditionVariable never;
+		std::atomic< bool > started= false, interrupted= false;
+		bool caught= false;
+
+		Alepha::Thread child{ [&]
+		{
+			started= true;
+			awaitFlag( interrupted );
+			try
+			{
+				Alepha::unique_lock lock( access );
+				never.wait( lock );
+			}
+			catch( const StopNotification & ) { caught= true; }
+		} };
+
+		awaitFlag( started );
+		child.interrupt( Alepha::build_exception< StopNotification >( "stop" ) );
+		interrupted= true;
+		child.join();
+		test.expect( caught );
+	};
+
+	"interrupted_at_construction"_test <=[]( TestState test )
+	{
+		Alepha::Mutex access;
+		Alepha::ConditionVariable never;
+		bool caught= false;
+
+		Alepha::Thread child{ [&]
+		{
+			try
+			{
+				Alepha::unique_lock lock( access );
+				never.wait( lock );
+			}
+			catch( const StopNotification & ) { caught= true; }
+		} };
+
+		// The thread may not have started yet.
+		child.interrupt( Alepha::build_exception< StopNotification >( "stop" ) );
+		child.join();
+		test.expect( caught );
+	};
+
+	"interrupted_after_join"_test <=[]( TestState test )
+	{
+		bool ran= false;
+		Alepha::Thread child{ [&]{ ran= true; } };
+		child.join();
+
+		// Nothing is left to interrupt, but the interruption state is still there to take it.
+		child.interrupt();
+		child.interrupt( Alepha::build_exception< StopNotification >( "late" ) );
+		test.expect( ran and not Alepha::this_thread::interruption_requested() );
+	};
+
+	"plain_interrupt"_test <=[]( TestState test )
+	{
+		std::atomic< bool > started= false;
+		bool caught= false;
+
+		Alepha::Thread child{ [&]
+		{
+			started= true;
+			try { while( true ) Alepha::this_thread::interruption_point(); }
+			catch( const boost::thread_interrupted & ) { caught= true; }
+		} };
+
+		awaitFlag( started );
+		child.interrupt();
+		child.join();
+		test.expect( caught );
+	};
+
+	"polling_for_notifications"_test <=[]( TestState test )
+	{
+		std::atomic< bool > started= false;
+		std::size_t polls= 0;
+		bool caught= false;
+
+		Alepha::Thread child{ [&]
+		{
+			started= true;
+			while( not Alepha::this_thread::pending_notification() ) ++polls;
+
+			// Seeing it pending does not consume it.
+			try { Alepha::this_thread::interruption_point(); }
+			catch( const StopNotification & ) { caught= not Alepha::this_thread::pending_notification(); }
+		} };
+
+		awaitFlag( started );
+		child.interrupt( Alepha::build_exception< StopNotification >( "stop" ) );
+		child.join();
+		test.expect( caught and polls > 0 );
+	};
+
+	"replaced_notification"_test <=[]( TestState test )
+	{
+		std::atomic< bool > started= false, interrupted= false;
+		std::string caught;
+
+		Alepha::Thread child{ [&]
+		{
+			started= true;
+			awaitFlag( interrupted );
+			try { Alepha::this_thread::interruption_point(); }
+			catch( const StopNotification &n ) { caught= n.message(); }
+		} };
+
+		// Only the latest notification is delivered, and the one it replaces is released.
+		awaitFlag( started );
+		child.interrupt( Alepha::build_exception< StopNotification >( "first" ) );
+		child.interrupt( Alepha::build_exception< StopNotification >( "second" ) );
+		interrupted= true;
+		child.join();
+		test.expect( caught == "second" );
+	};
+
+	"interrupted_sleep"_test <=[]( TestState test )
+	{
+		std::atomic< bool > started= false;
+		bool caught= false;
+		const auto start= boost::chrono::steady_clock::now();
+
+		Alepha::Thread child{ [&]
+		{
+			started= true;
+			try { Alepha::this_thread::sleep_until( boost::chrono::steady_clock::now() + boost::chrono::seconds( 30 ) ); }
+			catch( const StopNotification & ) { caught= true; }
+		} };
+
+		awaitFlag( started );
+		child.interrupt( Alepha::build_exception< StopNotification >( "stop" ) );
+		child.join();
+		test.expect( caught and boost::chrono::steady_clock::now() - start < boost::chrono::seconds( 10 ) );
+	};
+
+	"sleep_until_elapses"_test <=[]( TestState test )
+	{
+		const auto deadline= boost::chrono::steady_clock::now() + boost::chrono::milliseconds( 20 );
+		Alepha::this_thread::sleep_until( deadline );
+		test.expect( boost::chrono::steady_clock::now() >= deadline );
+	};
+};
@@ -0,0 +1,107 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Thread.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <iostream>
+
+#include <boost/thread/condition_variable.hpp>
+
+/*
+ * Wake and interrupt latency of `Alepha::ConditionVariable`.
+ *
+ * Wake latency is half a round trip of two threads handing a turn back and forth, on `Alepha::ConditionVariable`
+ * and, for comparison, on `boost::condition_variable`.  Interrupt latency is from `Thread::interrupt` to the
+ * waiting thread catching the `Notification`.
+ */
+
+namespace
+{
+	using StopNotification= Alepha::create_exception< struct stop_notification, Alepha::Notification >;
+
+	double
+	nanosecondsSince( const std::chrono::steady_clock::time_point start )
+	{
+		return std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count();
+	}
+
+	template< typename Condition >
+	double
+	pingPong( const std::size_t rounds )
+	{
+		Alepha::Mutex access;
+		Condition turnTaken;
+		std::size_t turn= 0;
+
+		Alepha::Thread partner{ [&]
+		{
+			Alepha::unique_lock lock( access );
+			for( std::size_t round= 0; round < rounds; ++round )
+			{
+				turnTaken.wait( lock, [&]{ return turn % 2 == 1; } );
+				++turn;
+				turnTaken.notify_one();
+			}
+		} };
+
+		const auto start= std::chrono::steady_clock::now();
+		{
+			Alepha::unique_lock lock( access );
+			for( std::size_t round= 0; round < rounds; ++round )
+			{
+				++turn;
+				turnTaken.notify_one();
+				turnTaken.wait( lock, [&]{ return turn % 2 == 0; } );
+			}
+		}
+		const double elapsed= nanosecondsSince( start );
+		partner.join();
+		return elapsed / rounds / 2;
+	}
+
+	double
+	interruptLatency( const std::size_t rounds )
+	{
+		double total= 0;
+		for( std::size_t round= 0; round < rounds; ++round )
+		{
+			Alepha::Mutex access;
+			Alepha::ConditionVariable never;
+			std::atomic< bool > waiting= false;
+			std::chrono::steady_clock::time_point caught;
+
+			Alepha::Thread waiter{ [&]
+			{
+				try
+				{
+					Alepha::unique_lock lock( access );
+					waiting= true;
+					never.wait( lock );
+				}
+				catch( const StopNotification & ) { caught= std::chrono::steady_clock::now(); }
+			} };
+
+			while( not waiting ) boost::this_thread::yield();
+			// Let it get to sleep.
+			boost::this_thread::sleep_for( boost::chrono::microseconds( 200 ) );
+
+			const auto start= std::chrono::steady_clock::now();
+			waiter.interrupt( Alepha::build_exception< StopNotification >( "stop" ) );
+			waiter.join();
+			total+= std::chrono::duration< double, std::nano >( caught - start ).count();
+		}
+		return total / rounds;
+	}
+}
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	const std::size_t rounds= argcnt > 1 ? std::stoul( argvec[ 1 ] ) : 20'000;
+
+	std::cout << "Wake, Alepha::ConditionVariable: " << pingPong< Alepha::ConditionVariable >( rounds ) << " ns" << std::endl;
+	std::cout << "Wake, boost::condition_variable: " << pingPong< boost::condition_variable >( rounds ) << " ns" << std::endl;
+	std::cout << "Interrupt a waiting thread: " << interruptLatency( std::max< std::size_t >( rounds / 100, 10 ) ) << " ns" << std::endl;
+}
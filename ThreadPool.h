@@ -0,0 +1,715 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Thread.h"
+
+namespace Alepha::inline Cavorite  ::detail::  thread_pool
+{
+	inline namespace exports
+	{
+		class ThreadPool;
+		class TaskHandle;
+		class TaskGroup;
+
+		enum class ShutdownMode;
+
+		// What a cancelled task is interrupted with, unless it is cancelled with some other `Notification`.
+		using TaskCancellation= create_exception< struct task_cancellation, Notification >;
+
+		// Thrown on submitting work to a pool which is shutting down.
+		using PoolShutdownError= synthetic_exception< struct pool_shutdown_error, Error >;
+	}
+
+	namespace C
+	{
+		const std::size_t cacheLineSize= 64;
+
+		// The initial capacity of each worker's deque.  It grows as needed.
+		const std::size_t initialDequeCapacity= 256;
+
+		// A worker takes up to this many tasks from the injection queue at once, and shares all but the first
+		// through its own deque.
+		const std::size_t injectionBatch= 32;
+
+		// How many times an idle worker looks for work before it sleeps.
+		const int searchesBeforeSleep= 64;
+	}
+
+	/*!
+	 * What a `ThreadPool` does with the work it has when it is shut down.
+	 *
+	 *  * `Drain`: Every task already submitted runs, as does anything they submit in turn.
+	 *
+	 *  * `Cancel`: Tasks which have not started are dropped, and running tasks are interrupted with a
+	 *    `TaskCancellation`.
+	 */
+	enum class exports::ShutdownMode { Drain, Cancel };
+
+	struct Worker;
+
+	enum class State { Queued, Running, Cancelling, Finished, Cancelled };
+
+	struct Task
+	{
+		std::atomic< State > state= State::Queued;
+		std::atomic< unsigned > references= 1;
+		std::atomic< Worker * > runner= nullptr;
+		TaskGroup *group= nullptr;
+		bool handled= false;
+		std::exception_ptr failure;
+
+		virtual ~Task()= default;
+		virtual void run()= 0;
+
+		void
+		release() noexcept
+		{
+			if( references.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) delete this;
+		}
+	};
+
+	template< typename Callable >
+	struct TaskOf final
+		: Task
+	{
+		Callable callable;
+
+		explicit TaskOf( Callable &&callable ) : callable( std::move( callable ) ) {}
+
+		void run() override { callable(); }
+	};
+
+	/*!
+	 * A Chase-Lev work-stealing deque of tasks.
+	 *
+	 * The owning worker pushes and pops at the bottom; any other thread may steal from the top.  This follows
+	 * Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models" (2013).
+	 * Arrays outgrown by the owner are kept until the deque is destroyed, since a thief may still be reading one.
+	 */
+	class WorkDeque
+	{
+		private:
+			struct Array
+			{
+				const std::size_t capacity;
+				const std::unique_ptr< std::atomic< Task * >[] > slots;
+
+				explicit Array( const std::size_t capacity ) : capacity( capacity ), slots( new std::atomic< Task * >[ capacity ] ) {}
+
+				Task *get( const std::int64_t index ) const noexcept { return slots[ index & ( capacity - 1 ) ].load( std::memory_order_relaxed ); }
+				void put( const std::int64_t index, Task *const task ) noexcept { slots[ index & ( capacity - 1 ) ].store( task, std::memory_order_relaxed ); }
+			};
+
+			alignas( C::cacheLineSize ) std::atomic< std::int64_t > top= 0;
+			alignas( C::cacheLineSize ) std::atomic< std::int64_t > bottom= 0;
+			std::atomic< Array * > array;
+			std::vector< std::unique_ptr< Array > > arrays;
+
+			Array *
+			grow( Array *const old, const std::int64_t top, const std::int64_t bottom )
+			{
+				auto &bigger= arrays.emplace_back( std::make_unique< Array >( old->capacity * 2 ) );
+				for( std::int64_t index= top; index < bottom; ++index ) bigger->put( index, old->get( index ) );
+				array.store( bigger.get(), std::memory_order_release );
+				return bigger.get();
+			}
+
+		public:
+			WorkDeque()
+			{
+				arrays.push_back( std::make_unique< Array >( C::initialDequeCapacity ) );
+				array.store( arrays.back().get(), std::memory_order_relaxed );
+			}
+
+			// Only the owner may push or pop.
+			void
+			push( Task *const task )
+			{
+				const std::int64_t b= bottom.load( std::memory_order_relaxed );
+				const std::int64_t t= top.load( std::memory_order_acquire );
+				Array *a= array.load( std::memory_order_relaxed );
+				if( b - t > std::int64_t( a->capacity ) - 1 ) a= grow( a, t, b );
+				a->put( b, task );
+				bottom.store( b + 1, std::memory_order_release );
+			}
+
+			Task *
+			pop() noexcept
+			{
+				const std::int64_t b= bottom.load( std::memory_order_relaxed ) - 1;
+				Array *const a= array.load( std::memory_order_relaxed );
+				bottom.store( b, std::memory_order_relaxed );
+				std::atomic_thread_fence( std::memory_order_seq_cst );
+				std::int64_t t= top.load( std::memory_order_relaxed );
+
+				if( t > b )
+				{
+					bottom.store( b + 1, std::memory_order_relaxed );
+					return nullptr;
+				}
+
+				Task *rv= a->get( b );
+				if( t == b )
+				{
+					// The last task: race any thief for it.
+					if( not top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) rv= nullptr;
+					bottom.store( b + 1, std::memory_order_relaxed );
+				}
+				return rv;
+			}
+
+			Task *
+			steal() noexcept
+			{
+				std::int64_t t= top.load( std::memory_order_acquire );
+				std::atomic_thread_fence( std::memory_order_seq_cst );
+				const std::int64_t b= bottom.load( std::memory_order_acquire );
+				if( t >= b ) return nullptr;
+
+				Task *const rv= array.load( std::memory_order_acquire )->get( t );
+				if( not top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) return nullptr;
+				return rv;
+			}
+
+			bool
+			empty() const noexcept
+			{
+				return bottom.load( std::memory_order_seq_cst ) <= top.load( std::memory_order_seq_cst );
+			}
+	};
+
+	struct Worker
+	{
+		ThreadPool *pool;
+		std::size_t index;
+		WorkDeque deque;
+
+		// The task this worker is running, guarded so that a cancellation interrupts only the task it was meant for.
+		Mutex access;
+		Task *current= nullptr;
+
+		// For choosing whom to steal from.
+		std::uint64_t random;
+
+		std::optional< Thread > thread;
+
+		explicit Worker( ThreadPool *const pool, const std::size_t index ) : pool( pool ), index( index ), random( index * 0x9E37'79B9'7F4A'7C15 + 1 ) {}
+	};
+
+	inline thread_local Worker *currentWorker= nullptr;
+
+	/*!
+	 * A set of tasks which can be waited for together -- the "join" of fork/join.
+	 */
+	class exports::TaskGroup
+	{
+		private:
+			std::atomic< std::size_t > outstanding= 0;
+
+			friend ThreadPool;
+
+			void
+			finish() noexcept
+			{
+				if( outstanding.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) outstanding.notify_all();
+			}
+
+		public:
+			TaskGroup()= default;
+			TaskGroup( const TaskGroup & )= delete;
+			TaskGroup &operator= ( const TaskGroup & )= delete;
+
+			// The number of tasks in the group which have not yet finished or been cancelled.
+			std::size_t pending() const noexcept { return outstanding.load( std::memory_order_acquire ); }
+	};
+
+	/*!
+	 * The caller's hold on a submitted task, through which it can be waited for or cancelled.
+	 */
+	class exports::TaskHandle
+	{
+		private:
+			Task *task= nullptr;
+
+			friend ThreadPool;
+
+			explicit TaskHandle( Task *const task ) noexcept : task( task ) {}
+
+			template< typename Exc >
+			bool deliver( Exc &&exception );
+
+		public:
+			~TaskHandle() { if( task ) task->release(); }
+
+			TaskHandle() noexcept= default;
+			TaskHandle( TaskHandle &&orig ) noexcept : task( std::exchange( orig.task, nullptr ) ) {}
+
+			TaskHandle &
+			operator= ( TaskHandle orig ) noexcept
+			{
+				std::swap( task, orig.task );
+				return *this;
+			}
+
+			/*!
+			 * Cancel the task.
+			 *
+			 * A task which has not started never will.  A running task's worker thread is interrupted, through
+			 * `Thread::interrupt`, with the given `Notification` (or a `TaskCancellation`), which the task sees at
+			 * its next interruptible wait or `this_thread::interruption_point`.
+			 *
+			 * @return Whether the cancellation reached the task before it finished.
+			 */
+			bool cancel() { return cancel( build_exception< TaskCancellation >( "Task cancelled." ) ); }
+
+			template< typename Exc >
+			bool cancel( Exc &&exception ) { return deliver( std::forward< Exc >( exception ) ); }
+
+			/*!
+			 * Wait until the task has finished or been cancelled.
+			 *
+			 * @return Whether the task ran to completion.
+			 * @throw Whatever the task threw, other than a `Notification`.
+			 */
+			bool
+			wait() const
+			{
+				for( State state= task->state.load( std::memory_order_acquire ); ; state= task->state.load( std::memory_order_acquire ) )
+				{
+					if( state == State::Finished or state == State::Cancelled )
+					{
+						if( task->failure ) std::rethrow_exception( task->failure );
+						return state == State::Finished;
+					}
+					task->state.wait( state, std::memory_order_acquire );
+				}
+			}
+
+			bool
+			done() const noexcept
+			{
+				const State state= task->state.load( std::memory_order_acquire );
+				return state == State::Finished or state == State::Cancelled;
+			}
+
+			explicit operator bool () const noexcept { return task; }
+	};
+
+	/*!
+	 * A pool of `Alepha::Thread` workers, which share out tasks by work stealing.
+	 *
+	 * Each worker has its own Chase-Lev deque.  Tasks submitted from a worker go onto the bottom of its deque and
+	 * are taken from there, most recent first, which keeps fork/join work hot in cache.  Tasks submitted from
+	 * outside go onto a global injection queue, from which workers take them in batches.  A worker with nothing
+	 * to do steals from the top of the others' deques, and sleeps only when there is nothing anywhere.
+	 *
+	 * Tasks are cancelled through the same path as any other `Alepha::Thread`: by interrupting the worker with a
+	 * `Notification`.  A task which is cancelled, or which is interrupted at shutdown, sees the notification at
+	 * its next interruptible wait or `this_thread::interruption_point`.  A notification which escapes a task ends
+	 * just that task.  Any other exception escaping a task is handed to whoever waits on its `TaskHandle`, or, for
+	 * a task with no handle, terminates the program as it would in a thread of its own.
+	 *
+	 * @note A worker waiting in `join` runs other tasks meanwhile.  While it does, cancelling the task which is
+	 * waiting interrupts nothing; the cancellation takes effect if it waits or checks for interruption afterwards.
+	 */
+	class exports::ThreadPool
+	{
+		private:
+			std::vector< std::unique_ptr< Worker > > workers;
+
+			Mutex injectionAccess;
+			std::deque< Task * > injection;
+			std::atomic< std::size_t > injected= 0;
+
+			Mutex idleAccess;
+			ConditionVariable idle;
+			std::atomic< std::size_t > sleepers= 0;
+
+			std::atomic< bool > stopping= false;
+			std::atomic< bool > cancelling= false;
+			bool joined= false;
+
+			Worker *
+			localWorker() const noexcept
+			{
+				return currentWorker and currentWorker->pool == this ? currentWorker : nullptr;
+			}
+
+			void
+			wake()
+			{
+				std::atomic_thread_fence( std::memory_order_seq_cst );
+				if( sleepers.load( std::memory_order_relaxed ) == 0 ) return;
+				lock_guard lock( idleAccess );
+				idle.notify_one();
+			}
+
+			void
+			enqueue( Task *const task )
+			{
+				if( Worker *const self= localWorker() ) self->deque.push( task );
+				else
+				{
+					lock_guard lock( injectionAccess );
+					if( stopping.load( std::memory_order_relaxed ) )
+					{
+						// The task was counted in its group when it was prepared, and now it never will run.
+						if( task->group ) task->group->finish();
+						task->release();
+						throw build_exception< PoolShutdownError >( "Tried to submit work to a `ThreadPool` which is shutting down." );
+					}
+					injection.push_back( task );
+					injected.fetch_add( 1, std::memory_order_relaxed );
+				}
+				wake();
+			}
+
+			template< typename Callable >
+			Task *
+			prepare( Callable &&callable, TaskGroup *const group )
+			{
+				Task *const rv= new TaskOf< std::decay_t< Callable > >( std::forward< Callable >( callable ) );
+				if( group )
+				{
+					rv->group= group;
+					group->outstanding.fetch_add( 1, std::memory_order_relaxed );
+				}
+				return rv;
+			}
+
+			Task *
+			takeInjected( Worker *const self )
+			{
+				if( injected.load( std::memory_order_relaxed ) == 0 ) return nullptr;
+
+				lock_guard lock( injectionAccess );
+				if( injection.empty() ) return nullptr;
+
+				Task *const rv= injection.front();
+				injection.pop_front();
+				std::size_t taken= 1;
+				if( self )
+				{
+					for( ; taken < C::injectionBatch and not injection.empty(); ++taken )
+					{
+						self->deque.push( injection.front() );
+						injection.pop_front();
+					}
+				}
+				injected.fetch_sub( taken, std::memory_order_relaxed );
+				return rv;
+			}
+
+			Task *
+			find( Worker *const self )
+			{
+				if( self )
+				{
+					if( Task *const task= self->deque.pop() ) return task;
+				}
+				if( Task *const task= takeInjected( self ) )
+				{
+					// Some of a batch may have gone onto our deque, where others can steal them.
+					if( self and not self->deque.empty() ) wake();
+					return task;
+				}
+
+				const std::size_t count= workers.size();
+				std::size_t start= 0;
+				if( self )
+				{
+					self->random^= self->random << 13;
+					self->random^= self->random >> 7;
+					self->random^= self->random << 17;
+					start= self->random % count;
+				}
+				for( std::size_t offset= 0; offset < count; ++offset )
+				{
+					Worker &victim= *workers[ ( start + offset ) % count ];
+					if( &victim == self ) continue;
+					if( Task *const task= victim.deque.steal() ) return task;
+				}
+				return nullptr;
+			}
+
+			bool
+			anyWork() const noexcept
+			{
+				if( injected.load( std::memory_order_seq_cst ) ) return true;
+				for( const auto &worker: workers ) if( not worker->deque.empty() ) return true;
+				return false;
+			}
+
+			static void
+			complete( Task *const task, const State state ) noexcept
+			{
+				task->state.store( state, std::memory_order_release );
+				task->state.notify_all();
+				if( task->group ) task->group->finish();
+				task->release();
+			}
+
+			void
+			execute( Worker *const self, Task *const task )
+			{
+				// Tasks run by a thread outside the pool, while it helps in `join`, cannot be interrupted.
+				if( not self )
+				{
+					State expected= State::Queued;
+					if( cancelling.load( std::memory_order_acquire ) or not task->state.compare_exchange_strong( expected, State::Running ) )
+					{
+						return complete( task, State::Cancelled );
+					}
+					return run( task );
+				}
+
+				// Starting happens under the worker's lock, so that a shutdown which cancels either sees this task
+				// running or stops it starting.
+				Task *outer;
+				{
+					lock_guard lock( self->access );
+					State expected= State::Queued;
+					if( cancelling.load( std::memory_order_acquire ) or not task->state.compare_exchange_strong( expected, State::Running ) )
+					{
+						return complete( task, State::Cancelled );
+					}
+					outer= std::exchange( self->current, task );
+					task->runner.store( self, std::memory_order_release );
+				}
+				run( task );
+				{
+					lock_guard lock( self->access );
+					self->current= outer;
+
+					// Once the task is no longer current, nothing can interrupt this thread on its behalf.  So any
+					// interruption still pending was meant for it, and came too late to be noticed.  It must not fall
+					// on the next task, nor on the idle wait.  (Unless we ran nested inside an outer task, which
+					// is being cancelled itself -- then it is still that task's to raise.)
+					if( not outer or outer->state.load( std::memory_order_acquire ) != State::Cancelling )
+					{
+						try { this_thread::interruption_point(); }
+						catch( const Notification & ) {}
+						catch( const boost::thread_interrupted & ) {}
+					}
+				}
+			}
+
+			void
+			run( Task *const task )
+			{
+				bool interrupted= false;
+				try
+				{
+					task->run();
+				}
+				catch( const Notification & )
+				{
+					interrupted= true;
+				}
+				catch( ... )
+				{
+					if( not task->handled ) std::terminate();
+					task->failure= std::current_exception();
+				}
+
+				complete( task, interrupted ? State::Cancelled : State::Finished );
+			}
+
+			void
+			work( Worker &self )
+			{
+				currentWorker= &self;
+				int searches= 0;
+				while( true )
+				{
+					if( Task *const task= find( &self ) )
+					{
+						execute( &self, task );
+						searches= 0;
+						continue;
+					}
+
+					if( stopping.load( std::memory_order_acquire ) and not anyWork() ) break;
+					if( ++searches < C::searchesBeforeSleep )
+					{
+						boost::this_thread::yield();
+						continue;
+					}
+
+					unique_lock lock( idleAccess );
+					sleepers.fetch_add( 1, std::memory_order_seq_cst );
+					if( not anyWork() and not stopping.load( std::memory_order_seq_cst ) ) idle.wait( lock );
+					sleepers.fetch_sub( 1, std::memory_order_relaxed );
+					searches= 0;
+				}
+				currentWorker= nullptr;
+			}
+
+			template< typename Exc >
+			bool
+			interrupt( Task *const task, Exc &&exception )
+			{
+				Worker *const runner= task->runner.load( std::memory_order_acquire );
+				if( not runner ) return false;
+
+				lock_guard lock( runner->access );
+				if( runner->current != task ) return false;
+				State expected= State::Running;
+				if( not task->state.compare_exchange_strong( expected, State::Cancelling ) ) return false;
+				runner->thread->interrupt( std::forward< Exc >( exception ) );
+				return true;
+			}
+
+			friend TaskHandle;
+
+		public:
+			~ThreadPool() { shutdown(); }
+
+			/*!
+			 * Start the workers.
+			 *
+			 * @param threads How many workers to run.  By default, one per CPU.
+			 */
+			explicit
+			ThreadPool( const std::size_t threads= std::max( boost::thread::hardware_concurrency(), 1u ) )
+			{
+				const std::size_t count= std::max< std::size_t >( threads, 1 );
+				for( std::size_t index= 0; index < count; ++index ) workers.push_back( std::make_unique< Worker >( this, index ) );
+				for( auto &worker: workers ) worker->thread.emplace( [this, &self= *worker]{ work( self ); } );
+			}
+
+			ThreadPool( const ThreadPool & )= delete;
+			ThreadPool &operator= ( const ThreadPool & )= delete;
+
+			std::size_t size() const noexcept { return workers.size(); }
+
+			/*!
+			 * Run `callable` on the pool, with no way to wait for it or cancel it on its own.
+			 *
+			 * @param group When given, the group the task is counted in until it is done.
+			 *
+			 * @throw PoolShutdownError if the pool is shutting down.
+			 */
+			template< typename Callable >
+			void
+			post( Callable &&callable, TaskGroup *const group= nullptr )
+			{
+				enqueue( prepare( std::forward< Callable >( callable ), group ) );
+			}
+
+			template< typename Callable >
+			void
+			post( TaskGroup &group, Callable &&callable )
+			{
+				post( std::forward< Callable >( callable ), &group );
+			}
+
+			/*!
+			 * Run `callable` on the pool.
+			 *
+			 * @return A handle through which the task can be waited for or cancelled.
+			 *
+			 * @throw PoolShutdownError if the pool is shutting down.
+			 */
+			template< typename Callable >
+			[[nodiscard]] TaskHandle
+			submit( Callable &&callable, TaskGroup *const group= nullptr )
+			{
+				Task *const task= prepare( std::forward< Callable >( callable ), group );
+				task->handled= true;
+				task->references.fetch_add( 1, std::memory_order_relaxed );
+				TaskHandle rv{ task };
+				enqueue( task );
+				return rv;
+			}
+
+			/*!
+			 * Wait for every task in `group` to be done, running pool tasks meanwhile.
+			 *
+			 * This may be called from within a task, to wait for the subtasks it has forked.
+			 */
+			void
+			join( TaskGroup &group )
+			{
+				Worker *const self= localWorker();
+				while( const std::size_t pending= group.pending() )
+				{
+					if( Task *const task= find( self ) ) execute( self, task );
+					else group.outstanding.wait( pending, std::memory_order_acquire );
+				}
+			}
+
+			/*!
+			 * Stop the pool, and wait for its workers to exit.
+			 *
+			 * Nothing more may be submitted from outside the pool once this has been called.  This must not be called
+			 * from one of the pool's own tasks.
+			 */
+			void
+			shutdown( const ShutdownMode mode= ShutdownMode::Drain )
+			{
+				{
+					lock_guard lock( injectionAccess );
+					stopping.store( true, std::memory_order_seq_cst );
+				}
+
+				if( mode == ShutdownMode::Cancel )
+				{
+					cancelling.store( true, std::memory_order_seq_cst );
+					for( auto &worker: workers )
+					{
+						Task *running;
+						{
+							lock_guard lock( worker->access );
+							running= worker->current;
+						}
+						if( running ) interrupt( running, build_exception< TaskCancellation >( "`ThreadPool` shut down." ) );
+					}
+				}
+
+				{
+					lock_guard lock( idleAccess );
+					idle.notify_all();
+				}
+
+				if( std::exchange( joined, true ) ) return;
+				for( auto &worker: workers ) worker->thread->join();
+			}
+	};
+
+	template< typename Exc >
+	bool
+	exports::TaskHandle::deliver( Exc &&exception )
+	{
+		State expected= State::Queued;
+		if( task->state.compare_exchange_strong( expected, State::Cancelled ) )
+		{
+			// It stays queued, to be discarded by whichever worker takes it.
+			task->state.notify_all();
+			return true;
+		}
+		if( expected != State::Running ) return false;
+
+		Worker *const runner= task->runner.load( std::memory_order_acquire );
+		return runner and runner->pool->interrupt( task, std::forward< Exc >( exception ) );
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline thread_pool
+{
+	using namespace detail::thread_pool::exports;
+}
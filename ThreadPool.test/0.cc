@@ -0,0 +1,223 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	using StopNotification= Alepha::create_exception< struct stop_notification, Alepha::Notification >;
+
+	std::size_t
+	fibonacci( Alepha::ThreadPool &pool, const std::size_t n )
+	{
+		if( n < 12 ) return n < 2 ? n : fibonacci( pool, n - 1 ) + fibonacci( pool, n - 2 );
+
+		std::size_t left, right;
+		Alepha::TaskGroup group;
+		pool.post( group, [&]{ left= fibonacci( pool, n - 1 ); } );
+		right= fibonacci( pool, n - 2 );
+		pool.join( group );
+		return left + right;
+	}
+
+	// Holds a pool's only worker until released.
+	struct Gate
+	{
+		Alepha::Mutex access;
+		Alepha::ConditionVariable opened;
+		bool open= false;
+		std::atomic< bool > entered= false;
+
+		void
+		pass()
+		{
+			entered= true;
+			Alepha::unique_lock lock( access );
+			opened.wait( lock, [&]{ return open; } );
+		}
+
+		void
+		release()
+		{
+			Alepha::lock_guard lock( access );
+			open= true;
+			opened.notify_all();
+		}
+
+		void awaitEntry() const { while( not entered ) boost::this_thread::yield(); }
+	};
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"million_tiny_tasks"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 4 };
+		std::atomic< std::size_t > count= 0;
+
+		Alepha::TaskGroup group;
+		for( std::size_t i= 0; i < 500'000; ++i ) pool.post( group, [&]{ count.fetch_add( 1, std::memory_order_relaxed ); } );
+
+		// And as many again, forked from inside the pool.
+		pool.post( group, [&]
+		{
+			for( std::size_t i= 0; i < 500'000; ++i ) pool.post( group, [&]{ count.fetch_add( 1, std::memory_order_relaxed ); } );
+		} );
+
+		pool.join( group );
+		test.expect( count == 1'000'000 );
+	};
+
+	"fork_join"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 4 };
+		std::size_t result= 0;
+		auto task= pool.submit( [&]{ result= fibonacci( pool, 25 ); } );
+		test.expect( task.wait() and result == 75'025 );
+	};
+
+	"cancel_before_start"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 1 };
+		Gate gate;
+		auto blocker= pool.submit( [&]{ gate.pass(); } );
+		gate.awaitEntry();
+
+		bool ran= false;
+		auto task= pool.submit( [&]{ ran= true; } );
+		test.expect( task.cancel() );
+		test.expect( task.done() and not task.wait() );
+
+		gate.release();
+		test.expect( blocker.wait() );
+		pool.shutdown();
+		test.expect( not ran );
+	};
+
+	"cancel_while_running"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 1 };
+		Gate gate;
+		bool stopped= false;
+		auto task= pool.submit( [&]
+		{
+			try { gate.pass(); }
+			catch( const StopNotification & )
+			{
+				stopped= true;
+				throw;
+			}
+		} );
+		gate.awaitEntry();
+
+		test.expect( task.cancel( Alepha::build_exception< StopNotification >( "stop" ) ) );
+		test.expect( not task.wait() and stopped );
+		test.expect( not task.cancel() );
+
+		// The worker goes on to other work, unaffected.
+		auto after= pool.submit( []{ Alepha::this_thread::interruption_point(); } );
+		test.expect( after.wait() );
+	};
+
+	"late_cancellation_is_dropped"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 1 };
+		std::atomic< bool > started= false, cancelled= false;
+
+		// This task never reaches an interruption point, so its cancellation comes too late.
+		auto task= pool.submit( [&]
+		{
+			started= true;
+			while( not cancelled ) boost::this_thread::yield();
+		} );
+		while( not started ) boost::this_thread::yield();
+		test.expect( task.cancel() );
+		cancelled= true;
+		task.wait();
+
+		// Neither the next task nor the worker's idle wait sees it.
+		auto after= pool.submit( []{ Alepha::this_thread::interruption_point(); } );
+		test.expect( after.wait() );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+		auto idled= pool.submit( []{ Alepha::this_thread::interruption_point(); } );
+		test.expect( idled.wait() );
+	};
+
+	"polling_for_cancellation"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		std::atomic< bool > started= false;
+		auto task= pool.submit( [&]
+		{
+			started= true;
+			while( true ) Alepha::this_thread::interruption_point();
+		} );
+		while( not started ) boost::this_thread::yield();
+
+		test.expect( task.cancel() );
+		test.expect( not task.wait() );
+	};
+
+	"failures_reach_the_handle"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 2 };
+		auto task= pool.submit( []{ throw std::runtime_error{ "failed" }; } );
+
+		bool rethrown= false;
+		try { task.wait(); }
+		catch( const std::runtime_error & ) { rethrown= true; }
+		test.expect( rethrown );
+	};
+
+	"shutdown_drains"_test <=[]( TestState test )
+	{
+		std::atomic< std::size_t > count= 0;
+		Alepha::ThreadPool pool{ 2 };
+		for( int i= 0; i < 1000; ++i ) pool.post( [&]{ count.fetch_add( 1 ); } );
+		pool.shutdown();
+		test.expect( count == 1000 );
+
+		bool refused= false;
+		try { pool.post( []{} ); }
+		catch( const Alepha::PoolShutdownError & ) { refused= true; }
+		test.expect( refused );
+
+		// A refused task is not left counted in its group, so joining it does not hang.
+		Alepha::TaskGroup group;
+		refused= false;
+		try { pool.post( group, []{} ); }
+		catch( const Alepha::PoolShutdownError & ) { refused= true; }
+		test.expect( refused and group.pending() == 0 );
+		pool.join( group );
+	};
+
+	"shutdown_cancels"_test <=[]( TestState test )
+	{
+		Alepha::ThreadPool pool{ 1 };
+		Gate gate;
+		auto running= pool.submit( [&]{ gate.pass(); } );
+		gate.awaitEntry();
+
+		bool ran= false;
+		auto queued= pool.submit( [&]{ ran= true; } );
+		pool.shutdown( Alepha::ShutdownMode::Cancel );
+
+		test.expect( not running.wait() and not queued.wait() and not ran );
+	};
+};
@@ -0,0 +1,92 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <iostream>
+
+/*
+ * Fork/join and throughput on a `ThreadPool`, against a thread per task where that is feasible.
+ *
+ * The fork/join case is a naive Fibonacci, forking down to a small cutoff, which is almost all scheduling.
+ * The throughput case submits a million empty tasks from outside the pool.
+ */
+
+namespace
+{
+	template< typename Function >
+	double
+	milliseconds( Function function )
+	{
+		const auto start= std::chrono::steady_clock::now();
+		function();
+		const std::chrono::duration< double, std::milli > elapsed= std::chrono::steady_clock::now() - start;
+		return elapsed.count();
+	}
+
+	std::size_t
+	fibonacci( Alepha::ThreadPool &pool, const std::size_t n )
+	{
+		if( n < 16 ) return n < 2 ? n : fibonacci( pool, n - 1 ) + fibonacci( pool, n - 2 );
+
+		std::size_t left, right;
+		Alepha::TaskGroup group;
+		pool.post( group, [&]{ left= fibonacci( pool, n - 1 ); } );
+		right= fibonacci( pool, n - 2 );
+		pool.join( group );
+		return left + right;
+	}
+
+	std::size_t
+	serialFibonacci( const std::size_t n )
+	{
+		return n < 2 ? n : serialFibonacci( n - 1 ) + serialFibonacci( n - 2 );
+	}
+
+	volatile std::size_t sink;
+}
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	const std::size_t tasks= argcnt > 1 ? std::stoul( argvec[ 1 ] ) : 1'000'000;
+	const std::size_t n= 30;
+
+	Alepha::ThreadPool pool;
+	std::cout << "Workers: " << pool.size() << std::endl;
+
+	std::cout << "Fibonacci " << n << ", serial: " << milliseconds( [&]{ sink= serialFibonacci( n ); } ) << " ms" << std::endl;
+
+	std::cout << "Fibonacci " << n << ", fork/join: " << milliseconds( [&]
+	{
+		std::size_t result;
+		Alepha::TaskGroup group;
+		pool.post( group, [&]{ result= fibonacci( pool, n ); } );
+		pool.join( group );
+		sink= result;
+	} ) << " ms" << std::endl;
+
+	std::atomic< std::size_t > count= 0;
+	const double injected= milliseconds( [&]
+	{
+		Alepha::TaskGroup group;
+		for( std::size_t i= 0; i < tasks; ++i ) pool.post( group, [&]{ count.fetch_add( 1, std::memory_order_relaxed ); } );
+		pool.join( group );
+	} );
+	std::cout << tasks << " tasks from outside: " << injected << " ms (" << tasks / injected / 1000 << " M tasks/s)" << std::endl;
+
+	const double forked= milliseconds( [&]
+	{
+		Alepha::TaskGroup group;
+		pool.post( group, [&]
+		{
+			for( std::size_t i= 0; i < tasks; ++i ) pool.post( group, [&]{ count.fetch_add( 1, std::memory_order_relaxed ); } );
+		} );
+		pool.join( group );
+	} );
+	std::cout << tasks << " tasks from a worker: " << forked << " ms (" << tasks / forked / 1000 << " M tasks/s)" << std::endl;
+
+	return count == 2 * tasks ? 0 : 1;
+}
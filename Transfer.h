@@ -0,0 +1,300 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+
+#include <vector>
+#include <algorithm>
+#include <concepts>
+#include <system_error>
+
+#include "BlobStorage.h"
+
+namespace Alepha::inline Cavorite  ::detail::  transfer
+{
+	inline namespace exports
+	{
+		struct TransferOptions;
+		struct TransferResult;
+	}
+
+	namespace C
+	{
+		// A single `writev` or `vmsplice` call takes at most this many segments.
+		const std::size_t maximumIOSegments= IOV_MAX;
+
+		// Linux moves at most this much in one `sendfile` or `splice` call.
+		const std::size_t maximumKernelTransfer= 0x7fff'f000;
+	}
+
+	template< typename T >
+	concept ReadableBytes= requires( const T &t )
+	{
+		{ t.byte_data() } -> std::convertible_to< const std::byte * >;
+		{ t.size() } -> std::convertible_to< std::size_t >;
+	};
+
+	template< typename T >
+	concept SegmentedBytes= requires( const T &t )
+	{
+		{ t.chain_view()[ 0 ] } -> ReadableBytes;
+		{ t.chain_view().size() } -> std::convertible_to< std::size_t >;
+	};
+
+	// Byte ranges which can say what storage they are in, as `Blob` can.
+	template< typename T >
+	concept StoredBytes= ReadableBytes< T > and requires( const T &t )
+	{
+		{ t.storageReference() } -> std::convertible_to< const StorageReference & >;
+	};
+
+	/*!
+	 * Which kernel paths `transferTo` may take.
+	 */
+	struct exports::TransferOptions
+	{
+		/*!
+		 * Let memory be given to a pipe by `vmsplice`, rather than copied into it.
+		 *
+		 * The pipe then refers to the very pages of the source, so they must not be written to until the reader
+		 * has drained the pipe.  That is the caller's promise to make, so this is off by default.
+		 */
+		bool allowVmsplice= false;
+	};
+
+	/*!
+	 * What `transferTo` moved, and how.
+	 */
+	struct exports::TransferResult
+	{
+		// All the bytes moved, which are the first `bytes` of the source.
+		std::size_t bytes= 0;
+
+		// How many of them went by each path.  Only `written` were copied through user space.
+		std::size_t sent= 0;
+		std::size_t spliced= 0;
+		std::size_t vmspliced= 0;
+		std::size_t written= 0;
+
+		// Whether the transfer stopped early because the descriptor would block.
+		bool blocked= false;
+	};
+
+	struct Piece
+	{
+		const std::byte *data;
+		std::size_t length;
+		const FileSource *file;
+	};
+
+	template< ReadableBytes Bytes >
+	Piece
+	pieceOf( const Bytes &bytes ) noexcept
+	{
+		const FileSource *file= nullptr;
+		if constexpr( StoredBytes< Bytes > )
+		{
+			if( const StorageReference &storage= bytes.storageReference() ) file= storage->fileSource();
+		}
+		return { bytes.byte_data(), bytes.size(), file };
+	}
+
+	// The outcome of one system call: how much it moved, or that it would block, or that it cannot be used here.
+	enum class Outcome { Moved, Blocked, Unsupported };
+
+	struct Step
+	{
+		Outcome outcome;
+		std::size_t amount= 0;
+	};
+
+	template< typename Call >
+	Step
+	attempt( Call call, const char *const what )
+	{
+		ssize_t moved;
+		do moved= call();
+		while( moved == -1 and errno == EINTR );
+
+		if( moved != -1 ) return { Outcome::Moved, std::size_t( moved ) };
+		if( errno == EAGAIN or errno == EWOULDBLOCK ) return { Outcome::Blocked };
+		if( errno == EINVAL or errno == ENOSYS or errno == EOPNOTSUPP ) return { Outcome::Unsupported };
+		throw std::system_error{ errno, std::generic_category(), what };
+	}
+
+	class Transfer
+	{
+		private:
+			const int fd;
+			const TransferOptions options;
+			const bool toPipe;
+
+			std::vector< Piece > pieces;
+			std::size_t current= 0;
+			std::size_t offset= 0;
+
+			TransferResult result;
+
+			void
+			advance( std::size_t amount, std::size_t TransferResult::*path ) noexcept
+			{
+				result.bytes+= amount;
+				result.*path+= amount;
+				while( amount )
+				{
+					const std::size_t piece= std::min( amount, pieces[ current ].length - offset );
+					offset+= piece;
+					amount-= piece;
+					if( offset == pieces[ current ].length )
+					{
+						++current;
+						offset= 0;
+					}
+				}
+			}
+
+			// Send the rest of the current piece straight from its file.
+			Step
+			fromFile()
+			{
+				const Piece &piece= pieces[ current ];
+				const std::size_t amount= std::min( piece.length - offset, C::maximumKernelTransfer );
+				off_t position= piece.file->offset + ( piece.data - piece.file->base ) + offset;
+
+				Step rv= attempt( [&]{ return ::sendfile( fd, piece.file->fd, &position, amount ); },
+						"Unable to send file data to descriptor" );
+				if( rv.outcome == Outcome::Moved ) advance( rv.amount, &TransferResult::sent );
+				if( rv.outcome != Outcome::Unsupported or not toPipe ) return rv;
+
+				rv= attempt( [&]{ return ::splice( piece.file->fd, &position, fd, nullptr, amount, SPLICE_F_MOVE ); },
+						"Unable to splice file data to descriptor" );
+				if( rv.outcome == Outcome::Moved ) advance( rv.amount, &TransferResult::spliced );
+				return rv;
+			}
+
+			// Hand the run of memory pieces which starts at the current one to the kernel.
+			Step
+			fromMemory( const bool splicing )
+			{
+				std::vector< iovec > segments;
+				for( std::size_t index= current; index < pieces.size() and segments.size() < C::maximumIOSegments; ++index )
+				{
+					if( pieces[ index ].file and index != current ) break;
+					const std::size_t skip= index == current ? offset : 0;
+					segments.push_back( { const_cast< std::byte * >( pieces[ index ].data + skip ), pieces[ index ].length - skip } );
+				}
+
+				if( splicing )
+				{
+					const Step rv= attempt( [&]{ return ::vmsplice( fd, segments.data(), segments.size(), 0 ); },
+							"Unable to splice memory to descriptor" );
+					if( rv.outcome == Outcome::Moved ) advance( rv.amount, &TransferResult::vmspliced );
+					if( rv.outcome != Outcome::Unsupported ) return rv;
+				}
+
+				const Step rv= attempt( [&]{ return ::writev( fd, segments.data(), segments.size() ); },
+						"Unable to write to descriptor" );
+				if( rv.outcome == Outcome::Unsupported ) throw std::system_error{ EINVAL, std::generic_category(), "Unable to write to descriptor" };
+				if( rv.outcome == Outcome::Moved ) advance( rv.amount, &TransferResult::written );
+				return rv;
+			}
+
+			static bool
+			isPipe( const int fd ) noexcept
+			{
+				struct stat status;
+				return ::fstat( fd, &status ) == 0 and S_ISFIFO( status.st_mode );
+			}
+
+		public:
+			explicit
+			Transfer( const int fd, const TransferOptions &options )
+				: fd( fd ), options( options ), toPipe( isPipe( fd ) )
+			{}
+
+			void add( const Piece &piece ) { if( piece.length ) pieces.push_back( piece ); }
+
+			TransferResult
+			run()
+			{
+				while( current < pieces.size() )
+				{
+					Step step{ Outcome::Unsupported };
+					if( pieces[ current ].file ) step= fromFile();
+					if( step.outcome == Outcome::Unsupported )
+					{
+						// This file cannot be sent from by descriptor, so it goes by its mapped bytes instead.
+						pieces[ current ].file= nullptr;
+						step= fromMemory( toPipe and options.allowVmsplice );
+					}
+
+					if( step.outcome == Outcome::Blocked )
+					{
+						result.blocked= true;
+						break;
+					}
+					// A descriptor which takes nothing, such as a full disk, will take nothing more.
+					if( step.amount == 0 ) throw std::system_error{ ENOSPC, std::generic_category(), "Unable to transfer to descriptor" };
+				}
+				return result;
+			}
+	};
+
+	namespace exports
+	{
+		/*!
+		 * Move bytes to a file descriptor, without copying them through user space where the kernel allows.
+		 *
+		 * Each segment takes the best path open to it:
+		 *
+		 *  * Segments whose storage has a `fileSource` -- read only or shared mapped files, mapped with
+		 *    `keepFileSource` -- are sent from the file by `sendfile`.  If the kernel will not do that to this
+		 *    descriptor, they are spliced from the file when it is a pipe.
+		 *
+		 *  * Other segments are handed to a pipe by `vmsplice`, when `TransferOptions::allowVmsplice` is set.
+		 *
+		 *  * Everything else is gathered, as many segments at a time as possible, into `writev` calls.
+		 *
+		 * A blocking descriptor takes everything.  A nonblocking one takes what it can, and the result says how
+		 * much that was, so that the rest can be sent when it is writable again.
+		 *
+		 * @param fd The descriptor to move the bytes to.
+		 * @param source A `DataChain`, or a single `Blob` or `Buffer`.
+		 * @param options Which kernel paths may be used.
+		 * @return How many bytes were moved, from the start of `source`, and by which paths.
+		 *
+		 * @throw std::system_error if the descriptor cannot be written to.
+		 */
+		template< SegmentedBytes Chain >
+		TransferResult
+		transferTo( const int fd, const Chain &source, const TransferOptions &options= {} )
+		{
+			Transfer transfer{ fd, options };
+			for( const auto &segment: source.chain_view() ) transfer.add( pieceOf( segment ) );
+			return transfer.run();
+		}
+
+		template< ReadableBytes Bytes >
+		TransferResult
+		transferTo( const int fd, const Bytes &source, const TransferOptions &options= {} )
+		{
+			Transfer transfer{ fd, options };
+			transfer.add( pieceOf( source ) );
+			return transfer.run();
+		}
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline transfer
+{
+	using namespace detail::transfer::exports;
+}
@@ -0,0 +1,158 @@
+static_assert( __cplusplus > 2020'00 );
+
+#include "../Transfer.h"
+#include "../Blob.h"
+#include "../DataChain.h"
+#include "../MappedStorage.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include <cstdlib>
+
+#include <string>
+#include <fstream>
+#include <filesystem>
+
+#include <Alepha/Testing/test.h>
+#include <Alepha/Utility/evaluation.h>
+
+int
+main( const int argcnt, const char *const argvec[] )
+{
+	return Alepha::Testing::runAllTests( argcnt, argvec );
+}
+
+namespace
+{
+	Alepha::Buffer< Alepha::Const >
+	view( const std::string &text )
+	{
+		return { text.data(), text.size() };
+	}
+
+	struct TempFile
+	{
+		std::filesystem::path path;
+
+		explicit
+		TempFile( const std::string &contents )
+		{
+			std::string name= ( std::filesystem::temp_directory_path() / "Alepha.Transfer.XXXXXX" ).string();
+			::close( ::mkstemp( name.data() ) );
+			path= name;
+			std::ofstream{ path } << contents;
+		}
+
+		~TempFile() { std::filesystem::remove( path ); }
+	};
+
+	std::string
+	drain( const int fd, const std::size_t amount )
+	{
+		std::string rv( amount, '\0' );
+		std::size_t got= 0;
+		while( got < amount )
+		{
+			const ssize_t n= ::read( fd, rv.data() + got, amount - got );
+			if( n <= 0 ) break;
+			got+= n;
+		}
+		rv.resize( got );
+		return rv;
+	}
+
+	struct Pipe
+	{
+		int fds[ 2 ];
+
+		Pipe() { if( ::pipe2( fds, O_CLOEXEC ) ) std::abort(); }
+		~Pipe() { ::close( fds[ 0 ] ); ::close( fds[ 1 ] ); }
+	};
+}
+
+static auto tests= Alepha::Utility::enroll <=[]
+{
+	using namespace Alepha::Testing::exports::literals;
+	using Alepha::Testing::exports::TestState;
+
+	"file_source_of_mappings"_test <=[]( TestState test )
+	{
+		const TempFile file{ std::string( 5000, 'f' ) };
+
+		const auto readOnly= Alepha::mapFileRegion( file.path, 4100, 200, Alepha::MapMode::ReadOnly, Alepha::AccessAdvice::Normal, true );
+		const auto *const source= readOnly.storage->fileSource();
+		test.expect( source and source->offset + ( readOnly.data - source->base ) == 4100 );
+
+		// Unless asked for, no descriptor is kept.
+		test.expect( not Alepha::mapFileRegion( file.path, 4100, 200, Alepha::MapMode::ReadOnly ).storage->fileSource() );
+
+		const auto privately= Alepha::mapFileRegion( file.path, 0, 200, Alepha::MapMode::Private, Alepha::AccessAdvice::Normal, true );
+		test.expect( not privately.storage->fileSource() );
+		test.expect( not Alepha::mapAnonymousRegion( 100 ).storage->fileSource() );
+	};
+
+	"mixed_chain_to_pipe"_test <=[]( TestState test )
+	{
+		std::string contents;
+		for( int i= 0; i < 500; ++i ) contents+= std::to_string( i ) + ",";
+		const TempFile file{ contents };
+		auto mapped= Alepha::Blob::mapFile( file.path, 10, 1000, Alepha::MapMode::Shared, Alepha::AccessAdvice::Normal, true );
+
+		const std::string head= "head:", tail= ":tail";
+		Alepha::DataChain chain;
+		chain.append( view( head ) );
+		chain.append( mapped );
+		chain.append( view( tail ) );
+		test.expect( chain.chain_view().size() == 3 );
+
+		Pipe pipe;
+		const auto result= Alepha::transferTo( pipe.fds[ 1 ], chain );
+		test.expect( result.bytes == 1010 and not result.blocked );
+		test.expect( result.sent + result.spliced == 1000 and result.written == 10 );
+		test.expect( drain( pipe.fds[ 0 ], 1010 ) == head + contents.substr( 10, 1000 ) + tail );
+	};
+
+	"file_to_socket"_test <=[]( TestState test )
+	{
+		const TempFile file{ std::string( 3000, 's' ) };
+		const auto blob= Alepha::Blob::mapFileReadOnly( file.path, 0, Alepha::wholeFile, Alepha::AccessAdvice::Normal, true );
+
+		int sockets[ 2 ];
+		test.expect( ::socketpair( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets ) == 0 );
+		const auto result= Alepha::transferTo( sockets[ 0 ], blob );
+		test.expect( result.bytes == 3000 and result.sent == 3000 );
+		test.expect( drain( sockets[ 1 ], 3000 ) == std::string( 3000, 's' ) );
+		::close( sockets[ 0 ] );
+		::close( sockets[ 1 ] );
+	};
+
+	"vmsplice_when_allowed"_test <=[]( TestState test )
+	{
+		const std::string first= "first ", second= "second";
+		Alepha::DataChain chain;
+		chain.append( view( first ) );
+		chain.append( view( second ) );
+
+		Pipe pipe;
+		const auto result= Alepha::transferTo( pipe.fds[ 1 ], chain, { .allowVmsplice= true } );
+		test.expect( result.bytes == 12 and result.vmspliced == 12 and result.written == 0 );
+		test.expect( drain( pipe.fds[ 0 ], 12 ) == "first second" );
+	};
+
+	"nonblocking_stops_when_full"_test <=[]( TestState test )
+	{
+		Pipe pipe;
+		::fcntl( pipe.fds[ 1 ], F_SETFL, O_NONBLOCK );
+		const std::size_t capacity= ::fcntl( pipe.fds[ 1 ], F_GETPIPE_SZ );
+
+		const std::string big( capacity + 1000, 'b' );
+		auto result= Alepha::transferTo( pipe.fds[ 1 ], view( big ) );
+		test.expect( result.blocked and result.bytes == capacity );
+
+		test.expect( drain( pipe.fds[ 0 ], capacity ) == big.substr( 0, capacity ) );
+		result= Alepha::transferTo( pipe.fds[ 1 ], Alepha::Buffer< Alepha::Const >{ big.data() + capacity, 1000 } );
+		test.expect( result.bytes == 1000 and not result.blocked );
+	};
+};
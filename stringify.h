@@ -0,0 +1,33 @@
+static_assert( __cplusplus > 2020'00 );
+
+#pragma once
+
+#include <string>
+#include <sstream>
+
+#include "Concepts.h"
+
+namespace Alepha::inline Cavorite  ::detail::  stringification
+{
+	inline namespace exports
+	{
+		/*!
+		 * The text which streaming `value` would produce.
+		 *
+		 * This is for building messages, such as those in exceptions, out of values of any streamable type.
+		 */
+		template< OStreamable T >
+		std::string
+		stringify( const T &value )
+		{
+			std::ostringstream oss;
+			oss << value;
+			return std::move( oss ).str();
+		}
+	}
+}
+
+namespace Alepha::Cavorite::inline exports::inline stringification
+{
+	using namespace detail::stringification::exports;
+}